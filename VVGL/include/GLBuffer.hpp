@@ -61,7 +61,7 @@ class VVGL_EXPORT GLBuffer	{
 		#include "GLBuffer_Enums_RPI.h"
 #elif defined(VVGL_SDK_IOS)
 		#include "GLBuffer_Enums_IOS.h"
-#elif defined(VVGL_SDK_GLFW)
+#elif defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_EGL)
 		#include "GLBuffer_Enums_GLFW.h"
 #elif defined(VVGL_SDK_QT)
 		#include "GLBuffer_Enums_Qt.h"
@@ -105,6 +105,8 @@ class VVGL_EXPORT GLBuffer	{
 			BackingID_QImage,
 			//!	The CPU backing was a QVideoFrame, which will be deleted when the buffer's resources are no longer needed
 			BackingID_QVideoFrame,
+			//!	The CPU backing is a slot in a GLCPUToTexCopier's persistently mapped PBO (see GLCPUToTexCopier::createRingCPUBuffer())
+			BackingID_PersistentPBO,
 		};
 		
 		
@@ -138,11 +140,17 @@ class VVGL_EXPORT GLBuffer	{
 			uint32_t				msAmount = 0;
 			//!	Only used by Mac SDK, indicates platform-specific optimization.
 			uint32_t				localSurfaceID = 0;
+			//!	Only used if this buffer is Type_Tex.  If true, the texture is created with immutable storage (glTexStorage2D), which lets the driver skip validation/reallocation checks when the texture is updated or attached to an FBO.  Ignored if the GL context doesn't support immutable storage.
+			bool					immutableStorageFlag = false;
 			
 			//!	Returns the amount of memory in bytes that a single row of the provided width requires with the receiver's properties.
 			uint32_t bytesPerRowForWidth(const uint32_t & w) const;
 			//!	Returns the amount of memory in bytes required to accommodate a buffer of the passed size with the receiver's properties.
 			uint32_t backingLengthForSize(const Size & s) const;
+			//!	Returns true if a buffer with the receiver's properties can be recycled to satisfy a request for a buffer with the passed properties.
+			bool isComparableForRecycling(const Descriptor & n) const;
+			//!	Returns a hash of the properties compared by isComparableForRecycling()- descriptors that are comparable for recycling always have the same hash.
+			size_t recyclingHash() const;
 		};
 	
 	
@@ -0,0 +1,189 @@
+#ifndef VVGL_GLBufferAllocator_hpp
+#define VVGL_GLBufferAllocator_hpp
+
+#include "VVGL_Defines.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+#include "VVGL_Base.hpp"
+
+
+
+
+namespace VVGL
+{
+
+
+
+
+//! Fixed-size block allocator used to allocate GLBuffer instances (and their shared_ptr control blocks).
+/*!
+\ingroup VVGL_MISC
+Every buffer vended by a GLBufferPool- and every buffer returned to a pool, which is copied to a new instance- is a heap allocation.  GLSlab carves fixed-size blocks out of large chunks of memory and recycles them through a free list, so steady-state buffer churn doesn't hit the system allocator.
+
+Notes on use:
+- You shouldn't need to work with GLSlab directly- GLSlabAllocator is a std-compatible allocator that uses it, and MakeGLBufferRef() uses GLSlabAllocator to make a GLBufferRef.
+- Slabs are never deallocated (they're shared by every thread for the lifetime of the process), so memory in a slab is only ever recycled, never returned to the system.
+*/
+class VVGL_EXPORT GLSlab	{
+	public:
+		//!	The number of blocks allocated at a time whenever the slab's free list is empty.
+		static const size_t		kBlocksPerChunk = 64;
+
+	private:
+		//	free blocks are a singly-linked list stored in the blocks themselves
+		struct FreeBlock	{
+			FreeBlock		*next = nullptr;
+		};
+
+		std::mutex				_lock;
+		size_t					_blockSize = 0;
+		FreeBlock				*_freeList = nullptr;
+		std::vector<void*>		_chunks;	//	every chunk of memory allocated by this slab
+		size_t					_blocksInUse = 0;
+
+	public:
+		GLSlab(const size_t & inBlockSize);
+		GLSlab(const GLSlab &) = delete;
+		GLSlab & operator=(const GLSlab &) = delete;
+
+		//!	Returns a pointer to a block of memory at least 'blockSize()' bytes long, aligned to alignof(std::max_align_t).
+		void * allocate();
+		//!	Returns a block allocated by this slab to its free list.
+		void release(void * inBlock);
+
+		inline size_t blockSize() const { return _blockSize; }
+		//!	The number of blocks currently allocated from this slab.
+		size_t blocksInUse();
+		//!	The total number of blocks (free and in use) this slab has allocated.
+		size_t blocksAllocated();
+};
+
+
+//!	Returns the slab used to allocate blocks of the passed size (the size is rounded up, so slabs are shared by similarly-sized types).  Thread-safe.
+/*!
+\ingroup VVGL_MISC
+*/
+VVGL_EXPORT GLSlab & GetGLSlab(const size_t & inBlockSize);
+
+
+
+
+//! A std-compatible allocator that allocates single objects from a GLSlab.
+/*!
+\ingroup VVGL_MISC
+Meant to be used with std::allocate_shared- the shared_ptr's control block and object are allocated as a single block from the slab.  Allocations of more than one object (or of over-aligned types) fall through to the global operator new.
+*/
+template <typename T>
+class GLSlabAllocator	{
+	public:
+		using value_type = T;
+
+		GLSlabAllocator() noexcept {}
+		template <typename U> GLSlabAllocator(const GLSlabAllocator<U> &) noexcept {}
+
+		T * allocate(const size_t inCount)	{
+			if (inCount!=1 || alignof(T)>alignof(std::max_align_t))
+				return static_cast<T*>(::operator new(inCount * sizeof(T)));
+			static GLSlab		&slab = GetGLSlab(sizeof(T));
+			return static_cast<T*>(slab.allocate());
+		}
+		void deallocate(T * inPtr, const size_t inCount) noexcept	{
+			if (inCount!=1 || alignof(T)>alignof(std::max_align_t))	{
+				::operator delete(inPtr);
+				return;
+			}
+			static GLSlab		&slab = GetGLSlab(sizeof(T));
+			slab.release(inPtr);
+		}
+
+		template <typename U> bool operator==(const GLSlabAllocator<U> &) const noexcept { return true; }
+		template <typename U> bool operator!=(const GLSlabAllocator<U> &) const noexcept { return false; }
+};
+
+
+//!	Makes a new GLBuffer (passing the supplied args to its constructor), allocated from a GLSlab.  Use this instead of std::make_shared<GLBuffer>().
+template <typename... ARGS>
+inline GLBufferRef MakeGLBufferRef(ARGS&&... args)	{
+	return std::allocate_shared<GLBuffer>(GLSlabAllocator<GLBuffer>(), std::forward<ARGS>(args)...);
+}
+
+
+
+
+//! Size-classed arena for the memory that backs CPU-based GLBuffers.
+/*!
+\ingroup VVGL_MISC
+The CPU buffer creation functions (CreateRGBACPUBuffer(), etc) allocate their pixel memory from this arena.  Allocations are rounded up to a size class and released blocks are cached by size class (up to 'maxCachedBytes()'), so buffers of similar sizes that are created and deleted repeatedly recycle the same memory instead of hitting the system allocator.
+
+Notes on use:
+- Every allocation is aligned to #kAlignment bytes, so the rows of a CPU buffer whose bytes-per-row are a multiple of #kAlignment are all aligned for SIMD loads/stores.
+- On linux, large allocations can optionally be backed by transparent huge pages- see setHugePagesEnabled().
+- There's only one arena- use GetCPUBackingArena() to get it.
+*/
+class VVGL_EXPORT GLCPUBackingArena	{
+	public:
+		//!	The alignment of every pointer returned by allocate().
+		static const size_t		kAlignment = 64;
+		//!	Allocations at least this large are candidates for huge pages.
+		static const size_t		kHugePageSize = 2 * 1024 * 1024;
+
+	private:
+		std::mutex			_lock;
+		std::unordered_map<size_t,std::vector<void*>>		_freeBlocks;	//	key is the size class (in bytes), value is a stack of free blocks of that size
+		size_t				_cachedBytes = 0;
+		size_t				_maxCachedBytes = 256 * 1024 * 1024;
+		bool				_hugePagesEnabled = false;
+		size_t				_bytesInUse = 0;
+
+	public:
+		GLCPUBackingArena() = default;
+		GLCPUBackingArena(const GLCPUBackingArena &) = delete;
+		GLCPUBackingArena & operator=(const GLCPUBackingArena &) = delete;
+		~GLCPUBackingArena();
+
+		//!	Returns a #kAlignment-aligned block of memory at least 'inLength' bytes long, or null if the memory couldn't be allocated.  The block must be released with release().
+		void * allocate(const size_t & inLength);
+		//!	Releases a block allocated by this arena- the block is cached for reuse unless that would exceed 'maxCachedBytes()'.
+		void release(void * inPtr);
+		//!	Frees every cached block.
+		void purge();
+
+		//!	The size class 'inLength' bytes would be rounded up to.
+		static size_t sizeClassForLength(const size_t & inLength);
+
+		//!	Sets the max number of bytes the arena will keep cached for reuse (defaults to 256MB).
+		void setMaxCachedBytes(const size_t & n);
+		size_t maxCachedBytes();
+		//!	If true, blocks at least #kHugePageSize large are mmap'ed and advised to use transparent huge pages.  Only has an effect on linux, defaults to false.
+		void setHugePagesEnabled(const bool & n);
+		bool hugePagesEnabled();
+		//!	The number of bytes currently cached for reuse.
+		size_t cachedBytes();
+		//!	The number of bytes currently allocated and in use.
+		size_t bytesInUse();
+
+	private:
+		//	must be called with _lock held.  frees cached blocks (largest first) until _cachedBytes <= inMaxBytes.
+		void trimTo(const size_t & inMaxBytes);
+};
+
+
+//!	Returns the arena used to allocate memory for CPU-based GLBuffers.  Thread-safe.
+/*!
+\ingroup VVGL_MISC
+*/
+VVGL_EXPORT GLCPUBackingArena & GetCPUBackingArena();
+
+
+
+
+}
+
+
+#endif /* VVGL_GLBufferAllocator_hpp */
@@ -4,6 +4,9 @@
 #include "VVGL_Defines.hpp"
 
 #include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <string>
 
 #include "GLBuffer.hpp"
 
@@ -41,13 +44,117 @@ Notes on use:
 - Don't forget to call the housekeeping() member function on your buffer pools periodically!
 - GLBufferPool requires a GL context on creation- the pool maintains a strong ref to this context, and will use it to create/destroy GL resources unless instructed otherwise via the "createInCurrentContext" variable in the various buffer creation functions.
 */
-class VVGL_EXPORT GLBufferPool	{
+class VVGL_EXPORT GLBufferPool : public std::enable_shared_from_this<GLBufferPool>	{
+	
+	//	types
+	public:
+		/*!
+		\brief A snapshot of a buffer pool's statistics, returned by stats() and snapshotAndResetStats().
+		\details The counters (hits, misses, creations, deletions, lock times) accumulate from the last time they were reset.  The byte totals and buffer counts describe the pool at the time the snapshot was taken.  Only resources with internal backings are counted as bytes- buffers that wrap external textures or memory don't belong to the pool.
+		*/
+		struct Stats	{
+			//!	The number of times fetchMatchingFreeBuffer() found a free buffer to recycle.
+			uint64_t		fetchHits = 0;
+			//!	The number of times fetchMatchingFreeBuffer() couldn't find a free buffer to recycle.
+			uint64_t		fetchMisses = 0;
+			//!	The number of resources created by the pool, indexed by GLBuffer::Type.
+			uint64_t		creations[GLBuffer::Type_VAO+1] = {};
+			//!	The number of resources released by the pool, indexed by GLBuffer::Type.
+			uint64_t		deletions[GLBuffer::Type_VAO+1] = {};
+			//!	The number of free buffers sitting in the pool (including the per-thread caches).
+			uint64_t		freeBufferCount = 0;
+			//!	The bytes of VRAM and RAM occupied by free buffers sitting in the pool.
+			uint64_t		freeGPUBytes = 0;
+			uint64_t		freeCPUBytes = 0;
+			//!	The bytes of VRAM and RAM occupied by buffers created by the pool that are currently in use.
+			uint64_t		inFlightGPUBytes = 0;
+			uint64_t		inFlightCPUBytes = 0;
+			//!	The highest number of free buffers that were sitting in the pool at once.
+			uint64_t		peakFreeBufferCount = 0;
+			//!	The highest number of bytes (free and in flight, VRAM and RAM) that the pool's buffers occupied at once.
+			uint64_t		peakResidentBytes = 0;
+			//!	The amount of time (in nanoseconds) the pool spent holding its free buffer lock.
+			uint64_t		freeBuffersLockNanos = 0;
+			//!	The amount of time (in nanoseconds) the pool spent holding its context lock.
+			uint64_t		contextLockNanos = 0;
+			
+			//!	Returns the number of resources created by the pool, regardless of type.
+			uint64_t totalCreations() const;
+			//!	Returns the number of resources released by the pool, regardless of type.
+			uint64_t totalDeletions() const;
+			std::string getDescriptionString() const;
+			friend std::ostream & operator<<(std::ostream & os, const Stats & n) { os << n.getDescriptionString(); return os; }
+		};
+	
+	protected:
+		//	free buffers are bucketed by the properties that have to match for a buffer to be recycled (descriptor + size), so fetching a free buffer doesn't have to scan the whole pool
+		struct FreeBufferKey	{
+			GLBuffer::Descriptor	desc;
+			Size					size;
+			
+			FreeBufferKey(const GLBuffer::Descriptor & inDesc, const Size & inSize);
+			inline bool operator==(const FreeBufferKey & n) const { return (desc.isComparableForRecycling(n.desc) && size==n.size); }
+		};
+		struct FreeBufferKeyHash	{
+			size_t operator()(const FreeBufferKey & n) const;
+		};
+		using FreeBufferBucket = std::vector<GLBufferRef>;
+		//	every thread that returns buffers to the pool gets a small cache of free buffers ("magazine") that it can return buffers to/fetch buffers from without taking _freeBuffersLock.  caches refill from and spill to the shared pool in batches, and are drained back into the shared pool during housekeeping.
+		struct ThreadCache;
+		using ThreadCacheRef = std::shared_ptr<ThreadCache>;
+		//	GL names released by buffers that are waiting to be deleted in a batch by drainDeletions()
+		struct PendingDeletions	{
+			std::vector<uint32_t>		textures;
+			std::vector<uint32_t>		renderbuffers;
+			std::vector<uint32_t>		framebuffers;
+			std::vector<uint32_t>		buffers;	//	PBOs, VBOs, and EBOs
+			std::vector<uint32_t>		vertexArrays;
+			
+			inline bool empty() const { return (textures.empty() && renderbuffers.empty() && framebuffers.empty() && buffers.empty() && vertexArrays.empty()); }
+		};
+		//	the live counters behind Stats.  gauges are signed so updates from different threads that land out of order can't wrap around.
+		struct StatsCounters	{
+			std::atomic<uint64_t>		fetchHits { 0 };
+			std::atomic<uint64_t>		fetchMisses { 0 };
+			std::atomic<uint64_t>		creations[GLBuffer::Type_VAO+1];
+			std::atomic<uint64_t>		deletions[GLBuffer::Type_VAO+1];
+			std::atomic<int64_t>		freeBufferCount { 0 };
+			std::atomic<int64_t>		freeGPUBytes { 0 };
+			std::atomic<int64_t>		freeCPUBytes { 0 };
+			std::atomic<int64_t>		inFlightGPUBytes { 0 };
+			std::atomic<int64_t>		inFlightCPUBytes { 0 };
+			std::atomic<int64_t>		peakFreeBufferCount { 0 };
+			std::atomic<int64_t>		peakResidentBytes { 0 };
+			std::atomic<uint64_t>		freeBuffersLockNanos { 0 };
+			std::atomic<uint64_t>		contextLockNanos { 0 };
+			
+			StatsCounters();
+		};
 	
 	//	vars
 	protected:
 		bool				_deleted = false;
 		std::mutex				_freeBuffersLock;
-		std::vector<GLBufferRef>		_freeBuffers;
+		//	buffers are appended to the back of their bucket when they're returned to the pool, so the back of each bucket is the most recently used buffer
+		std::unordered_map<FreeBufferKey,FreeBufferBucket,FreeBufferKeyHash>		_freeBuffers;
+		
+		uint64_t			_poolID = 0;	//	unique per pool instance, used to locate this pool's cache in a thread's list of caches
+		std::atomic<size_t>		_threadCacheCapacity { 8 };	//	max number of free buffers per descriptor/size a thread may cache before spilling to the shared pool.  0 disables the thread caches.
+		std::mutex				_threadCachesLock;
+		std::vector<ThreadCacheRef>		_threadCaches;	//	strong refs to every thread's cache for this pool, so housekeeping can drain them
+		
+		//	when the memory budget is enabled, housekeeping only frees idle buffers while the idle bytes held by the pool exceed the budget (instead of freeing buffers that have been idle for a fixed number of passes).  protected by _freeBuffersLock.
+		bool				_memoryBudgetEnabled = false;
+		uint64_t			_gpuMemoryBudget = 0;
+		uint64_t			_cpuMemoryBudget = 0;
+		
+		//	when non-zero, eligible textures are allocated with dimensions rounded up to a multiple of this many pixels (and vended with a srcRect describing the requested region), so textures of similar sizes can be recycled for one another.  0 (the default) disables size classes.
+		std::atomic<uint32_t>	_sizeClassStep { 0 };
+		
+		StatsCounters		_stats;
+		
+		std::mutex				_pendingDeletionsLock;
+		PendingDeletions		_pendingDeletions;
 		
 		std::recursive_mutex		_contextLock;
 		GLContextRef		_context = nullptr;	//	this is the context that the buffer pool will use to create/destroy GL resources
@@ -69,11 +176,50 @@ class VVGL_EXPORT GLBufferPool	{
 		//!	This member function is how the pool creates buffers.  You probably shouldn't call this function directly- instead use one of the functions in (\ref VVGL_BUFFERCREATE) directly or as a prototype.  They're in %GLBufferPool.hpp/GLBufferPool.cpp.
 		GLBufferRef createBufferRef(const GLBuffer::Descriptor & desc, const Size & size={640,480}, const void * backingPtr=nullptr, const Size & backingSize={640,480}, const bool & createInCurrentContext=false);
 		GLBufferRef fetchMatchingFreeBuffer(const GLBuffer::Descriptor & desc, const Size & size);
+		/*!
+		\brief Creates GL resources ahead of time and puts them in the pool, so the frames that need them don't stall while they're created.
+		\param inDesc The descriptor of the buffers to create.  Only textures, renderbuffers, and FBOs without CPU backings can be reserved- the convenience functions (\ref VVGL_BUFFERRESERVE) fill this out for you.
+		\param inSize The size of the buffers to create.
+		\param inCount The pool will hold at least this many free buffers matching the descriptor and size when this returns.
+		\details The resources are created on the pool's context (with a single flush), so this can be called from a background thread.  On Qt the pool's context can only be used on its own thread- if this is called from another thread, the buffers are reserved asynchronously on the context's thread.  The pool must be owned by a GLBufferPoolRef.
+		*/
+		void reserve(const GLBuffer::Descriptor & inDesc, const Size & inSize, const size_t & inCount);
 		
-		//!	You must call this periodically (once per render loop after you finish drawing is usually a good time to call this).  This function frees any buffers that have been sitting unused in the pool for "too long".
+		//!	You must call this periodically (once per render loop after you finish drawing is usually a good time to call this).  This function frees any buffers that have been sitting unused in the pool for "too long", and deletes the GL resources of any buffers that were freed since the last call.
 		void housekeeping();
 		//!	If needed you can call this to release all inactive buffers in the pool.
 		void purge();
+		//!	Sets the max number of free buffers of any given descriptor/size that each thread may cache locally before it spills them back to the shared pool.  Defaults to 8, 0 disables the per-thread caches.
+		void setThreadCacheCapacity(const size_t & n);
+		//!	Returns the max number of free buffers of any given descriptor/size that each thread may cache locally.
+		inline size_t threadCacheCapacity() const { return _threadCacheCapacity; }
+		/*!
+		\brief Enables the memory-budgeted mode.  In this mode housekeeping() no longer frees buffers because they've been idle for a fixed number of passes- instead, it frees the least recently used idle buffers only while the idle buffers held by the pool exceed the passed budgets.
+		\param inGPUBytes The max number of bytes of idle GPU resources (textures, renderbuffers, PBOs) the pool may hold on to.
+		\param inCPUBytes The max number of bytes of idle CPU backings the pool may hold on to.
+		*/
+		void setMemoryBudget(const uint64_t & inGPUBytes, const uint64_t & inCPUBytes);
+		//!	Disables the memory-budgeted mode, restoring the default behavior (idle buffers are freed after a fixed number of housekeeping passes).
+		void disableMemoryBudget();
+		//!	Returns true if the memory-budgeted mode is enabled.
+		bool memoryBudgetEnabled();
+		//!	Enables the size-class mode: textures created by the pool without a backing are allocated with their width and height rounded up to a multiple of 'inStepInPixels', and vended with a srcRect describing the requested region.
+		/*!
+		\details Exact size matches are required to recycle textures, so textures whose sizes change slightly from frame to frame (window resizes, ISF passes with WIDTH/HEIGHT expressions) are never reused and VRAM churns.  Rounding allocations up to size classes lets those textures be recycled for one another.  Only 2D and rect textures that aren't backed by CPU memory or IOSurfaces are affected.  Anything that renders into or samples from these textures has to honor their srcRect (GLScene, the copiers and ISFScene all do).  Pass 0 to disable size classes (the default).
+		*/
+		void setSizeClassStep(const uint32_t & inStepInPixels);
+		//!	Returns the size-class step in pixels, or 0 if the size-class mode is disabled.
+		inline uint32_t sizeClassStep() const { return _sizeClassStep; }
+		//!	Returns the size a texture described by the passed descriptor would be allocated at for a request of 'inSize' with the current size-class step- returns 'inSize' if the size-class mode is disabled or the descriptor isn't eligible.
+		Size allocationSizeForSize(const GLBuffer::Descriptor & inDesc, const Size & inSize) const;
+		//!	Returns the number of bytes a buffer occupies in VRAM and RAM, calculated with GLBuffer::Descriptor::backingLengthForSize().
+		static void calculateBufferFootprint(const GLBuffer & inBuffer, uint64_t & outGPUBytes, uint64_t & outCPUBytes);
+		//!	Returns a snapshot of the pool's statistics.
+		Stats stats() const;
+		//!	Returns a snapshot of the pool's statistics, then resets its counters and peaks.  Call this once every N frames to log what the pool did during those frames.
+		Stats snapshotAndResetStats();
+		//!	Buffer creation functions that create GL resources without going through createBufferRef() call this so the pool's statistics include them.
+		void recordBufferCreation(const GLBuffer & inBuffer);
 		//!	Returns a timestamp generated for the current time
 		inline Timestamp getTimestamp() const { return Timestamp()-_baseTime; }
 		//!	Timestamps the passed buffer with the current time
@@ -87,12 +233,30 @@ class VVGL_EXPORT GLBufferPool	{
 		
 		friend std::ostream & operator<<(std::ostream & os, const GLBufferPool & n);
 		void flush();
+		//!	The GL resources of freed buffers aren't deleted immediately- they're queued, and deleted in a batch (one glDelete* call per type and a single flush) by this function.  housekeeping() and purge() call this, so you only need to call it yourself if you want GL resources deleted sooner.  On Qt, if the pool's context belongs to another thread the batch is deleted on that thread.
+		void drainDeletions();
 	
 	private:
+		//	Creates a new buffer and its GL resources, without checking the pool for a free buffer first
+		GLBufferRef createNewBufferRef(const GLBuffer::Descriptor & desc, const Size & size, const void * backingPtr, const Size & backingSize, const bool & createInCurrentContext);
 		//	Called by GLBuffer when it's being deallocated if the buffer has determined that it is a candidate for recycling
 		void returnBufferToPool(VVGL::GLBuffer * inBuffer);
-		//	Called by GLBuffer when it's being deallocated if the buffer has determined that its GL resources need to be released immediately
+		//	Called by GLBuffer when it's being deallocated if the buffer has determined that its GL resources need to be released.  The GL resources are queued for deletion by drainDeletions().
 		void releaseBufferResources(VVGL::GLBuffer * inBuffer);
+		//	Deletes the passed GL names in the current context, then flushes
+		static void deletePendingGLNames(const PendingDeletions & inNames);
+		//	Returns the calling thread's cache for this pool (creating it if necessary), or null if the thread is exiting
+		ThreadCacheRef currentThreadCache();
+		//	Moves the contents of every thread's cache back into the shared pool, and discards the caches of threads that have exited
+		void drainThreadCaches();
+		//	Removes and returns the most recently used buffer in the passed bucket that can be vended, or null
+		static GLBufferRef popFreeBuffer(FreeBufferBucket & inBucket);
+		//	Housekeeping for the memory-budgeted mode- frees the least recently used idle buffers until the pool is under budget.  _freeBuffersLock must be held.
+		void evictFreeBuffersOverBudget();
+		//	Updates the stats when a buffer is added to the pool's free buffers
+		void recordBufferReturnedToPool(const GLBuffer & inBuffer);
+		//	Updates the stats when a buffer is removed from the pool's free buffers- either vended (it's in flight again) or released
+		void recordBufferRemovedFromPool(const GLBuffer & inBuffer, const bool & inVended);
 		
 		friend GLBuffer::~GLBuffer();
 };
@@ -307,6 +471,54 @@ VVGL_EXPORT GLBufferRef CreateRGBATex(const Size & size, const bool & createInCu
 \param inPoolRef The pool that the GLBuffer should be created with.  When the GLBuffer is freed, its underlying GL resources will be returned to this pool (where they will be either freed or recycled).
 */
 VVGL_EXPORT GLBufferRef CreateRGBAFloatTex(const Size & size, const bool & createInCurrentContext=false, const GLBufferPoolRef & inPoolRef=GetGlobalBufferPool());
+/*!
+\ingroup VVGL_BUFFERCREATE
+\brief Creates and returns an OpenGL texture that has an internal RGBA format and is 8 bits per component (32 bit color), created with immutable storage (glTexStorage2D) if the GL context supports it.  Immutable textures can't be resized or re-specified, but the driver doesn't have to validate them every time they're used, which makes them a good choice for render targets.
+\param size The size of the buffer to create (in pixels).
+\param createInCurrentContext If true, the GL resource will be created in the current context (assumes that a GL context is active in the current thread).  If false, the GL resource will be created by the GL context owned by the buffer pool.
+\param inPoolRef The pool that the GLBuffer should be created with.  When the GLBuffer is freed, its underlying GL resources will be returned to this pool (where they will be either freed or recycled).
+*/
+VVGL_EXPORT GLBufferRef CreateRGBATexImmutable(const Size & size, const bool & createInCurrentContext=false, const GLBufferPoolRef & inPoolRef=GetGlobalBufferPool());
+/*!
+\ingroup VVGL_BUFFERCREATE
+\brief Creates and returns an OpenGL texture that has an internal RGBA format and is 32 bits per component (128 bit color), created with immutable storage (glTexStorage2D) if the GL context supports it.
+\param size The size of the buffer to create (in pixels).
+\param createInCurrentContext If true, the GL resource will be created in the current context (assumes that a GL context is active in the current thread).  If false, the GL resource will be created by the GL context owned by the buffer pool.
+\param inPoolRef The pool that the GLBuffer should be created with.  When the GLBuffer is freed, its underlying GL resources will be returned to this pool (where they will be either freed or recycled).
+*/
+VVGL_EXPORT GLBufferRef CreateRGBAFloatTexImmutable(const Size & size, const bool & createInCurrentContext=false, const GLBufferPoolRef & inPoolRef=GetGlobalBufferPool());
+/*!
+\ingroup VVGL_BUFFERRESERVE
+\brief Creates textures that match the textures created by CreateRGBATex() ahead of time, and puts them in the pool so they can be recycled.
+\param size The size of the textures to reserve (in pixels).
+\param count The pool will hold at least this many free textures of this size when this returns.
+\param inPoolRef The pool that the textures should be reserved in.
+*/
+VVGL_EXPORT void ReserveRGBATex(const Size & size, const size_t & count, const GLBufferPoolRef & inPoolRef=GetGlobalBufferPool());
+/*!
+\ingroup VVGL_BUFFERRESERVE
+\brief Creates textures that match the textures created by CreateRGBAFloatTex() ahead of time, and puts them in the pool so they can be recycled.
+\param size The size of the textures to reserve (in pixels).
+\param count The pool will hold at least this many free textures of this size when this returns.
+\param inPoolRef The pool that the textures should be reserved in.
+*/
+VVGL_EXPORT void ReserveRGBAFloatTex(const Size & size, const size_t & count, const GLBufferPoolRef & inPoolRef=GetGlobalBufferPool());
+/*!
+\ingroup VVGL_BUFFERRESERVE
+\brief Creates textures that match the textures created by CreateRGBATexImmutable() ahead of time, and puts them in the pool so they can be recycled.
+\param size The size of the textures to reserve (in pixels).
+\param count The pool will hold at least this many free textures of this size when this returns.
+\param inPoolRef The pool that the textures should be reserved in.
+*/
+VVGL_EXPORT void ReserveRGBATexImmutable(const Size & size, const size_t & count, const GLBufferPoolRef & inPoolRef=GetGlobalBufferPool());
+/*!
+\ingroup VVGL_BUFFERRESERVE
+\brief Creates textures that match the textures created by CreateRGBAFloatTexImmutable() ahead of time, and puts them in the pool so they can be recycled.
+\param size The size of the textures to reserve (in pixels).
+\param count The pool will hold at least this many free textures of this size when this returns.
+\param inPoolRef The pool that the textures should be reserved in.
+*/
+VVGL_EXPORT void ReserveRGBAFloatTexImmutable(const Size & size, const size_t & count, const GLBufferPoolRef & inPoolRef=GetGlobalBufferPool());
 
 #if !defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
 /*!
@@ -3,9 +3,12 @@
 
 #include "VVGL_Defines.hpp"
 #include "GLBufferPool.hpp"
+#include "VVGL_PixelConversion.hpp"
 
 #include <mutex>
 #include <queue>
+#include <vector>
+#include <memory>
 
 
 
@@ -26,6 +29,8 @@ namespace VVGL
 /*!
 \ingroup VVGL_BASIC
 Offers both immediate upload and n-buffered texture uploads for double-/triple-/n-buffering/ping-ponging.  Uses PBOs for async DMA.
+
+If the GL context supports persistently mapped buffers (GL_ARB_buffer_storage), createRingCPUBuffer() vends CPU buffers whose memory is a slot in a single PBO that stays mapped for the lifetime of the copier.  Producers write their pixels straight into the slot, and uploading it doesn't have to map a PBO or copy anything- the texture upload is issued from the slot, and a fence behind it tells the copier when the slot can be reused.
 */
 
 class VVGL_EXPORT GLCPUToTexCopier	{
@@ -38,11 +43,44 @@ class VVGL_EXPORT GLCPUToTexCopier	{
 		std::queue<GLBufferRef>		_texQueue;	//	queue of textures
 		bool					_swapBytes = false;
 		GLBufferPoolRef			_privatePool = nullptr;	//	by default this is null and the scene will try to use the global buffer pool to create interim resources (temp/persistent buffers).  if non-null, the scene will use this pool to create interim resources.
+		
+		//	a slot in the persistently mapped upload ring
+		struct RingSlot	{
+			enum State	{
+				State_Free,	//	available to be vended by createRingCPUBuffer()
+				State_Writing,	//	vended as a CPU buffer, which hasn't been uploaded yet
+				State_InFlight	//	uploaded- 'fence' is signaled when the GPU is done reading it
+			};
+			State			state = State_Free;
+			uint64_t		generation = 0;	//	incremented every time the slot is vended, so a released CPU buffer only frees the slot if it's still the buffer that owns it
+			GLsync			fence = nullptr;
+		};
+		//	a single persistently mapped PBO split into equally-sized slots.  shared with the CPU buffers that point into it (they may be released on any thread), so access to the slots is guarded by its own lock.
+		struct PersistentRing	{
+			std::mutex				lock;
+			uint32_t				name = 0;	//	the GL buffer
+			uint8_t					*basePtr = nullptr;	//	the persistent mapping of the GL buffer
+			size_t					slotSize = 0;	//	the size (in bytes) of each slot
+			std::vector<RingSlot>	ringSlots;
+		};
+		std::shared_ptr<PersistentRing>		_ring = nullptr;	//	the ring new CPU buffers are vended from
+		std::vector<std::shared_ptr<PersistentRing>>	_retiredRings;	//	rings that were replaced by a larger ring but still have slots that are being written or uploaded
+		int						_ringSlotCount = 3;
 	
 	private:
 		//	before calling either of these functions, _queueLock should be locked and a GL context needs to be made current on this thread.
 		void _beginProcessing(const GLBufferRef & inCPUBuffer, const GLBufferRef & inPBOBuffer, const GLBufferRef & inTexBuffer);
 		void _finishProcessing(const GLBufferRef & inCPUBuffer, const GLBufferRef & inPBOBuffer, const GLBufferRef & inTexBuffer);
+		//	if the CPU buffer's pixels have to be converted to upload them to the texture (and we know how to do that), returns a PBO in the texture's format- else returns null and the PBO should be created in the CPU buffer's format.  _queueLock should be locked.
+		GLBufferRef _createConvertingPBO(const GLBufferRef & inCPUBuffer, const GLBufferRef & inTexBuffer, const bool & createInCurrentContext, const GLBufferPoolRef & inPool);
+		//	returns the ring the passed buffer's memory belongs to (or null if it isn't a ring buffer), populates 'outSlotIndex' with the index of its slot.  _queueLock should be locked.
+		std::shared_ptr<PersistentRing> _ringForBuffer(const GLBufferRef & inCPUBuffer, size_t & outSlotIndex);
+		//	uploads a CPU buffer vended by createRingCPUBuffer() straight from its slot to the texture and fences the slot.  _queueLock should be locked and a GL context needs to be made current on this thread.
+		void _uploadFromRing(const GLBufferRef & inCPUBuffer, const GLBufferRef & inTexBuffer);
+		//	frees every in-flight slot whose fence has been signaled (if 'inWait' is true and no slot is free, waits for the oldest in-flight slot), and deletes retired rings that are no longer in use.  _queueLock should be locked and a GL context needs to be made current on this thread.
+		void _reclaimRingSlots(const bool & inWait);
+		//	deletes the passed ring's GL resources.  a GL context needs to be made current on this thread.
+		static void _deleteRing(const std::shared_ptr<PersistentRing> & inRing);
 	
 	public:
 		GLCPUToTexCopier();
@@ -83,6 +121,22 @@ class VVGL_EXPORT GLCPUToTexCopier	{
 		*/
 		GLBufferRef streamCPUToTex(const GLBufferRef & inCPUBuffer, const GLBufferRef & inTexBuffer, const bool & createInCurrentContext=false);
 		
+		//!	Returns true if the GL context supports persistently mapped buffers (GL_ARB_buffer_storage, core in GL 4.4), which createRingCPUBuffer() requires.
+		bool persistentRingAvailable();
+		//!	Sets the number of slots in the persistently mapped ring (defaults to 3, min 2).  Takes effect the next time the ring is allocated.
+		void setPersistentRingSlotCount(const int & n);
+		//!	Returns the number of slots in the persistently mapped ring.
+		int persistentRingSlotCount() { std::lock_guard<std::recursive_mutex> lock(_queueLock); return _ringSlotCount; }
+		//! Returns a CPU-based GLBuffer whose memory is a slot in a persistently mapped PBO- write an image into its 'cpuBackingPtr' and pass it to streamCPUToTex() or uploadCPUToTex(), which will upload it without mapping a PBO or copying it.
+		/*!
+		\param inSize The size of the image, in pixels.  The ring is reallocated if its slots are too small to hold an image this large.
+		\param inLayout The layout of the pixels.  Must be PixelLayout_RGBA8, PixelLayout_BGRA8, PixelLayout_RGBA32F, PixelLayout_BGRA32F or PixelLayout_UYVY.
+		\param createInCurrentContext Defaults to false- if true, any GL resources will be created by the current GL context in the calling thread.  If false, the local var _queueCtx will be used.
+		\return Returns null if persistent mapping isn't available (see persistentRingAvailable()) or every slot has been vended and not uploaded yet- in either case, fall back to a normal CPU buffer.  If every free slot is still being uploaded, this waits for the oldest upload to finish.
+		\details The buffer's rows are tightly packed.  Release the buffer (or let the copier's queue release it) when you're done with it- if it's released before it's uploaded its slot is returned to the ring.  Don't write to the buffer after it's been uploaded, and don't use it after the copier has been freed.
+		*/
+		GLBufferRef createRingCPUBuffer(const Size & inSize, const PixelLayout & inLayout=PixelLayout_RGBA8, const bool & createInCurrentContext=false);
+		
 		//!	Sets the receiver's private buffer pool (which should default to null).  If non-null, this buffer pool will be used to generate any GL resources required by this scene.  Handy if you have a variety of GL contexts that aren't shared and you have to switch between them rapidly on a per-frame basis.
 		void setPrivatePool(const GLBufferPoolRef & n) { _privatePool=n; }
 		//!	Gets the receiver's private buffer pool- null by default, only non-null if something called setPrivatePool().
@@ -6,6 +6,7 @@
 #include <iostream>
 
 #include "VVGL_StringUtils.hpp"
+#include "GLProgramReflection.hpp"
 
 
 
@@ -43,10 +44,12 @@ struct VVGL_EXPORT GLCachedProperty	{
 	public:
 		//!	Pure virtual function, subclasses *must* implement this.  This is where the GL stuff specific to the subclass is performed.  A valid GL context *must* be current before you call this function- subclasses may have additional requirements.
 		virtual void cacheTheLoc(const int32_t & inPgmToCheck);
+		//!	Pure virtual function, subclasses *must* implement this.  Caches the location from the passed description of a program instead of querying GL.  If the property isn't in the program, the location is -1 (and location() won't look it up again for that program).
+		virtual void cacheTheLoc(const GLProgramReflection & inReflection);
 		inline void purgeCache() { loc=-1; prog=-1; }
 	public:
 		//!	Returns the location of the property cached by the receiver.  A valid GL context must be current before you call this function.  Caches the location if it hasn't been looked up/cached yet.  Will only return -1 if there's a problem (if the attrib doesn't exist in the current program in use by the current context).
-		int32_t location(const int32_t & inGLProgram) { if (loc<0 || inGLProgram<0 || inGLProgram!=prog) cacheTheLoc(inGLProgram); return loc; }
+		int32_t location(const int32_t & inGLProgram) { if (inGLProgram<0 || inGLProgram!=prog) cacheTheLoc(inGLProgram); return loc; }
 		std::string getDescriptionString() const { return FmtString("<GLCachedProperty \"%s\", %d>",this->name.c_str(),this->loc); }
 		friend std::ostream & operator<<(std::ostream & os, const GLCachedProperty & n) { os<<n.getDescriptionString();return os; }
 };
@@ -72,6 +75,8 @@ struct VVGL_EXPORT GLCachedAttrib : GLCachedProperty	{
 		
 		//!	Caches the location of the receiver's attribute in the passed program.  A valid GL context must be current and the program this attribute refers to must be bound before you call this function!
 		void cacheTheLoc(const int32_t & inPgmToCheck) override;
+		//!	Caches the location of the receiver's attribute from the passed description of a program- doesn't make any GL calls.
+		void cacheTheLoc(const GLProgramReflection & inReflection) override;
 };
 
 
@@ -90,8 +95,29 @@ struct VVGL_EXPORT GLCachedUni : GLCachedProperty	{
 	public:
 		std::string getDescriptionString() const { return FmtString("<GLCachedUni \"%s\", %d>",this->name.c_str(),this->loc); }
 		
-		//!	Caches the location of the receiver's uniform in the passed program.  A valid GL context must be current and the program this uniform refers to must be bound before you call this function!
+		//!	Caches the location of the receiver's uniform in the passed program.  A valid GL context must be current and the program this uniform refers to must be bound before you call this function!  Forgets the value that was last sent.
 		void cacheTheLoc(const int32_t & inPgmToCheck) override;
+		//!	Caches the location of the receiver's uniform from the passed description of a program- doesn't make any GL calls.  Forgets the value that was last sent.
+		void cacheTheLoc(const GLProgramReflection & inReflection) override;
+		
+		/*!
+		\name Sending values
+		\brief These functions send the passed value to the receiver's uniform, unless it's the value they last sent to it- they return true if the value was sent, and false if it was skipped (or there's no uniform).  A valid GL context must be current and the program this uniform refers to must be in use before you call them.  The value is remembered until the location is cached again- if something else may have changed the uniform, call forgetSentVal().
+		*/
+		///@{
+		bool set1i(const int32_t & n);
+		bool set1f(const float & n);
+		bool set2f(const float & n0, const float & n1);
+		bool set4f(const float & n0, const float & n1, const float & n2, const float & n3);
+		//!	Forgets the value that was last sent, so the next value is sent regardless.
+		inline void forgetSentVal() { _sentSize = 0; }
+		///@}
+	private:
+		//	the value that was last sent with one of the set functions, and its size in bytes (0 if no value was sent since the loc was cached)
+		uint32_t		_sentVal[4] = { 0, 0, 0, 0 };
+		size_t			_sentSize = 0;
+		//	returns true (and remembers the passed value) if it isn't the value that was last sent
+		bool _changedSentVal(const void * inVal, const size_t & inSize);
 };
 
 
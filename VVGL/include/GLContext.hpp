@@ -41,10 +41,23 @@
 	#include <Windows.h>
 	#include <GL/glew.h>
 	#include <GL/wglew.h>
+#elif defined(VVGL_SDK_EGL)
+	//	we don't want eglplatform.h to pull in the X11 headers (their macros collide with everything, and there's no X server anyway)
+	#ifndef EGL_NO_X11
+	#define EGL_NO_X11
+	#endif
+	#ifndef MESA_EGL_NO_X11_HEADERS
+	#define MESA_EGL_NO_X11_HEADERS
+	#endif
+	#include <GL/glew.h>
+	#include <EGL/egl.h>
+	#include <EGL/eglext.h>
+	#include <memory>
 #endif
 
 #include "VVGL_Base.hpp"
 #include "VVGL_Geom.hpp"
+#include "GLStateCache.hpp"
 
 
 
@@ -118,6 +131,22 @@ VVGL_EXPORT std::unique_ptr<int[]> AllocGL4ContextAttribs();
 \brief Configures the passed device context by calling SetPixelFormat() on it.  Please note that according to the Windows SDK, this function may only be called once per device context!
 */
 VVGL_EXPORT bool ConfigDeviceContextPixelFormat(const HDC & inDC);
+#elif defined(VVGL_SDK_EGL)
+/*!
+\relatesalso GLContext
+\brief Returns the EGL display that contexts are created on by default- Mesa's surfaceless platform (EGL_MESA_platform_surfaceless) if it's available, which doesn't need a display server or a GPU, otherwise EGL_DEFAULT_DISPLAY.  The display is initialized the first time this is called, and is never terminated.
+*/
+VVGL_EXPORT EGLDisplay GetDefaultEGLDisplay();
+/*!
+\relatesalso GLContext
+\brief Creates an EGL_NONE-terminated array of attributes that describe a compatibility profile OpenGL context, for use with GLContext's constructors.
+*/
+VVGL_EXPORT std::unique_ptr<EGLint[]> AllocCompatibilityContextAttribs();
+/*!
+\relatesalso GLContext
+\brief Creates an EGL_NONE-terminated array of attributes that describe a core profile OpenGL 4.5 context, for use with GLContext's constructors.  This is what contexts are created with by default.
+*/
+VVGL_EXPORT std::unique_ptr<EGLint[]> AllocGL4ContextAttribs();
 #endif
 
 
@@ -134,6 +163,25 @@ Notes on use:
 - The specific constructor (or create functions) for creating a GLContext is going to depend on the SDK you're working with, because they generally require some sort of platform- or SDK-specific object or pointer to a native GL context.
 */
 class VVGL_EXPORT GLContext	{
+	
+	//	types
+	public:
+		/*!
+		\brief A snapshot of how often contexts were asked to become current, and how often that actually switched contexts.  Returned by GetSwitchStats() and GetThreadSwitchStats().
+		\details The counters accumulate from the last time they were reset- snapshot and reset them once per frame to spot scenes that bounce between contexts.
+		*/
+		struct SwitchStats	{
+			//!	The number of calls to makeCurrent(), makeCurrentIfNotCurrent(), and makeCurrentIfNull().
+			uint64_t		requests = 0;
+			//!	The number of calls to makeCurrentIfNotCurrent() that were answered by the calling thread's cached current context, without going through the SDK.
+			uint64_t		cacheHits = 0;
+			//!	The number of calls that actually changed the calling thread's current context.
+			uint64_t		switches = 0;
+			
+			std::string getDescriptionString() const;
+			friend std::ostream & operator<<(std::ostream & os, const SwitchStats & n) { os << n.getDescriptionString(); return os; }
+		};
+	
 	public:
 		
 #if defined(VVGL_SDK_MAC)
@@ -164,6 +212,15 @@ class VVGL_EXPORT GLContext	{
 		std::shared_ptr<std::vector<GLContext*>>		shareGroup = std::make_shared<std::vector<GLContext*>>();
 		GLContextWindowBackingRef		windowBacking = nullptr;
 		std::unique_ptr<int[]>		_contextAttribs = nullptr;
+#elif defined(VVGL_SDK_EGL)
+		EGLDisplay			display = EGL_NO_DISPLAY;	//	weak ref- displays aren't terminated, because that would destroy every context on them
+		EGLConfig			config = nullptr;
+		EGLSurface			surface = EGL_NO_SURFACE;	//	EGL_NO_SURFACE if the display supports surfaceless contexts, otherwise a 1x1 pbuffer.  we only ever render to FBOs.
+		EGLContext			ctx = EGL_NO_CONTEXT;
+		EGLContext			shareGroupCtx = EGL_NO_CONTEXT;	//	the first context in this context's sharegroup.  weak ref- it's only ever compared, never used.
+		bool				ownsCtx = false;	//	whether or not 'ctx' (and 'surface') are owned by this GLContext instance.  if they're owned, they're destroyed when the owning instance is destroyed
+		bool				initializedFuncs = false;	//	read some docs that say the GLEW funcs must be initialized once per-context per-thread
+		std::unique_ptr<EGLint[]>		_contextAttribs = nullptr;
 #endif
 		//!	The version of OpenGL this context is using.
 		GLVersion			version = GLVersion_Unknown;
@@ -249,6 +306,16 @@ class VVGL_EXPORT GLContext	{
 		static unsigned int bootstrapGLEnvironmentIfNecessary();
 		static unsigned int bootstrapGLEnvironment();
 
+#elif defined(VVGL_SDK_EGL)
+		//	creates nothing!  strictly a "wrapper" around the passed context and surface- weak refs to both, they must exist for the lifetime of the returned object.  'inSurface' may be EGL_NO_SURFACE if the display supports surfaceless contexts, 'inSharedCtx' is the context 'inCtx' was created sharing (or EGL_NO_CONTEXT).
+		GLContext(EGLDisplay inDisplay, EGLSurface inSurface, EGLContext inSharedCtx, EGLContext inCtx);
+		//	creates a new GL context on the passed display that shares 'inSharedCtx' (which may be EGL_NO_CONTEXT).  if 'inCtxAttribs' is null, a GL 4.5 core profile context is created.
+		GLContext(EGLDisplay inDisplay, EGLContext inSharedCtx, const EGLint * inCtxAttribs=nullptr);
+		
+		inline EGLDisplay eglDisplay() const { return display; }
+		inline EGLContext context() const { return ctx; }
+		inline EGLSurface eglSurface() const { return surface; }
+		
 #endif
 		//	this function creates a context using the default pixel format
 		GLContext();
@@ -281,9 +348,50 @@ class VVGL_EXPORT GLContext	{
 
 		std::string getRenderer() { return _renderer; }
 		
+		//!	Returns the context switch stats of the calling thread.
+		static SwitchStats GetThreadSwitchStats();
+		//!	Returns the context switch stats of the calling thread, and resets them.
+		static SwitchStats SnapshotAndResetThreadSwitchStats();
+		//!	Returns the context switch stats of every thread combined.
+		static SwitchStats GetSwitchStats();
+		//!	Returns the context switch stats of every thread combined, and resets them (the per-thread stats aren't reset).
+		static SwitchStats SnapshotAndResetSwitchStats();
+		/*!
+		\brief Forgets which context GLContext made current on the calling thread, so the next makeCurrentIfNotCurrent() asks the SDK.
+		\details makeCurrentIfNotCurrent() remembers the last context it made current on each thread.  Most SDKs double-check that it's still current, but under VVGL_SDK_EGL it's trusted (querying EGL costs as much as the rest of the call), so call this after making a context current (or releasing one) with eglMakeCurrent() directly.
+		*/
+		static void InvalidateCurrentContextCache();
+		
+		//!	Returns the cache of this context's GL bindings- see GLStateCache.
+		inline GLStateCache & stateCache() { return _stateCache; }
+		
 		GLContext & operator=(const GLContext & n);
 		friend std::ostream & operator<<(std::ostream & os, const GLContext & n);
 		friend std::ostream & operator<<(std::ostream & os, const GLContext * n);
+		
+	private:
+		friend class GLStateCache;
+		
+		//	uniquely identifies this instance in the per-thread cache of current contexts
+		uint64_t			_instanceID = _NewInstanceID();
+		//	shadows this context's bindings so redundant state changes can be skipped
+		GLStateCache		_stateCache;
+		
+		static uint64_t _NewInstanceID();
+		//	returns the native context this instance makes current (the window under GLFW), as an opaque ptr.  implemented per-SDK.
+		void * _nativeContextHandle() const;
+		//	returns the native context that's current on the calling thread, as an opaque ptr.  implemented per-SDK.
+		static void * _NativeCurrentContextHandle();
+		//	counts a request to make a context current
+		static void _countCurrentContextRequest();
+		//	counts a request to make this context current, and returns true if the calling thread's cache shows it's already current
+		bool _currentContextCacheHit();
+		//	called after the SDK was asked to make this context current- caches it as the calling thread's current context if it is, and counts a switch if the thread's current context changed
+		void _cacheAsCurrentContext(void * inPrevNativeCtx);
+		//	returns true if the calling thread's cache shows this instance is current (doesn't ask the SDK or count anything)
+		bool _isCachedAsCurrentContext() const;
+		//	returns the native context the calling thread's cache shows is current (null if it isn't known)
+		static void * _CachedCurrentNativeContext();
 };
 
 
@@ -365,6 +473,24 @@ inline GLContextRef CreateNewGLContextRef(const HGLRC & inShareCtx, const HDC &
 \param inCtxAttribs 
 */
 inline GLContextRef CreateNewGLContextRef(const HGLRC & inShareCtx, const int * inCtxAttribs) { return std::make_shared<GLContext>(inShareCtx, inCtxAttribs); }
+#elif defined(VVGL_SDK_EGL)
+/*!
+\relatesalso GLContext
+\brief Doesn't create any GL resources, just makes a new GLContext instance around the passed EGLContext.  Does NOT take ownership of the passed context or surface, which must exist for the lifetime of the returned GLContext instance.
+\param inDisplay The display the context was created on.
+\param inSurface The surface the context renders to, or EGL_NO_SURFACE if the display supports surfaceless contexts.
+\param inSharedCtx The context the passed context was created sharing, or EGL_NO_CONTEXT.
+\param inCtx Must be non-null.
+*/
+inline GLContextRef CreateGLContextRefUsing(EGLDisplay inDisplay, EGLSurface inSurface, EGLContext inSharedCtx, EGLContext inCtx) { return std::make_shared<GLContext>(inDisplay, inSurface, inSharedCtx, inCtx); }
+/*!
+\relatesalso GLContext
+\brief Creates a new OpenGL context and GLContext instance.  No window or display server is required- if the display doesn't support surfaceless contexts, a 1x1 pbuffer is created for the context.
+\param inDisplay The display the context will be created on- GetDefaultEGLDisplay() returns a display that works without a GPU.
+\param inSharedCtx When the new OpenGL context is created, it will share this context.  May be EGL_NO_CONTEXT.
+\param inCtxAttribs The attributes used to create the GL context.  If null, AllocGL4ContextAttribs() is used.
+*/
+inline GLContextRef CreateNewGLContextRef(EGLDisplay inDisplay, EGLContext inSharedCtx, const EGLint * inCtxAttribs=nullptr) { return std::make_shared<GLContext>(inDisplay, inSharedCtx, inCtxAttribs); }
 #endif
 /*!
 \relatesalso GLContext
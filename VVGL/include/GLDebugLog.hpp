@@ -0,0 +1,132 @@
+#ifndef VVGL_GLDebugLog_hpp
+#define VVGL_GLDebugLog_hpp
+
+#include "VVGL_Defines.hpp"
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <iostream>
+
+
+
+
+namespace VVGL
+{
+
+
+
+
+//! Captures the messages GL reports through KHR_debug (GL 4.3) in a lock-free log, so errors stay visible without calling glGetError() after every GL call.
+/*!
+\ingroup VVGL_MISC
+Building with GL_DEBUG makes every GLERRLOG call glGetError(), which syncs the CPU with the GPU after nearly every GL call.  GLDebugLog gets the same information from the driver instead: call GLDebugLog::SetEnabled(true) before creating your contexts, and every GLContext installs a debug message callback when it's created.  Messages are copied into a fixed-size ring buffer without taking a lock- call GLDebugLog::DrainMessages() periodically to collect them.
+
+Notes on use:
+- Debug output is only available under SDKs whose GL headers have KHR_debug (GLFW, Qt, Win, EGL), and only on contexts whose driver supports it.  Elsewhere SetEnabled() is accepted but nothing is captured.
+- By default messages are delivered synchronously (GL_DEBUG_OUTPUT_SYNCHRONOUS), so they're raised on the thread and at the call that caused them.  Drivers may be faster without it, but messages then arrive on a driver thread and can't be attributed to debug groups or call sites.
+- GLDebugLog::Group pushes a debug group (glPushDebugGroup) for its lifetime- messages raised inside it are tagged with its label, and the label shows up in GL debuggers/profilers.  ISFScene pushes a group for each pass while debug output is enabled.
+- If VVGL is compiled with VVGL_DEBUG_SITES defined, every GLERRLOG marks its call site instead of calling glGetError(), and each site counts the messages raised by the GL call in front of it- see GLDebugLog::GetSiteCounts().  This costs a function call per GLERRLOG, but doesn't sync with the GPU.  Messages raised by GL calls that aren't followed by a GLERRLOG (calls made by your app, for example) are counted by the next GLERRLOG on the thread.
+*/
+class VVGL_EXPORT GLDebugLog	{
+	public:
+		//!	A message reported by GL, as it was copied into the log.
+		struct Message	{
+			//!	The GL enums describing the message (GL_DEBUG_SOURCE_*, GL_DEBUG_TYPE_*, GL_DEBUG_SEVERITY_*) and the message's implementation-defined id.
+			uint32_t		source = 0;
+			uint32_t		type = 0;
+			uint32_t		id = 0;
+			uint32_t		severity = 0;
+			//!	The label of the innermost GLDebugLog::Group that was open when the message was raised (empty if there wasn't one, or if the message was delivered asynchronously).
+			std::string		group;
+			//!	The text of the message (long messages are truncated).
+			std::string		text;
+
+			std::string getDescriptionString() const;
+			friend std::ostream & operator<<(std::ostream & os, const Message & n) { os << n.getDescriptionString(); return os; }
+		};
+
+		//!	Counts of the messages GL reported.  Returned by GetStats() and SnapshotAndResetStats().
+		struct Stats	{
+			//!	The number of messages GL reported.
+			uint64_t		messages = 0;
+			//!	The number of messages of type GL_DEBUG_TYPE_ERROR.
+			uint64_t		errors = 0;
+			//!	The number of messages that were overwritten (or were being written) before they could be drained from the log.
+			uint64_t		dropped = 0;
+			//!	The number of messages that were attributed to a call site (only with VVGL_DEBUG_SITES).
+			uint64_t		attributed = 0;
+
+			std::string getDescriptionString() const;
+			friend std::ostream & operator<<(std::ostream & os, const Stats & n) { os << n.getDescriptionString(); return os; }
+		};
+
+		//!	A GL call site (a GLERRLOG), and the number of debug messages raised by the GL call in front of it.  Sites are static, and are only created with VVGL_DEBUG_SITES.
+		class VVGL_EXPORT Site	{
+			public:
+				Site(const char * inFile, const int & inLine);
+				Site(const Site &) = delete;
+				Site & operator=(const Site &) = delete;
+
+				const char					*file;
+				const int					line;
+				std::atomic<uint64_t>		messageCount { 0 };
+				//	sites are registered in a lock-free singly-linked list
+				Site						*next = nullptr;
+		};
+		//!	A snapshot of a site's message count, returned by GetSiteCounts().
+		struct SiteCount	{
+			std::string		file;
+			int				line = 0;
+			uint64_t		count = 0;
+		};
+
+		//!	Pushes a debug group on the current context when it's created, and pops it when it's destroyed- does nothing if debug output isn't enabled or the label is empty.  The group must be popped on the context it was pushed on.
+		class VVGL_EXPORT Group	{
+			public:
+				Group(const std::string & inLabel);
+				~Group();
+				Group(const Group &) = delete;
+				Group & operator=(const Group &) = delete;
+			private:
+				bool			_pushed = false;
+		};
+
+	public:
+		//!	Enables or disables debug output.  Contexts created while it's enabled install the debug message callback- if 'inSynchronous' is true, messages are delivered on the thread that raised them.  Disabling it makes the callbacks ignore messages (they aren't uninstalled).
+		static void SetEnabled(const bool & n, const bool & inSynchronous=true);
+		//!	Returns true if debug output is enabled.
+		static inline bool Enabled() { return _enabled.load(std::memory_order_relaxed); }
+		//!	Installs the debug message callback on the current context and enables debug output on it (GLContext does this automatically for the contexts it creates while debug output is enabled).  Returns false if the context doesn't support KHR_debug.
+		static bool InstallOnCurrentContext();
+
+		//!	Returns the messages that were added to the log since it was last drained, oldest first.
+		static std::vector<Message> DrainMessages();
+		//!	Returns the message counts.
+		static Stats GetStats();
+		//!	Returns the message counts, and resets them.
+		static Stats SnapshotAndResetStats();
+		//!	Returns the call sites that have counted messages (only with VVGL_DEBUG_SITES), most messages first.
+		static std::vector<SiteCount> GetSiteCounts();
+		//!	Resets the message count of every call site.
+		static void ResetSiteCounts();
+
+		//!	Adds a message to the log- this is what the debug message callback does with the messages GL reports.  'inLength' is the length of the text, or -1 if it's null-terminated.
+		static void AppendMessage(const uint32_t & inSource, const uint32_t & inType, const uint32_t & inID, const uint32_t & inSeverity, const char * inText, const int32_t & inLength=-1);
+		//!	Called by GLERRLOG when VVGL_DEBUG_SITES is defined- messages raised on this thread since the last site was marked are attributed to the passed site.
+		static void MarkSite(Site * inSite);
+
+	private:
+		static std::atomic<bool>		_enabled;
+
+		//	adds the passed site to the list of sites
+		static void _RegisterSite(Site * inSite);
+};
+
+
+
+
+}
+
+
+#endif /* VVGL_GLDebugLog_hpp */
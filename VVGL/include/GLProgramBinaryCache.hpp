@@ -0,0 +1,83 @@
+#ifndef VVGL_GLProgramBinaryCache_hpp
+#define VVGL_GLProgramBinaryCache_hpp
+
+#include "VVGL_Defines.hpp"
+
+#include <string>
+#include <iostream>
+
+#include "VVGL_Base.hpp"
+
+
+
+
+namespace VVGL
+{
+
+
+
+
+//! Saves linked programs to disk (glGetProgramBinary) so they can be loaded the next time they're needed (glProgramBinary) instead of being compiled and linked again.
+/*!
+\ingroup VVGL_MISC
+Compiling and linking large shaders can take much longer than everything else an app does when it loads a show.  If you give the binary cache a directory with GLProgramBinaryCache::SetDirectory(), every program GLScene links is saved to a file in that directory, and the next time a scene needs a program with the same shaders- in the same run or a later one- it loads the program from the file instead of compiling it.  The cache is disabled (nothing is read or written) until a directory is set.
+
+Notes on use:
+- Files are named after a hash of the shader sources, the context's GL version, and the GL_RENDERER and GL_VERSION strings.  The sources and strings are also saved in the file and compared when it's loaded, so a file is never used for a different program, GPU, or driver.
+- Drivers are free to reject a binary they saved (after an update, for example).  If a binary is rejected, or a file can't be read, the file is deleted and the program is compiled and linked normally (and saved again).
+- Program binaries need GL 4.1 or GL ES 3 (or ARB_get_program_binary), and a driver that supports at least one binary format- otherwise the cache does nothing.
+- Scenes with a pre-link callback never use the cache, because the callback may configure the program in ways the cache can't know about.
+- The directory must already exist, and files are never removed from it (except files that were rejected)- delete them yourself if you want to clear the cache.
+- This is independent of GLProgramCache (which shares linked programs between scenes in memory)- scenes that share a program look in GLProgramCache first, then in the binary cache, and only compile the program if neither has it.
+*/
+class VVGL_EXPORT GLProgramBinaryCache	{
+	public:
+		//!	A snapshot of how well the cache is doing.  Returned by GetStats() and SnapshotAndResetStats().
+		struct Stats	{
+			//!	The number of programs that were loaded from a file.
+			uint64_t		hits = 0;
+			//!	The number of programs that weren't in the cache (including programs whose binary was rejected).
+			uint64_t		misses = 0;
+			//!	The number of files that were deleted because the driver rejected the binary in them, or because they couldn't be read.
+			uint64_t		rejected = 0;
+			//!	The number of programs that were saved to a file.
+			uint64_t		stored = 0;
+			//!	The total time spent loading programs from files, in seconds.
+			double			loadSeconds = 0.;
+			//!	The total time the programs that were loaded from files took to compile and link when they were saved, minus the time it took to load them- an estimate of the time the cache saved, in seconds.
+			double			savedSeconds = 0.;
+
+			std::string getDescriptionString() const;
+			friend std::ostream & operator<<(std::ostream & os, const Stats & n) { os << n.getDescriptionString(); return os; }
+		};
+
+	public:
+		//!	Sets the directory the cache reads and writes files in.  Pass an empty string to disable the cache (the default).
+		static void SetDirectory(const std::string & n);
+		//!	Returns the directory the cache reads and writes files in, or an empty string if the cache is disabled.
+		static std::string Directory();
+		//!	Returns true if a directory has been set.
+		static bool Enabled();
+		//!	Returns true if program binaries can be retrieved and loaded in the current context (which must be the passed context).
+		static bool AvailableInContext(const GLContextRef & inCtx);
+
+		//!	Loads a program made from the passed sources from the cache.  Returns the name of the linked program, or 0 if the cache doesn't have it (or the driver rejected it).  The passed context must be current.
+		static uint32_t Load(const GLContextRef & inCtx, const std::string & inVS, const std::string & inGS, const std::string & inFS);
+		//!	Call this before linking a program that will be passed to Store()- some drivers only keep a program's binary if they're asked to before it's linked.  The passed context must be current.
+		static void PrepareToLink(const GLContextRef & inCtx, const uint32_t & inProgram);
+		//!	Saves the passed program, which was linked from the passed sources, to the cache.  'inCompileSeconds' is how long it took to compile and link (used to estimate the time the cache saves).  The passed context must be current.
+		static void Store(const GLContextRef & inCtx, const std::string & inVS, const std::string & inGS, const std::string & inFS, const uint32_t & inProgram, const double & inCompileSeconds);
+
+		//!	Returns the cache's stats.
+		static Stats GetStats();
+		//!	Returns the cache's stats, and resets them.
+		static Stats SnapshotAndResetStats();
+};
+
+
+
+
+}
+
+
+#endif /* VVGL_GLProgramBinaryCache_hpp */
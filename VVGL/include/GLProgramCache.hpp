@@ -0,0 +1,108 @@
+#ifndef VVGL_GLProgramCache_hpp
+#define VVGL_GLProgramCache_hpp
+
+#include "VVGL_Defines.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <iostream>
+
+#include "VVGL_Base.hpp"
+#include "GLProgramReflection.hpp"
+
+
+
+
+namespace VVGL
+{
+
+
+
+
+//! Shares linked GLSL programs between the GLScenes in a sharegroup, so scenes with identical shaders only compile and link them once.
+/*!
+\ingroup VVGL_MISC
+Programs are shared by every context in a sharegroup, so there's no need for ten scenes that render the same shaders to compile and link ten copies of the same program.  Scenes that have been told to share their program (GLScene::setSharesProgram()) look for a program in this cache before they compile anything: programs are keyed by a hash of their vertex/geometry/fragment source and the GL version of the context, and a program is only shared with scenes whose contexts are in the same sharegroup as the context that linked it.  Programs are reference-counted- a program is deleted when the last scene that uses it releases it.
+
+Notes on use:
+- The values of a program's uniforms are part of the program, so scenes that share a program overwrite each other's uniforms.  Every scene that uses a shared program records itself as its last user (Program::claim()), and when a scene finds that another scene used the program since it last rendered, it forgets which values it already pushed (see GLScene::_sharedProgramUsedElsewhere()) and pushes them all again.
+- This only works if scenes that share a program don't render at the same time on different threads- their uniform values would be mixed.  ISFScenes that upload their inputs through a uniform buffer (ISFScene::setInputsInUniformBuffer()) keep most of their values out of the program, but their samplers and any uniforms outside the block are still shared.
+- Scenes with a pre-link callback never share their program, because the callback may configure the program in ways the cache can't know about.
+- Programs are only shared between contexts that GLContext::sameShareGroupAs() reports are in the same sharegroup (or between scenes that use the same GLContext instance).
+*/
+class VVGL_EXPORT GLProgramCache	{
+	public:
+		//!	A snapshot of how well the cache is doing.  Returned by GetStats() and SnapshotAndResetStats().
+		struct Stats	{
+			//!	The number of times a scene found the program it needed in the cache (each hit is a compile and link that didn't happen).
+			uint64_t		hits = 0;
+			//!	The number of times a scene looked for a program that wasn't in the cache (and had to compile and link it).
+			uint64_t		misses = 0;
+			//!	The number of programs in the cache.  Not reset by SnapshotAndResetStats().
+			uint64_t		programs = 0;
+			//!	The number of scenes using the programs in the cache.  Not reset by SnapshotAndResetStats().
+			uint64_t		users = 0;
+
+			std::string getDescriptionString() const;
+			friend std::ostream & operator<<(std::ostream & os, const Stats & n) { os << n.getDescriptionString(); return os; }
+		};
+
+		//!	A linked program in the cache, and the shaders and sources it was made from.  Owned by the cache- scenes get them from Acquire() or Add(), and give them back with Release().
+		class VVGL_EXPORT Program	{
+			public:
+				Program(const uint64_t & inHash, const GLContextRef & inCtx, const std::string & inVS, const std::string & inGS, const std::string & inFS);
+				Program(const Program &) = delete;
+				Program & operator=(const Program &) = delete;
+
+				//!	The name of the linked program.
+				inline uint32_t program() const { return _program; }
+				//!	A description of the program's active uniforms and attributes.
+				inline const GLProgramReflectionRef & reflection() const { return _reflection; }
+				//!	The hash of the program's sources and GL version (see HashSources()).
+				inline uint64_t hash() const { return _hash; }
+				//!	Records the passed user (a scene) as the last user of the program- returns true if somebody else used the program since the passed user last did, which means the program's uniforms may no longer have the values the passed user pushed.
+				inline bool claim(const void * inUser) { return (_lastUser.exchange(inUser) != inUser); }
+
+			private:
+				friend class GLProgramCache;
+				uint64_t			_hash = 0;
+				GLVersion			_version = GLVersion_Unknown;
+				GLContextRef		_ctx = nullptr;	//	the context the program was linked in- retained so its sharegroup can be compared to the contexts of other scenes
+				std::string			_vs;
+				std::string			_gs;
+				std::string			_fs;
+				uint32_t			_program = 0;
+				uint32_t			_shaders[3] = { 0, 0, 0 };	//	the vertex/geometry/fragment shaders attached to the program (0 if a shader wasn't used).  they're deleted with the program.
+				GLProgramReflectionRef	_reflection = nullptr;
+				size_t				_useCount = 0;	//	the number of scenes using the program- only changed while the cache is locked
+				std::atomic<const void*>	_lastUser { nullptr };
+		};
+		using ProgramRef = std::shared_ptr<Program>;
+
+	public:
+		//!	Returns a 64-bit FNV-1a hash of the passed bytes, continued from the passed hash (so several buffers can be hashed together).
+		static uint64_t HashBytes(const void * inBytes, const size_t & inLength, const uint64_t & inHash=0xcbf29ce484222325ULL);
+		//!	Returns a hash of the passed shader sources and GL version- programs are keyed by this in the cache.
+		static uint64_t HashSources(const std::string & inVS, const std::string & inGS, const std::string & inFS, const GLVersion & inVersion);
+
+		//!	Returns a program made from the passed sources in the sharegroup of the passed context, and counts the caller as one of its users- or null if the cache doesn't have one.
+		static ProgramRef Acquire(const GLContextRef & inCtx, const std::string & inVS, const std::string & inGS, const std::string & inFS);
+		//!	Adds a program that was linked successfully in the passed context to the cache, and counts the caller as its first user.  The cache takes ownership of the program, its reflection, and the shaders (pass 0 for shaders that weren't used).
+		static ProgramRef Add(const GLContextRef & inCtx, const std::string & inVS, const std::string & inGS, const std::string & inFS, const uint32_t & inProgram, const uint32_t & inVertShader, const uint32_t & inGeoShader, const uint32_t & inFragShader, const GLProgramReflectionRef & inReflection);
+		//!	Stops counting the caller as a user of the passed program.  When the last user releases a program it's removed from the cache and deleted, so a context in its sharegroup must be current.
+		static void Release(const ProgramRef & inProgram);
+
+		//!	Returns the cache's stats.
+		static Stats GetStats();
+		//!	Returns the cache's stats, and resets the hit/miss counts.
+		static Stats SnapshotAndResetStats();
+};
+
+
+
+
+}
+
+
+#endif /* VVGL_GLProgramCache_hpp */
@@ -0,0 +1,72 @@
+#ifndef VVGL_GLProgramReflection_hpp
+#define VVGL_GLProgramReflection_hpp
+
+#include "VVGL_Defines.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <iostream>
+
+
+
+
+namespace VVGL
+{
+
+
+
+
+//! Describes the active uniforms and attributes of a linked GLSL program, so their locations can be looked up without querying GL.
+/*!
+\ingroup VVGL_MISC
+A GLProgramReflection is made once per linked program: it enumerates the program's active uniforms (glGetActiveUniform) and attributes (glGetActiveAttrib), and stores their locations in hash maps.  GLScene makes one every time it links its program- get it with GLScene::programReflection(), and pass it to GLCachedProperty::cacheTheLoc() instead of the program.
+
+Notes on use:
+- Names that aren't active in the program (declared but unused, or not declared at all) have a location of -1, just like glGetUniformLocation().  So do the members of uniform blocks.
+- Uniform arrays are stored under both "name" and "name[0]".  Looking up another element ("name[3]") falls back to glGetUniformLocation(), so the program's context has to be current when you do that.
+*/
+class VVGL_EXPORT GLProgramReflection	{
+	private:
+		uint32_t		_program = 0;
+		size_t			_activeUniformCount = 0;
+		std::unordered_map<std::string,int32_t>		_uniforms;
+		std::unordered_map<std::string,int32_t>		_attribs;
+
+	public:
+		//!	Enumerates the active uniforms and attributes of the passed program.  The program must have been linked successfully, and a GL context in its sharegroup must be current.
+		GLProgramReflection(const uint32_t & inProgram);
+		GLProgramReflection(const GLProgramReflection &) = delete;
+		GLProgramReflection & operator=(const GLProgramReflection &) = delete;
+
+		//!	The program that was enumerated.
+		inline uint32_t program() const { return _program; }
+		//!	Returns the location of the uniform with the passed name, or -1 if the program doesn't have an active uniform with that name.
+		int32_t uniformLocation(const std::string & inName) const;
+		//!	Returns the location of the attribute with the passed name, or -1 if the program doesn't have an active attribute with that name.
+		int32_t attribLocation(const std::string & inName) const;
+		//!	The number of active uniforms (arrays count once).
+		inline size_t uniformCount() const { return _activeUniformCount; }
+		//!	The number of active attributes.
+		inline size_t attribCount() const { return _attribs.size(); }
+
+		std::string getDescriptionString() const;
+		friend std::ostream & operator<<(std::ostream & os, const GLProgramReflection & n) { os << n.getDescriptionString(); return os; }
+};
+
+
+
+
+/*!
+\brief A GLProgramReflectionRef is a shared pointer around a GLProgramReflection.
+\relates VVGL::GLProgramReflection
+*/
+using GLProgramReflectionRef = std::shared_ptr<GLProgramReflection>;
+
+
+
+
+}
+
+
+#endif /* VVGL_GLProgramReflection_hpp */
@@ -8,6 +8,7 @@
 #include <map>
 #include "GLBufferPool.hpp"
 #include "GLCachedProperty.hpp"
+#include "GLProgramCache.hpp"
 
 #if defined(VVGL_SDK_MAC)
 #import <TargetConditionals.h>
@@ -86,6 +87,8 @@ class VVGL_EXPORT GLScene	{
 		//	every time the scene renders, this lambda is executed.  drawing code goes here.
 		RenderCallback		_renderCallback = nullptr;
 		RenderCallback		_renderCleanupCallback = nullptr;
+		//	subclasses that install their own callbacks (which change bindings through GLStateCache) set this to true- if it's false, the context's state cache is invalidated after every callback runs.  the public callback setters reset it to false.
+		bool				_callbacksUseStateCache = false;
 		//	the render target contains the GL framebuffer and relevant attachments (render to texture/buffer/depth buffer/etc)
 		RenderTarget		_renderTarget;
 		
@@ -108,9 +111,12 @@ class VVGL_EXPORT GLScene	{
 		bool				_fsStringUpdated = false;
 		bool				_programReady = false;	//	set to 'true' only if all shaders compiled and the program was able to link successfully
 		uint32_t			_program = 0;	//	0, or the compiled program
+		GLProgramReflectionRef	_programReflection = nullptr;	//	null, or a description of the active uniforms/attributes of the compiled program (made every time it's linked)
 		uint32_t			_vs = 0;
 		uint32_t			_gs = 0;
 		uint32_t			_fs = 0;
+		bool				_sharesProgram = false;	//	if true, the program is looked up in (and added to) the GLProgramCache instead of being compiled by every scene that needs it
+		GLProgramCache::ProgramRef	_sharedProgram = nullptr;	//	non-null if '_program' belongs to the GLProgramCache (in which case '_vs'/'_gs'/'_fs' are 0- the shaders belong to the cache, too)
 		std::mutex			_errLock;
 		std::mutex			_errDictLock;
 		std::map<std::string,std::string>		_errDict;
@@ -234,10 +240,16 @@ class VVGL_EXPORT GLScene	{
 		virtual std::string fragmentShaderString();
 		//!	Gets the program ID.
 		inline uint32_t program() const { return _program; }
+		//!	Returns a description of the active uniforms and attributes of the program (or null if there's no program), which can be used to look up their locations without querying GL.  A new one is made every time the program is linked.
+		inline GLProgramReflectionRef programReflection() const { return _programReflection; }
 		//!	Returns whether or not the program was able to be compiled.  Please note that this value will only be populared after the program has been compiled/linked, which only occurs when a frame gets rendered.
 		inline bool programReady() const { return _programReady; }
 		//!	Under normal circumstances, the scene's shaders/program are only compiled/linked when a frame is rendered.  If compilation is required synchronously, this method can be used to compile/link the program (if necessary)
 		void compileProgramIfNecessary();
+		//!	Defaults to false.  If set to true, the scene gets its program from the GLProgramCache- scenes in the same sharegroup with identical shaders share one program, so only the first of them compiles and links it.  Scenes that share a program shouldn't render at the same time on different threads- see GLProgramCache for details.
+		void setSharesProgram(const bool & n);
+		//!	Returns true if the scene gets its program from the GLProgramCache.
+		inline bool sharesProgram() const { return _sharesProgram; }
 		
 		///@}
 		
@@ -263,6 +275,10 @@ class VVGL_EXPORT GLScene	{
 		virtual void _reshape();
 		//	assumed that _renderLock was obtained before calling.  assumed that context is non-null and has been set as current GL context before calling.
 		virtual void _renderCleanup();
+		//	called by _renderPrep() when the program is shared (see GLProgramCache) and another scene used it since this scene last did- the values of the program's uniforms are whatever that scene pushed, so subclasses that skip pushing values that haven't changed have to forget what they pushed.  assumed that _renderLock was obtained before calling.
+		virtual void _sharedProgramUsedElsewhere();
+		//	releases the program and shaders (or gives them back to the GLProgramCache if they're shared).  assumed that _renderLock was obtained before calling, and that a context in the program's sharegroup is current.
+		void _releaseProgram();
 };
 
 
@@ -0,0 +1,189 @@
+#ifndef VVGL_GLStateCache_hpp
+#define VVGL_GLStateCache_hpp
+
+#include "VVGL_Defines.hpp"
+
+#include <atomic>
+#include <string>
+#include <iostream>
+
+#include "VVGL_Base.hpp"
+
+
+
+
+namespace VVGL
+{
+
+
+
+
+//! Shadows the GL bindings VVGL changes most often, so redundant state changes can be skipped.
+/*!
+\ingroup VVGL_MISC
+Every GLContext owns a GLStateCache, which tracks the bound program, VAO, framebuffers, textures (per unit), active texture unit, viewport and clear color of that context.  VVGL changes these bindings through the static functions in this class- for example, GLStateCache::BindTexture() instead of glBindTexture()- and the call is skipped if the binding is already what was asked for.
+
+Skipping anything is only safe if nothing else has changed the context's bindings, so the cache only does this while a GLStateCache::Scope is open on the context:
+- Opening the outermost scope on a context forgets everything the cache knew, because anything may have happened to the context before VVGL started working with it.
+- Outside of a scope, every call is passed straight to GL (exactly as if the cache didn't exist).
+- While a scope is open, "release" calls (ReleaseProgram(), ReleaseFramebuffer(), etc) don't unbind anything.  The binding is restored to 0 when the outermost scope closes (or when something needs the default binding), so a series of passes that use the same program/VAO/framebuffer only binds them once.
+- GLScene opens a scope for every render, ISFScene opens one for all of its passes, and the copiers open one for each copy.  If you want bindings to carry over from one render to the next, open a scope that spans them (a frame, for example)- but if you make GL calls that change bindings while it's open, call invalidate() afterwards.
+- GLScene invalidates the cache after running callbacks that it didn't install itself, because they may have changed bindings.
+
+Notes on use:
+- Bindings are per-context, so each GLContext has its own cache- use GLContext::stateCache() to get it.  The static functions use the cache of the context that VVGL made current on the calling thread (if a scope is open on it).
+- GL objects that are deleted make the cache forget the objects it knew were bound (in every context), because their names may be reused.  If you delete textures/framebuffers/VAOs/programs yourself while a scope is open, call NoteDeletedObjects().
+*/
+class VVGL_EXPORT GLStateCache	{
+	public:
+		/*!
+		\brief A snapshot of how many state changes VVGL asked for, and how many of them were skipped because they were redundant.  Returned by getStats() and snapshotAndResetStats().
+		\details The counters accumulate from the last time they were reset- snapshot and reset them once per frame to see how many calls were elided per frame.
+		*/
+		struct Stats	{
+			//!	The number of state changes that were asked for while a scope was open.
+			uint64_t		requests = 0;
+			//!	The number of state changes that were skipped because they were redundant (or were releases deferred to the end of the scope).
+			uint64_t		elided = 0;
+			//!	The number of times the cache forgot what it knew (a scope was opened, a callback ran, GL objects were deleted, etc).
+			uint64_t		invalidations = 0;
+
+			std::string getDescriptionString() const;
+			friend std::ostream & operator<<(std::ostream & os, const Stats & n) { os << n.getDescriptionString(); return os; }
+		};
+
+		//!	While a Scope is open, redundant state changes in its context are skipped.  Scopes nest, and are opened and closed on the same thread.
+		class VVGL_EXPORT Scope	{
+			public:
+				//!	The passed context should be current when the scope is opened.
+				Scope(const GLContextRef & inCtx);
+				~Scope();
+				Scope(const Scope &) = delete;
+				Scope & operator=(const Scope &) = delete;
+			private:
+				friend class GLStateCache;
+				GLContextRef		_ctx = nullptr;	//	retained so the cache can't be freed while the scope's open
+				Scope				*_outerScope = nullptr;	//	the scope that was innermost on this thread when this one was opened
+		};
+
+	private:
+		//	the texture targets tracked by the cache, and the number of texture units tracked per target
+		enum TexTarget	{
+			TexTarget_2D = 0,
+			TexTarget_Rect,
+			TexTarget_Cube,
+			TexTarget_Count
+		};
+		static const uint32_t	MaxTexUnits = 32;
+		//	the value of a binding the cache doesn't know
+		static const uint32_t	Unknown = 0xFFFFFFFF;
+
+		//	the number of scopes that are open on this cache (scopes are only opened on the thread the context is current on)
+		uint32_t			_scopeDepth = 0;
+		//	the value of the global count of deleted objects the last time we checked it
+		uint64_t			_deletionCount = 0;
+
+		uint32_t			_program = Unknown;
+		uint32_t			_vertexArray = Unknown;
+		uint32_t			_readFramebuffer = Unknown;
+		uint32_t			_drawFramebuffer = Unknown;
+		uint32_t			_activeTexUnit = Unknown;	//	the index of the unit (0 for GL_TEXTURE0), not the GL enum
+		uint32_t			_textures[MaxTexUnits][TexTarget_Count];
+		bool				_viewportKnown = false;
+		int32_t				_viewport[4] = { 0, 0, 0, 0 };
+		bool				_clearColorKnown = false;
+		GLColor				_clearColor;
+
+		//	bindings that were released while a scope was open, and have to be restored to 0 when the outermost scope closes
+		bool				_programReleased = false;
+		bool				_vertexArrayReleased = false;
+		bool				_framebufferReleased = false;
+		uint32_t			_texturesReleased[TexTarget_Count] = { 0, 0, 0 };	//	bitmask of tex units, per target
+
+		//	only the thread the context is current on changes these, so they're bumped without a locked read-modify-write.  a snapshot taken on another thread may be a call or two off.
+		std::atomic<uint64_t>		_requests { 0 };
+		std::atomic<uint64_t>		_elided { 0 };
+		std::atomic<uint64_t>		_invalidations { 0 };
+
+	public:
+		GLStateCache();
+		GLStateCache(const GLStateCache &) = delete;
+		GLStateCache & operator=(const GLStateCache &) = delete;
+
+		//!	Makes the cache forget every binding it knows, so the next state change for each binding is passed to GL.  Call this if you change bindings in a context while a scope is open on it.  Releases that are waiting for the scope to close are kept.
+		void invalidate();
+		//!	Returns true if a scope is open on the cache.
+		inline bool inScope() const { return (_scopeDepth > 0); }
+
+		//!	Returns the cache's stats.
+		Stats getStats() const;
+		//!	Returns the cache's stats, and resets them.
+		Stats snapshotAndResetStats();
+
+		/*!
+		\name State changes
+		\brief VVGL makes state changes through these functions.  They apply to the cache of the context VVGL made current on the calling thread (if a scope is open on it)- otherwise they're passed straight to GL.
+		*/
+		///@{
+
+		static void UseProgram(const uint32_t & n);
+		//!	Unbinds the program- deferred until the outermost scope closes.
+		static void ReleaseProgram();
+		static void BindVertexArray(const uint32_t & n);
+		//!	Unbinds the VAO- deferred until the outermost scope closes.
+		static void ReleaseVertexArray();
+		//!	inTarget is GL_FRAMEBUFFER, GL_READ_FRAMEBUFFER or GL_DRAW_FRAMEBUFFER.
+		static void BindFramebuffer(const uint32_t & inTarget, const uint32_t & n);
+		//!	Binds framebuffer 0 to GL_FRAMEBUFFER- deferred until the outermost scope closes.
+		static void ReleaseFramebuffer();
+		//!	inUnit is a GL enum (GL_TEXTURE0, GL_TEXTURE1, etc), just like glActiveTexture().
+		static void ActiveTexture(const uint32_t & inUnit);
+		//!	Binds the texture to the active texture unit.
+		static void BindTexture(const uint32_t & inTarget, const uint32_t & n);
+		//!	Binds texture 0 to the passed target of the active texture unit- deferred until the outermost scope closes.
+		static void ReleaseTexture(const uint32_t & inTarget);
+		static void Viewport(const int32_t & inX, const int32_t & inY, const int32_t & inWidth, const int32_t & inHeight);
+		static void ClearColor(const GLColor & n);
+
+		//!	Restores the program to 0 now if it was released- used before drawing something that doesn't use a program.
+		static void FlushReleasedProgram();
+		//!	Restores the framebuffer to 0 now if it was released- used before drawing into whatever framebuffer the caller had bound.
+		static void FlushReleasedFramebuffer();
+		//!	Restores every binding that was released to 0 now- used before running code that doesn't go through the cache.
+		static void FlushReleases();
+
+		//!	Makes every cache forget the objects it knows are bound.  Call this after deleting textures, framebuffers, VAOs or programs.
+		static void NoteDeletedObjects();
+
+		///@}
+
+	private:
+		//	returns the cache of the context that VVGL made current on this thread, if a scope is open on it (null otherwise)
+		static GLStateCache * _Current();
+		//	forgets the objects that are bound (not the viewport, clear color, or active tex unit) if any GL objects were deleted since we last checked
+		inline void _checkForDeletions();
+		void _forgetObjects();
+		inline void _countRequest() { _requests.store(_requests.load(std::memory_order_relaxed)+1, std::memory_order_relaxed); }
+		inline void _countElided() { _elided.store(_elided.load(std::memory_order_relaxed)+1, std::memory_order_relaxed); }
+		//	returns the index of the passed texture target in _textures, or -1 if it isn't tracked
+		static int _IndexForTexTarget(const uint32_t & inTarget);
+		//	binds 0 to everything that was released
+		void _flushReleases();
+
+		void _useProgram(const uint32_t & n);
+		void _bindVertexArray(const uint32_t & n);
+		void _bindFramebuffer(const uint32_t & inTarget, const uint32_t & n);
+		void _activeTexture(const uint32_t & inUnit);
+		void _bindTexture(const uint32_t & inTarget, const uint32_t & n);
+		void _releaseTexture(const uint32_t & inTarget);
+		void _setViewport(const int32_t & inX, const int32_t & inY, const int32_t & inWidth, const int32_t & inHeight);
+		void _setClearColor(const GLColor & n);
+};
+
+
+
+
+}
+
+
+#endif /* VVGL_GLStateCache_hpp */
@@ -6,6 +6,8 @@
 
 #include <mutex>
 #include <queue>
+#include <deque>
+#include <functional>
 
 
 
@@ -22,10 +24,22 @@ namespace VVGL
 
 
 
+//!	The completion callback used by GLTexToCPUCopier::fencedStreamTexToCPU().
+/*!
+\relatedalso GLTexToCPUCopier
+The first param is the downloaded buffer- either the CPU buffer that was passed to fencedStreamTexToCPU() (populated with the contents of the texture) or a mapped PBO (access its pixels at its cpuBackingPtr ivar).  The second param is the texture that was downloaded.
+*/
+using GLTexToCPUCopierCallback = std::function<void(const GLBufferRef & inDownloadedBuffer, const GLBufferRef & inTexBuffer)>;
+
+
+
+
 //!	Downloads texture-based GLBuffers (Type_Tex) to CPU memory.
 /*!
 \ingroup VVGL_BASIC
 Offers both immediate download and n-buffered texture downloads for double-/triple-/n-buffering/ping-ponging.  Uses PBOs for async DMA.
+
+There are two ways to stream textures: streamTexToCPU() uses a fixed-size queue, and returns the oldest download every time it's called (mapping it whether or not the GPU has finished with it).  fencedStreamTexToCPU() puts a fence behind every download and hands completed downloads to a callback as soon as the GPU has finished with them, so the calling thread never waits on a transfer that's still in flight.
 */
 
 class VVGL_EXPORT GLTexToCPUCopier	{
@@ -40,10 +54,32 @@ class VVGL_EXPORT GLTexToCPUCopier	{
 		
 		GLBufferPoolRef			_privatePool = nullptr;	//	by default this is null and the scene will try to use the global buffer pool to create interim resources (temp/persistent buffers).  if non-null, the scene will use this pool to create interim resources.
 		
+		//	a download started by fencedStreamTexToCPU()- the fence is checked to see if the GPU has finished with the download before the PBO is mapped
+		struct FencedDownload	{
+			GLBufferRef			cpu = nullptr;
+			GLBufferRef			pbo = nullptr;
+			GLBufferRef			tex = nullptr;
+			GLBufferRef			fbo = nullptr;
+			GLsync				fence = nullptr;
+			Timestamp			submitTime;
+			GLTexToCPUCopierCallback		callback = nullptr;
+		};
+		std::deque<FencedDownload>		_fencedQueue;	//	downloads in flight, oldest first
+		int						_fencedQueueDepth = 2;	//	the max number of downloads in flight before fencedStreamTexToCPU() waits for the oldest one.  adapts to the measured GPU latency.
+		int						_maxFencedQueueDepth = 8;	//	the upper bound for _fencedQueueDepth
+		double					_avgFenceLatency = 0.;	//	moving avg of the time (in seconds) between starting a download and seeing that its fence was signaled
+		double					_avgSubmitInterval = 0.;	//	moving avg of the time (in seconds) between calls to fencedStreamTexToCPU()
+		Timestamp				_lastSubmitTime;
+		bool					_hasSubmitted = false;
+		
 	private:
 		//	before calling either of these functions, _queueLock should be locked and a GL context needs to be made current on this thread.
 		void _beginProcessing(const GLBufferRef & inCPUBuffer, const GLBufferRef & inPBOBuffer, const GLBufferRef & inTexBuffer, const GLBufferRef & inFBOBuffer);
 		void _finishProcessing(const GLBufferRef & inCPUBuffer, const GLBufferRef & inPBOBuffer, const GLBufferRef & inTexBuffer, const GLBufferRef & inFBOBuffer);
+		//	creates a PBO to download the passed texture into, or returns null if the texture's pixel format isn't supported.  _queueLock should be locked.
+		GLBufferRef _createPBOForTex(const GLBufferRef & inTexBuffer, const bool & createInCurrentContext, const GLBufferPoolRef & inPool);
+		//	finishes every fenced download (in order) whose fence has been signaled and fires its callback, returns the number of downloads finished.  if 'inWaitCount' is > 0, blocks until at least that many downloads have finished.  _queueLock should be locked and a GL context needs to be made current on this thread.
+		int _finishFencedDownloads(const int & inWaitCount);
 	
 	public:
 		GLTexToCPUCopier();
@@ -74,6 +110,32 @@ class VVGL_EXPORT GLTexToCPUCopier	{
 		*/
 		GLBufferRef streamTexToCPU(const GLBufferRef & inTexBuffer, const GLBufferRef & inCPUBuffer=nullptr, const bool & createInCurrentContext=false);
 		
+		//!	Begins downloading the passed texture-based buffer to CPU memory, and calls the passed callback with the downloaded buffer as soon as the GPU has finished the transfer.
+		/*!
+		\param inTexBuffer This must be a texture-based GLBuffer.  This may not be null.
+		\param inCallback Called with the downloaded buffer (and the texture that was downloaded) once the download is complete.  Downloads complete in the order they were started.  Callbacks are executed on the thread that calls fencedStreamTexToCPU(), pollFencedStream(), or finishFencedStream(), with the copier's lock held and a GL context current- they shouldn't block for long.
+		\param inCPUBuffer May be null (null by default).  If null, the callback is passed a mapped PBO.  If non-null, the callback is passed this buffer after it's populated with the contents of the texture.
+		\details Every download is followed by a fence, which is checked with a zero timeout every time this (or pollFencedStream()) is called- completed downloads are mapped and handed to their callbacks immediately, downloads still in flight are left alone.  The number of downloads allowed in flight adapts to the measured GPU latency (up to 'maxFencedQueueDepth()')- if the GPU falls further behind than that, this waits for the oldest download to complete.  If the copier's GL context doesn't support fences (GL versions before 3.2), the download is performed immediately and the callback is executed before this returns.
+		\return Returns false if the download couldn't be started (the texture is null, or the FBO/PBO couldn't be created)- the callback will never be executed for it.
+		*/
+		bool fencedStreamTexToCPU(const GLBufferRef & inTexBuffer, const GLTexToCPUCopierCallback & inCallback, const GLBufferRef & inCPUBuffer=nullptr, const bool & createInCurrentContext=false);
+		//!	Checks the fences of the downloads started by fencedStreamTexToCPU() without blocking, and executes the callbacks of any that have completed.  Returns the number of downloads that completed.
+		int pollFencedStream(const bool & createInCurrentContext=false);
+		//!	Blocks until every download started by fencedStreamTexToCPU() has completed, executing their callbacks.
+		void finishFencedStream(const bool & createInCurrentContext=false);
+		//!	Returns the number of downloads started by fencedStreamTexToCPU() that haven't completed yet.
+		inline int fencedStreamCount() { std::lock_guard<std::recursive_mutex> lock(_queueLock); return static_cast<int>(_fencedQueue.size()); }
+		//!	Sets the max number of downloads fencedStreamTexToCPU() may have in flight before it waits for the oldest one to complete.  Defaults to 8.
+		void setMaxFencedQueueDepth(const int & n);
+		//!	Returns the max number of downloads fencedStreamTexToCPU() may have in flight.
+		inline int maxFencedQueueDepth() { std::lock_guard<std::recursive_mutex> lock(_queueLock); return _maxFencedQueueDepth; }
+		//!	Returns the number of downloads fencedStreamTexToCPU() currently allows in flight, which is derived from the measured GPU latency.
+		inline int fencedQueueDepth() { std::lock_guard<std::recursive_mutex> lock(_queueLock); return _fencedQueueDepth; }
+		//!	Returns the average time (in seconds) between the start of a fenced download and its completion.
+		inline double fencedLatency() { std::lock_guard<std::recursive_mutex> lock(_queueLock); return _avgFenceLatency; }
+		//!	Returns true if the receiver's GL context supports fences (required for fencedStreamTexToCPU() to be asynchronous).
+		bool fencesAvailable();
+		
 		//!	Sets the receiver's private buffer pool (which should default to null).  If non-null, this buffer pool will be used to generate any GL resources required by this scene.  Handy if you have a variety of GL contexts that aren't shared and you have to switch between them rapidly on a per-frame basis.
 		void setPrivatePool(const GLBufferPoolRef & n) { _privatePool=n; }
 		//!	Gets the receiver's private buffer pool- null by default, only non-null if something called setPrivatePool().
@@ -22,6 +22,8 @@ namespace VVGL
 /*!
 \ingroup VVGL_BASIC
 This object copies the image data in a GLBuffer by drawing it while another GLBuffer is bound as the render target.  This performs GL rendering- GLTexToTexCopier is a subclass of GLScene, so it has a GL context it can use.  If you require GLTexToTexCopier to use an existing GLContext to draw, use the constructor that accepts a GLContextRef (much like the GLScene constructor with the same signature)
+
+If the context is GL 3.3+, copies skip the shader and the draw call where they can: textures that are the same size and format are copied with glCopyImageSubData() (if the context supports it), other copies between color-renderable textures are performed with glBlitFramebuffer(), and textures are filled with solid colors using glClearTexImage() or glClear().  Drawing is the fallback for everything else (GL 2/ES contexts, compressed/depth/YCbCr textures, etc).
 */
 class VVGL_EXPORT GLTexToTexCopier : public GLScene	{
 	private:
@@ -45,6 +47,10 @@ class VVGL_EXPORT GLTexToTexCopier : public GLScene	{
 		GLCachedUni		_inputImageRectLoc = GLCachedUni("inputImageRect");	//	address of the uniform loc we pass RECT texture IDs to
 		GLCachedUni		_isRectTexLoc = GLCachedUni("isRectTex");	//	address of the uniform we use to indicate whether the program should sample the 2D or RECT texture
 		
+		bool			_fastPathsEnabled = true;	//	if false, every copy/fill is drawn
+		GLBufferRef		_readFBO = nullptr;	//	created in (and only used with) my context- the source texture is attached to this when blitting
+		GLBufferRef		_drawFBO = nullptr;	//	created in (and only used with) my context- the destination texture is attached to this when blitting/clearing
+		
 	public:
 		//!	Creates a new OpenGL context that shares the global buffer pool's context, uses that to create a new GLTexToTexCopier instance
 		GLTexToTexCopier();
@@ -71,6 +77,10 @@ class VVGL_EXPORT GLTexToTexCopier : public GLScene	{
 		void setCopySizingMode(const SizingMode & n);
 		//!	Gets the copy sizing mode.
 		SizingMode copySizingMode();
+		//!	Enables/disables the copy/blit/clear fast paths (they're enabled by default).  Disabling them is only useful for debugging and benchmarking- every copy will be drawn.
+		void setFastPathsEnabled(const bool & n);
+		//!	Gets whether or not the copy/blit/clear fast paths are enabled.
+		bool fastPathsEnabled();
 		
 		//!	Returns a new GLBuffer which was made by rendering the passed buffer into a new texture of matching dimensions.
 		GLBufferRef copyToNewBuffer(const GLBufferRef & n);
@@ -95,6 +105,10 @@ class VVGL_EXPORT GLTexToTexCopier : public GLScene	{
 	private:
 		//	acquire '_renderLock' and set current context before calling
 		void _drawBuffer(const GLBufferRef & inBufferRef, const Quad<VertXYZST> & inVertexStruct);
+		//	copies the srcRect of 'a' into 'inDstRect' of 'b' without drawing (clearing the rest of 'b' if the scene performs a clear).  returns false (and does nothing) if the buffers/context can't use a fast path.  acquire '_renderLock' and set current context before calling.
+		bool _fastCopy(const GLBufferRef & a, const GLBufferRef & b, const Rect & inDstRect);
+		//	fills 'n' with the passed color without drawing.  returns false (and does nothing) if the buffer/context can't use a fast path.  acquire '_renderLock' and set current context before calling.
+		bool _fastClear(const GLBufferRef & n, const GLColor & inColor);
 };
 
 
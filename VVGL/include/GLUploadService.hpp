@@ -0,0 +1,213 @@
+#ifndef VVGL_GLUploadService_hpp
+#define VVGL_GLUploadService_hpp
+
+#include "VVGL_Defines.hpp"
+#include "GLBufferPool.hpp"
+#include "GLCPUToTexCopier.hpp"
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <map>
+#include <vector>
+#include <atomic>
+#include <functional>
+
+
+
+
+//	none of this stuff should be available if we're running ES
+#if !defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
+
+
+
+
+namespace VVGL
+{
+
+
+
+
+class GLUploadFence;
+class GLUploadService;
+//!	A GLUploadFenceRef is a shared pointer around a GLUploadFence.
+using GLUploadFenceRef = std::shared_ptr<GLUploadFence>;
+//!	A GLUploadServiceRef is a shared pointer around a GLUploadService.
+using GLUploadServiceRef = std::shared_ptr<GLUploadService>;
+
+
+
+
+//!	A fence placed behind an upload performed by GLUploadService.
+/*!
+\ingroup VVGL_BASIC
+The fence is signaled when the GPU has finished uploading the texture.  Before you sample the texture in another context, call waitGPU() in that context- the GPU waits for the upload to finish, but the calling thread doesn't.  The sync object is deleted by the upload service's thread when the fence is freed, so fences can be freed on any thread.  Free your fences before you free the upload service- the sync object of a fence that outlives its service is leaked.
+*/
+class VVGL_EXPORT GLUploadFence	{
+	public:
+		//	sync objects that are no longer needed, deleted by the upload thread that created them (GL calls need a current context, and fences may be freed on any thread)
+		struct Graveyard	{
+			std::mutex					lock;
+			std::vector<GLsync>			syncs;
+			bool						closed = false;	//	set when the upload thread exits- nobody will delete syncs added after that
+		};
+
+	private:
+		GLsync						_sync = nullptr;
+		std::shared_ptr<Graveyard>	_graveyard = nullptr;
+		std::atomic<bool>			_signaled { false };
+
+	public:
+		GLUploadFence(GLsync inSync, const std::shared_ptr<Graveyard> & inGraveyard) : _sync(inSync), _graveyard(inGraveyard) {}
+		GLUploadFence(const GLUploadFence &) = delete;
+		GLUploadFence & operator=(const GLUploadFence &) = delete;
+		~GLUploadFence();
+
+		//!	Makes the GPU wait (in the GL context that is current on the calling thread) until the upload has finished.  Returns immediately- call this before you draw with the texture.
+		void waitGPU();
+		//!	Blocks the calling thread until the upload has finished or the timeout expires.  A GL context must be current on the calling thread.  Returns true if the upload has finished.
+		bool waitCPU(const uint64_t & inTimeoutNanos);
+		//!	Returns true if the upload has finished- doesn't block.  A GL context must be current on the calling thread.
+		bool isSignaled();
+};
+
+
+
+
+//!	A texture uploaded by GLUploadService.
+/*!
+\ingroup VVGL_BASIC
+*/
+struct GLUploadedTex	{
+	//!	The texture the CPU buffer was uploaded to.  Null if nothing has been uploaded.
+	GLBufferRef			tex = nullptr;
+	//!	The CPU buffer that was uploaded.
+	GLBufferRef			cpu = nullptr;
+	//!	The fence behind the upload- call its waitGPU() method in your context before you sample 'tex'.
+	GLUploadFenceRef	fence = nullptr;
+	//!	The index of the source the CPU buffer was submitted for.
+	int					sourceIndex = -1;
+};
+
+
+//!	The callback executed by GLUploadService when it's uploaded a buffer.  Executed on the upload thread.
+/*!
+\relatedalso GLUploadService
+*/
+using GLUploadServiceCallback = std::function<void(const GLUploadedTex & inUpload)>;
+
+
+
+
+//!	Uploads CPU-based GLBuffers to textures on a dedicated thread.
+/*!
+\ingroup VVGL_BASIC
+GLUploadService owns a thread and a GL context that shares the buffer pool's context.  Any thread can submit() a CPU buffer- submit() queues the buffer and returns immediately, it never waits for GL.  The upload thread uploads it (with a GLCPUToTexCopier), places a fence behind the upload, and hands the texture and fence back to you- via a callback, and via latestUpload().
+
+Notes on use:
+- Every buffer is submitted for a "source" (a camera, a decoder, etc, identified by an int you choose).  Each source has at most one buffer waiting to be uploaded- if a source submits a buffer before its last one was uploaded, the last one is dropped, so a slow upload never builds up a backlog.  latestUpload() returns the newest upload for a source.
+- The texture is handed back as soon as the upload has been submitted to the GPU- it may not have finished yet.  Call waitGPU() on the fence in your render context before you sample the texture, which makes the GPU (but not your thread) wait for the upload.
+- On Qt, the service has to be created on the thread that owns the buffer pool's context (usually the GUI thread).
+*/
+class VVGL_EXPORT GLUploadService	{
+	private:
+		struct UploadJob	{
+			int							sourceIndex = -1;
+			GLBufferRef					cpu = nullptr;
+			GLBufferRef					tex = nullptr;
+			GLUploadServiceCallback		callback = nullptr;
+		};
+
+		GLBufferPoolRef				_pool = nullptr;
+		GLContextRef				_ctx = nullptr;	//	the context used by the upload thread (created by the upload thread, unless one was passed to the constructor)
+		GLCPUToTexCopierRef			_copier = nullptr;	//	only used on the upload thread
+		std::shared_ptr<GLUploadFence::Graveyard>	_graveyard = std::make_shared<GLUploadFence::Graveyard>();
+		std::thread					_thread;
+#if defined(VVGL_SDK_QT)
+		QThread						*_ctxHomeThread = nullptr;	//	the thread the context was created on- it's moved to the upload thread while the thread runs, and moved back before the thread exits
+#endif
+
+		std::mutex					_lock;	//	serializes access to all of the vars below
+		std::condition_variable		_condition;	//	signaled when a job is submitted, when a job finishes, and when the thread should exit
+		std::deque<int>				_jobOrder;	//	the sources that have jobs waiting to be uploaded, in the order they were submitted
+		std::map<int,UploadJob>		_jobs;	//	key is the source index, value is the job waiting to be uploaded for that source
+		std::map<int,GLUploadedTex>		_latestUploads;	//	key is the source index, value is the newest upload for that source
+		bool						_busy = false;	//	true while the upload thread is uploading
+		bool						_quit = false;
+		uint64_t					_uploadCount = 0;
+		uint64_t					_dropCount = 0;
+
+	public:
+		//!	Creates the service and its thread.  Textures are created from the passed pool.
+		/*!
+		\param inPool The pool textures are created from.
+		\param inCtx The context the upload thread uses- it must share the pool's context, and it mustn't be used by any other thread.  It mustn't be current on any thread when you pass it.  If null, the upload thread creates one with the pool context's newContextSharingMe().  On GLFW newContextSharingMe() wraps the same window (which can only be current on one thread at a time), so you should pass a context created from a hidden window that shares the pool's window.
+		*/
+		GLUploadService(const GLBufferPoolRef & inPool=GetGlobalBufferPool(), const GLContextRef & inCtx=nullptr);
+		GLUploadService(const GLUploadService &) = delete;
+		GLUploadService & operator=(const GLUploadService &) = delete;
+		//!	Stops the upload thread- jobs that haven't been uploaded yet are discarded.
+		~GLUploadService();
+
+		//!	Queues the passed CPU buffer to be uploaded, returns immediately.  Thread-safe.
+		/*!
+		\param inSourceIndex Identifies the source of the buffer.  If this source already has a buffer waiting to be uploaded, that buffer is dropped.
+		\param inCPUBuffer The CPU-based buffer to upload.  Buffers vended by GLCPUToTexCopier::createRingCPUBuffer() don't work here- they belong to a different copier.
+		\param inCallback Optional.  Executed on the upload thread when the upload has been submitted to the GPU.
+		\param inTexBuffer Optional.  The texture to upload the buffer to- if null, a texture of the appropriate format is created.  Does not check the format or dimensions of the passed texture- make sure it's correct before submitting it!
+		\return Returns false if the buffer couldn't be queued (it was null, or the service is shutting down).
+		*/
+		bool submit(const int & inSourceIndex, const GLBufferRef & inCPUBuffer, const GLUploadServiceCallback & inCallback=nullptr, const GLBufferRef & inTexBuffer=nullptr);
+		//!	Returns the newest upload for the passed source (its 'tex' is null if nothing has been uploaded for it yet).  Doesn't block.  Thread-safe.
+		GLUploadedTex latestUpload(const int & inSourceIndex);
+		//!	Forgets the newest upload for the passed source (and discards its pending job, if it has one).
+		void clearSource(const int & inSourceIndex);
+		//!	Blocks until every job that has been submitted has been uploaded.
+		void waitUntilIdle();
+
+		//!	The number of buffers that have been uploaded.
+		uint64_t uploadCount();
+		//!	The number of buffers that were dropped because a newer buffer was submitted for the same source before they were uploaded.
+		uint64_t dropCount();
+		//!	The number of sources with buffers waiting to be uploaded.
+		size_t pendingCount();
+		//!	The context used by the upload thread.
+		GLContextRef context() { return _ctx; }
+
+	private:
+		void _threadLoop();
+		//	uploads the job's buffer (a GL context must be current on this thread), returns the upload
+		GLUploadedTex _upload(const UploadJob & inJob);
+		//	deletes the sync objects of fences that have been freed (a GL context must be current on this thread).  if 'inClose' is true, the graveyard is closed at the same time, so fences freed later don't add to it.
+		void _emptyGraveyard(const bool & inClose=false);
+};
+
+
+
+
+/*!
+\relatedalso GLUploadService
+\brief Creates and returns a GLUploadService, which uses a new GL context that shares the context of the passed buffer pool.
+*/
+inline GLUploadServiceRef CreateGLUploadServiceRef(const GLBufferPoolRef & inPool=GetGlobalBufferPool()) { return std::make_shared<VVGL::GLUploadService>(inPool); }
+/*!
+\relatedalso GLUploadService
+\brief Creates and returns a GLUploadService whose thread uses the passed GL context (which must share the context of the passed buffer pool).
+*/
+inline GLUploadServiceRef CreateGLUploadServiceRefUsing(const GLContextRef & inCtx, const GLBufferPoolRef & inPool=GetGlobalBufferPool()) { return std::make_shared<VVGL::GLUploadService>(inPool, inCtx); }
+
+
+
+
+}
+
+
+
+
+#endif	//	!defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
+
+
+
+
+#endif /* VVGL_GLUploadService_hpp */
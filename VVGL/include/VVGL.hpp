@@ -17,8 +17,20 @@
 //	GLContext is a GL context- this class wraps up whatever the native object is for whatever platform you're compiling against, and presents a single standard interface across all platforms for the rest of VVGL/VVISF.  you can create a GLContext around an existing platform-specific OpenGL context, and you can also create new GL contexts.  explicit support for sharing of multiple contexts so resources can be shared.  you'll probably work almost exclusively with GLContextRef, which is a std::shared_ptr around a GLContext.
 #include "GLContext.hpp"
 #include "GLCachedProperty.hpp"
-
-
+//	GLStateCache shadows each context's bindings (program, VAO, framebuffers, textures, viewport, clear color) so redundant state changes can be skipped
+#include "GLStateCache.hpp"
+//	GLDebugLog captures the messages GL reports through KHR_debug in a lock-free log (error visibility without calling glGetError() after every GL call)
+#include "GLDebugLog.hpp"
+//	GLProgramReflection enumerates the active uniforms/attributes of a linked program once, so their locations can be looked up without querying GL
+#include "GLProgramReflection.hpp"
+//	GLProgramCache shares linked programs between scenes with identical shaders, so each program is only compiled and linked once per sharegroup
+#include "GLProgramCache.hpp"
+//	GLProgramBinaryCache saves linked programs to disk, so they can be loaded instead of compiled the next time they're needed
+#include "GLProgramBinaryCache.hpp"
+
+
+//	GLBuffer instances and the memory backing CPU-based buffers are allocated from slabs/arenas so steady-state buffer churn doesn't hit the system allocator
+#include "GLBufferAllocator.hpp"
 #include "GLBuffer.hpp"
 
 
@@ -36,6 +48,10 @@
 //	these classes use PBOs to implement efficient texture upload/downloads
 #include "GLCPUToTexCopier.hpp"
 #include "GLTexToCPUCopier.hpp"
+//	SIMD pixel conversion kernels (used by the copiers to convert pixels as they're copied into/out of PBOs)
+#include "VVGL_PixelConversion.hpp"
+//	GLUploadService uploads CPU-based GLBuffers to textures on a dedicated thread, and hands them back with a fence
+#include "GLUploadService.hpp"
 
 
 //	if we're compiling against the os x sdk then we've got some cocoa additions.  os x, not ios.
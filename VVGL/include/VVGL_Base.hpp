@@ -9,6 +9,9 @@
 #include "VVGL_Time.hpp"
 #include "VVGL_Range.hpp"
 #include "VVGL_StringUtils.hpp"
+#if defined(VVGL_DEBUG_SITES)
+#include "GLDebugLog.hpp"
+#endif
 
 /*!
 \file 
@@ -31,6 +34,7 @@ class GLContext;
 class GLScene;
 struct GLCachedAttrib;
 struct GLCachedUni;
+class GLProgramReflection;
 class GLTexToCPUCopier;
 class GLCPUToTexCopier;
 struct Timestamp;
@@ -165,6 +169,12 @@ struct GLColor	{
 		std::cout<<"\tglGetError() returned "<<__ASDFQWERZXCV__<<" ("<<humanReadable<<") in "<<__LINE__<<" of "<<__FILE__<<endl; \
 	} \
 }
+//	with VVGL_DEBUG_SITES, GLERRLOG doesn't call glGetError()- it marks its call site, so GLDebugLog can count the debug messages raised by the GL call in front of it
+#elif defined(VVGL_DEBUG_SITES)
+#define GLERRLOG { \
+	static VVGL::GLDebugLog::Site __vvglDebugSite(__FILE__, __LINE__); \
+	VVGL::GLDebugLog::MarkSite(&__vvglDebugSite); \
+}
 #else
 #define GLERRLOG
 #endif
@@ -13,6 +13,7 @@ developers need to define one of these during compilation:
 	VVGL_SDK_GLFW
 	VVGL_SDK_QT
 	VVGL_SDK_WIN
+	VVGL_SDK_EGL
 
 this header file defines a series of macros that describe the availability of various GL 
 environments based on the SDK as defined by the user.  these are the possible values- note that 
@@ -37,7 +38,7 @@ to block off function calls that won't compile/link against a given SDK's header
 
 
 //	throw an error with a human-readable explanation if no SDK has been defined yet
-#if !defined(VVGL_SDK_MAC) && !defined(VVGL_SDK_IOS) && !defined(VVGL_SDK_RPI) && !defined (VVGL_SDK_GLFW) && !defined(VVGL_SDK_QT) && !defined(VVGL_SDK_WIN)
+#if !defined(VVGL_SDK_MAC) && !defined(VVGL_SDK_IOS) && !defined(VVGL_SDK_RPI) && !defined (VVGL_SDK_GLFW) && !defined(VVGL_SDK_QT) && !defined(VVGL_SDK_WIN) && !defined(VVGL_SDK_EGL)
 static_assert(false, "ERR: No SDK defined (eg. VVGL_SDK_XXXX), see VVGL_Defines.hpp for more information.");
 #endif
 
@@ -60,6 +61,9 @@ static_assert(false, "ERR: No SDK defined (eg. VVGL_SDK_XXXX), see VVGL_Defines.
 #elif defined(VVGL_SDK_WIN)
 	#define VVGL_TARGETENV_GL2
 	#define VVGL_TARGETENV_GL3PLUS
+#elif defined(VVGL_SDK_EGL)
+	#define VVGL_TARGETENV_GL2
+	#define VVGL_TARGETENV_GL3PLUS
 #endif
 
 
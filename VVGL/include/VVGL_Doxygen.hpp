@@ -16,6 +16,7 @@
 	- VVGL::GLBuffer is a wrapper for an OpenGL buffer of some sort.  Most of the GLBuffers you'll encounter will be wrappers for GL textures that contain an image of some sort- but a GLBuffer can also be an FBO/VBO/EBO/etc.  When the GLBuffer is released, its underlying GL resources is either deleted or pooled- which is why most of the time you'll probably just work with #GLBufferRef and the GL resources will delete themselves.
 	- VVGL::GLBufferPool creates GLBuffers- it also pools many types of GLBuffers, which offers substantial performance improvements over creating/deleting textures repeatedly.  You'll probably create a single global buffer pool when setting up your app's GL environment, but there's no hard limit on the number of pools you can create (different pools for different GL environments in the same app, for example).
 	- VVGL::GLTexToTexCopier copies the contents of one GLBuffer into another GLBuffer.
+	- VVGL::GLUploadService uploads CPU-based GLBuffers to textures on a dedicated thread- any thread can submit buffers to it without waiting for GL.
 
 
 */
@@ -36,6 +37,15 @@ These functions create GLBuffer instances.  Note that these functions all requir
 
 
 
+//! GLBuffer reserve functions
+/*!
+\defgroup VVGL_BUFFERRESERVE VVGL- GLBuffer reserve functions
+These functions create GL resources ahead of time and put them in a GLBufferPool, so the GLBuffer create functions can recycle them instead of creating them while you're rendering.
+*/
+
+
+
+
 
 
 
@@ -81,6 +91,22 @@ Additionally, VVGL has a couple structs that can be used to populate OpenGL buff
 	- VVGL::Timestamp
 	- There are some basic geometric primitives defined in \ref VVGL_GEOM
 	- VVGL::GLCachedProperty, VVGL::GLCachedAttrib and VVGL::GLCachedUni
+	- VVGL::GLStateCache, which elides redundant GL state changes
+	- VVGL::GLDebugLog, which captures GL debug messages (KHR_debug) without calling glGetError()
+	- VVGL::GLProgramReflection, which describes the active uniforms and attributes of a linked program
+	- VVGL::GLProgramCache, which shares linked programs between scenes with identical shaders
+	- VVGL::GLProgramBinaryCache, which saves linked programs to disk so they don't have to be compiled again
+*/
+
+
+
+
+//! Functions that copy and convert pixels between CPU memory and mapped PBOs.
+/*!
+\defgroup VVGL_PIXELCONVERSION VVGL- Pixel conversion
+GLTexToCPUCopier and GLCPUToTexCopier use these to copy pixels into and out of mapped PBOs- if the CPU buffer and the PBO have different layouts (RGBA vs BGRA, 8-bit vs float, etc), the pixels are converted as they're copied instead of in a separate pass.
+	- VVGL::ConvertPixels() copies/converts an image, splitting large images across a small pool of worker threads.
+	- The row kernels it uses (SwizzleRGBA8(), Convert8ToFloat(), ConvertFloatTo8(), ConvertFloatToHalf(), ConvertUYVYToRGBA8(), etc) are also available on their own.  Each has SSE2/SSSE3/AVX2/F16C and NEON implementations chosen at runtime, as well as a scalar fallback.
 */
 
 
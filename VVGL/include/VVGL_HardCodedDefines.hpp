@@ -11,6 +11,7 @@
 //#define VVGL_SDK_GLFW
 //#define VVGL_SDK_QT
 //#define VVGL_SDK_WIN
+//#define VVGL_SDK_EGL
 
 
 
@@ -0,0 +1,123 @@
+#ifndef VVGL_PixelConversion_hpp
+#define VVGL_PixelConversion_hpp
+
+#include "VVGL_Defines.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "GLBuffer.hpp"
+
+
+
+
+namespace VVGL
+{
+
+
+
+
+//!	Describes the in-memory layout of a buffer's pixels for the pixel conversion functions.
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+enum PixelLayout	{
+	PixelLayout_Unknown = 0,	//!<	A layout the pixel conversion functions can't work with.
+	PixelLayout_RGBA8,	//!<	8 bits per component, RGBA byte order.
+	PixelLayout_BGRA8,	//!<	8 bits per component, BGRA byte order.
+	PixelLayout_RGBA32F,	//!<	32-bit float per component, RGBA order.
+	PixelLayout_BGRA32F,	//!<	32-bit float per component, BGRA order.
+	PixelLayout_RGBA16F,	//!<	16-bit (half) float per component, RGBA order.
+	PixelLayout_UYVY	//!<	8-bit 4:2:2 YCbCr, two pixels per four bytes (Cb Y0 Cr Y1).
+};
+
+
+//!	Returns the layout of the pixels described by the passed descriptor, or PixelLayout_Unknown if the pixel conversion functions can't work with it.
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT PixelLayout PixelLayoutForDescriptor(const GLBuffer::Descriptor & inDesc);
+//!	Returns the number of bytes per pixel of the passed layout (UYVY is 2 bytes per pixel).
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT size_t BytesPerPixelForLayout(const PixelLayout & inLayout);
+//!	Returns true if ConvertPixels() can convert pixels from 'inSrcLayout' to 'inDstLayout'.
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT bool CanConvertPixels(const PixelLayout & inSrcLayout, const PixelLayout & inDstLayout);
+
+
+//!	Copies (and converts, if the layouts differ) an image from one block of memory to another.
+/*!
+\ingroup VVGL_PIXELCONVERSION
+\param inSrc The first row of the source image.
+\param inSrcBytesPerRow The number of bytes between rows in the source image.
+\param inSrcLayout The layout of the source image's pixels.
+\param outDst The first row of the destination image.
+\param inDstBytesPerRow The number of bytes between rows in the destination image.
+\param inDstLayout The layout of the destination image's pixels.
+\param inWidth The number of pixels to convert in each row.
+\param inHeight The number of rows to convert.
+\return Returns false (and does nothing) if there's no conversion between the passed layouts.
+\details Rows are converted with SSE2/SSSE3/AVX2/F16C or NEON kernels where the CPU supports them (with scalar fallbacks).  Large images are split into bands of rows that are converted on a small pool of worker threads.  The source and destination must not overlap.
+*/
+VVGL_EXPORT bool ConvertPixels(const void * inSrc, const size_t & inSrcBytesPerRow, const PixelLayout & inSrcLayout, void * outDst, const size_t & inDstBytesPerRow, const PixelLayout & inDstLayout, const uint32_t & inWidth, const uint32_t & inHeight);
+
+
+//!	Swaps the R and B components of 'inPixelCount' 8-bit RGBA/BGRA pixels.  'inSrc' and 'outDst' may be the same.
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT void SwizzleRGBA8(const uint8_t * inSrc, uint8_t * outDst, const size_t & inPixelCount);
+//!	Swaps the R and B components of 'inPixelCount' 32-bit float RGBA/BGRA pixels.  'inSrc' and 'outDst' may be the same.
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT void SwizzleRGBA32F(const float * inSrc, float * outDst, const size_t & inPixelCount);
+//!	Converts 'inCount' 8-bit components to normalized floats (0-255 becomes 0.0-1.0).
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT void Convert8ToFloat(const uint8_t * inSrc, float * outDst, const size_t & inCount);
+//!	Converts 'inCount' normalized floats to 8-bit components (values are clamped to 0.0-1.0 and rounded).
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT void ConvertFloatTo8(const float * inSrc, uint8_t * outDst, const size_t & inCount);
+//!	Converts 'inCount' 32-bit floats to 16-bit (half) floats, rounding to nearest even.
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT void ConvertFloatToHalf(const float * inSrc, uint16_t * outDst, const size_t & inCount);
+//!	Converts 'inPixelCount' UYVY pixels to 8-bit RGBA, using BT.601 video-range coefficients (6-bit fixed point).  If 'inPixelCount' is odd, the last pixel is converted using the chroma of its pair, so the source must hold the whole last 4-byte macropixel (UYVY rows are padded to an even number of pixels).
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT void ConvertUYVYToRGBA8(const uint8_t * inSrc, uint8_t * outDst, const size_t & inPixelCount);
+
+
+//!	Returns the name of the instruction set the pixel conversion kernels are using ("AVX2", "SSSE3", "SSE2", "NEON", or "scalar").
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT const char * PixelConversionISA();
+//!	Enables/disables the SIMD pixel conversion kernels (they're enabled by default).  Disabling them is only useful for debugging and benchmarking.
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT void SetPixelConversionSIMDEnabled(const bool & n);
+//!	Sets the max number of threads (including the calling thread) ConvertPixels() may split a large image across.  Defaults to the number of hardware threads (max 8), 1 disables the worker threads.
+/*!
+\ingroup VVGL_PIXELCONVERSION
+*/
+VVGL_EXPORT void SetPixelConversionThreadCount(const unsigned int & n);
+
+
+
+
+}
+
+
+#endif /* VVGL_PixelConversion_hpp */
@@ -1,5 +1,6 @@
 #include "GLBuffer.hpp"
 #include "GLBufferPool.hpp"
+#include "GLBufferAllocator.hpp"
 
 #include <mutex>
 
@@ -95,6 +96,50 @@ uint32_t GLBuffer::Descriptor::bytesPerRowForWidth(const uint32_t & w) const	{
 uint32_t GLBuffer::Descriptor::backingLengthForSize(const Size & s) const	{
 	return bytesPerRowForWidth(static_cast<uint32_t>(round(s.width))) * static_cast<uint32_t>(round(s.height));
 }
+bool GLBuffer::Descriptor::isComparableForRecycling(const GLBuffer::Descriptor & n) const	{
+	//	if any of these things DON'T match, return false- the comparison failed
+	if ((this->type != n.type)	||
+	(this->cpuBackingType != n.cpuBackingType)	||
+	(this->gpuBackingType != n.gpuBackingType)	||
+	(this->target != n.target)	||
+	(this->internalFormat != n.internalFormat)	||
+	(this->pixelFormat != n.pixelFormat)	||
+	(this->pixelType != n.pixelType) ||
+	(this->texRangeFlag != n.texRangeFlag)	||
+	(this->texClientStorageFlag != n.texClientStorageFlag)	||
+	(this->msAmount != n.msAmount)	||
+	(this->immutableStorageFlag != n.immutableStorageFlag)
+	)	{
+		return false;
+	}
+	
+	//	...if i'm here, all of the above things matched
+	
+	//	if neither "wants" a local IOSurface, this is a match- return true
+	if (this->localSurfaceID==0 && n.localSurfaceID==0)
+		return true;
+	//	if both have a local IOSurface, this is a match- even if the local IOSurfaces aren't an exact match
+	if (this->localSurfaceID!=0 && n.localSurfaceID!=0)
+		return true;
+	
+	return true;
+}
+size_t GLBuffer::Descriptor::recyclingHash() const	{
+	//	only hash the properties that isComparableForRecycling() checks, or comparable descriptors could land in different buckets
+	size_t		returnMe = 17;
+	returnMe = returnMe * 31 + static_cast<size_t>(this->type);
+	returnMe = returnMe * 31 + static_cast<size_t>(this->cpuBackingType);
+	returnMe = returnMe * 31 + static_cast<size_t>(this->gpuBackingType);
+	returnMe = returnMe * 31 + static_cast<size_t>(this->target);
+	returnMe = returnMe * 31 + static_cast<size_t>(this->internalFormat);
+	returnMe = returnMe * 31 + static_cast<size_t>(this->pixelFormat);
+	returnMe = returnMe * 31 + static_cast<size_t>(this->pixelType);
+	returnMe = returnMe * 31 + ((this->texRangeFlag) ? 1 : 0);
+	returnMe = returnMe * 31 + ((this->texClientStorageFlag) ? 1 : 0);
+	returnMe = returnMe * 31 + static_cast<size_t>(this->msAmount);
+	returnMe = returnMe * 31 + ((this->immutableStorageFlag) ? 1 : 0);
+	return returnMe;
+}
 
 
 /*	========================================	*/
@@ -276,33 +321,7 @@ void GLBuffer::setRemoteSurfaceRef(const IOSurfaceRef & n)	{
 
 
 bool GLBuffer::isComparableForRecycling(const GLBuffer::Descriptor & n) const	{
-	//	if any of these things DON'T match, return false- the comparison failed
-	if ((desc.type != n.type)	||
-	//(this->backingID != n.backingID)	||
-	(desc.cpuBackingType != n.cpuBackingType)	||
-	(desc.gpuBackingType != n.gpuBackingType)	||
-	(desc.target != n.target)	||
-	(desc.internalFormat != n.internalFormat)	||
-	(desc.pixelFormat != n.pixelFormat)	||
-	(desc.pixelType != n.pixelType) ||
-	//(name != n.name) ||
-	(desc.texRangeFlag != n.texRangeFlag)	||
-	(desc.texClientStorageFlag != n.texClientStorageFlag)	||
-	(desc.msAmount != n.msAmount)
-	)	{
-		return false;
-	}
-	
-	//	...if i'm here, all of the above things matched
-	
-	//	if neither "wants" a local IOSurface, this is a match- return true
-	if (desc.localSurfaceID==0 && n.localSurfaceID==0)
-		return true;
-	//	if both have a local IOSurface, this is a match- even if the local IOSurfaces aren't an exact match
-	if (desc.localSurfaceID!=0 && n.localSurfaceID!=0)
-		return true;
-	
-	return true;
+	return desc.isComparableForRecycling(n);
 }
 uint32_t GLBuffer::backingLengthForSize(Size s) const	{
 	return desc.backingLengthForSize(s);
@@ -529,7 +548,7 @@ GLBufferRef GLBufferCopy(const GLBufferRef & n)	{
 	GLBuffer			*srcBuffer = n.get();
 	if (srcBuffer == nullptr)
 		return nullptr;
-	GLBufferRef		returnMe = make_shared<GLBuffer>(srcBuffer->parentBufferPool);
+	GLBufferRef		returnMe = MakeGLBufferRef(srcBuffer->parentBufferPool);
 	GLBuffer			*newBuffer = returnMe.get();
 	
 	//(*newBuffer).desc = (*srcBuffer).desc;
@@ -0,0 +1,283 @@
+#include "GLBufferAllocator.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <map>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+#if defined(VVGL_SDK_WIN)
+#include <malloc.h>
+#endif
+
+
+
+
+namespace VVGL
+{
+
+
+using namespace std;
+
+
+
+
+#pragma mark --------------------- GLSlab
+
+
+GLSlab::GLSlab(const size_t & inBlockSize)	{
+	//	every block has to be big enough to hold a free list entry, and a multiple of the max alignment so every block in a chunk is aligned
+	size_t		align = alignof(max_align_t);
+	_blockSize = max(inBlockSize, sizeof(FreeBlock));
+	_blockSize = ((_blockSize + align - 1) / align) * align;
+}
+void * GLSlab::allocate()	{
+	lock_guard<mutex>		lock(_lock);
+
+	//	if there aren't any free blocks, allocate another chunk and carve it up into blocks
+	if (_freeList == nullptr)	{
+		char			*chunk = static_cast<char*>(::operator new(_blockSize * kBlocksPerChunk));
+		_chunks.push_back(chunk);
+		for (size_t i=0; i<kBlocksPerChunk; ++i)	{
+			FreeBlock		*block = reinterpret_cast<FreeBlock*>(chunk + (i * _blockSize));
+			block->next = _freeList;
+			_freeList = block;
+		}
+	}
+
+	FreeBlock		*returnMe = _freeList;
+	_freeList = returnMe->next;
+	++_blocksInUse;
+	return returnMe;
+}
+void GLSlab::release(void * inBlock)	{
+	if (inBlock == nullptr)
+		return;
+	lock_guard<mutex>		lock(_lock);
+	FreeBlock		*block = static_cast<FreeBlock*>(inBlock);
+	block->next = _freeList;
+	_freeList = block;
+	--_blocksInUse;
+}
+size_t GLSlab::blocksInUse()	{
+	lock_guard<mutex>		lock(_lock);
+	return _blocksInUse;
+}
+size_t GLSlab::blocksAllocated()	{
+	lock_guard<mutex>		lock(_lock);
+	return _chunks.size() * kBlocksPerChunk;
+}
+
+
+GLSlab & GetGLSlab(const size_t & inBlockSize)	{
+	//	the slabs (and the map of them) are deliberately leaked- buffers can be freed during static destruction, so the slabs have to outlive everything else
+	static mutex				*slabsLock = new mutex;
+	static map<size_t,GLSlab*>	*slabs = new map<size_t,GLSlab*>;
+
+	//	types whose sizes round up to the same block size share a slab
+	size_t			align = alignof(max_align_t);
+	size_t			blockSize = ((inBlockSize + align - 1) / align) * align;
+
+	lock_guard<mutex>		lock(*slabsLock);
+	auto			it = slabs->find(blockSize);
+	if (it != slabs->end())
+		return *(it->second);
+	GLSlab			*returnMe = new GLSlab(blockSize);
+	(*slabs)[blockSize] = returnMe;
+	return *returnMe;
+}
+
+
+
+
+#pragma mark --------------------- GLCPUBackingArena
+
+
+namespace	{
+	//	every block allocated by the arena is preceded by one of these (padded out to GLCPUBackingArena::kAlignment bytes, so the pointer we vend is still aligned)
+	struct ArenaBlockHeader	{
+		size_t		sizeClass = 0;	//	the number of usable bytes in the block
+		size_t		rawLength = 0;	//	the number of bytes actually allocated (including the header)
+		bool		mapped = false;	//	true if the block was mmap'ed
+	};
+	static_assert(sizeof(ArenaBlockHeader) <= GLCPUBackingArena::kAlignment, "arena block header must fit in the alignment padding");
+
+	inline ArenaBlockHeader * HeaderForBlock(void * inPtr)	{
+		return reinterpret_cast<ArenaBlockHeader*>(static_cast<char*>(inPtr) - GLCPUBackingArena::kAlignment);
+	}
+
+	void * AllocRawArenaBlock(const size_t & inSizeClass, const bool & inTryHugePages)	{
+		size_t				rawLength = inSizeClass + GLCPUBackingArena::kAlignment;
+		void				*raw = nullptr;
+		bool				mapped = false;
+#if defined(__linux__)
+		if (inTryHugePages && rawLength >= GLCPUBackingArena::kHugePageSize)	{
+			rawLength = ((rawLength + GLCPUBackingArena::kHugePageSize - 1) / GLCPUBackingArena::kHugePageSize) * GLCPUBackingArena::kHugePageSize;
+			raw = mmap(nullptr, rawLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (raw == MAP_FAILED)	{
+				raw = nullptr;
+				rawLength = inSizeClass + GLCPUBackingArena::kAlignment;
+			}
+			else	{
+				mapped = true;
+#if defined(MADV_HUGEPAGE)
+				madvise(raw, rawLength, MADV_HUGEPAGE);
+#endif
+			}
+		}
+#else
+		(void)inTryHugePages;
+#endif
+		if (raw == nullptr)	{
+#if defined(VVGL_SDK_WIN)
+			raw = _aligned_malloc(rawLength, GLCPUBackingArena::kAlignment);
+#else
+			if (posix_memalign(&raw, GLCPUBackingArena::kAlignment, rawLength) != 0)
+				raw = nullptr;
+#endif
+		}
+		if (raw == nullptr)
+			return nullptr;
+
+		ArenaBlockHeader	*header = new (raw) ArenaBlockHeader();
+		header->sizeClass = inSizeClass;
+		header->rawLength = rawLength;
+		header->mapped = mapped;
+		return static_cast<char*>(raw) + GLCPUBackingArena::kAlignment;
+	}
+	void FreeRawArenaBlock(void * inPtr)	{
+		ArenaBlockHeader	*header = HeaderForBlock(inPtr);
+#if defined(__linux__)
+		if (header->mapped)	{
+			munmap(header, header->rawLength);
+			return;
+		}
+#endif
+#if defined(VVGL_SDK_WIN)
+		_aligned_free(header);
+#else
+		free(header);
+#endif
+	}
+}
+
+
+GLCPUBackingArena::~GLCPUBackingArena()	{
+	purge();
+}
+void * GLCPUBackingArena::allocate(const size_t & inLength)	{
+	size_t			sizeClass = sizeClassForLength(inLength);
+	bool			tryHugePages = false;
+	{
+		lock_guard<mutex>		lock(_lock);
+		auto			it = _freeBlocks.find(sizeClass);
+		if (it != _freeBlocks.end() && it->second.size() > 0)	{
+			void			*returnMe = it->second.back();
+			it->second.pop_back();
+			_cachedBytes -= sizeClass;
+			_bytesInUse += sizeClass;
+			return returnMe;
+		}
+		tryHugePages = _hugePagesEnabled;
+	}
+
+	//	nothing cached in this size class- allocate a new block (without the lock held)
+	void			*returnMe = AllocRawArenaBlock(sizeClass, tryHugePages);
+	if (returnMe != nullptr)	{
+		lock_guard<mutex>		lock(_lock);
+		_bytesInUse += sizeClass;
+	}
+	return returnMe;
+}
+void GLCPUBackingArena::release(void * inPtr)	{
+	if (inPtr == nullptr)
+		return;
+	size_t			sizeClass = HeaderForBlock(inPtr)->sizeClass;
+	{
+		lock_guard<mutex>		lock(_lock);
+		_bytesInUse -= sizeClass;
+		if (_cachedBytes + sizeClass <= _maxCachedBytes)	{
+			_freeBlocks[sizeClass].push_back(inPtr);
+			_cachedBytes += sizeClass;
+			return;
+		}
+	}
+	//	the cache is full- free the block
+	FreeRawArenaBlock(inPtr);
+}
+void GLCPUBackingArena::purge()	{
+	lock_guard<mutex>		lock(_lock);
+	trimTo(0);
+}
+size_t GLCPUBackingArena::sizeClassForLength(const size_t & inLength)	{
+	//	small blocks are rounded up to a power of two (min 64 bytes)
+	size_t			pot = kAlignment;
+	while (pot < inLength)
+		pot <<= 1;
+	if (pot <= 4096)
+		return pot;
+	//	larger blocks are rounded up to the nearest eighth of the next power of two, so there are four size classes between consecutive powers of two and no block wastes more than 20% of its memory (a block just over half a power of two is rounded up to five eighths of it)
+	size_t			step = pot / 8;
+	return ((inLength + step - 1) / step) * step;
+}
+void GLCPUBackingArena::setMaxCachedBytes(const size_t & n)	{
+	lock_guard<mutex>		lock(_lock);
+	_maxCachedBytes = n;
+	trimTo(_maxCachedBytes);
+}
+size_t GLCPUBackingArena::maxCachedBytes()	{
+	lock_guard<mutex>		lock(_lock);
+	return _maxCachedBytes;
+}
+void GLCPUBackingArena::setHugePagesEnabled(const bool & n)	{
+	lock_guard<mutex>		lock(_lock);
+	_hugePagesEnabled = n;
+}
+bool GLCPUBackingArena::hugePagesEnabled()	{
+	lock_guard<mutex>		lock(_lock);
+	return _hugePagesEnabled;
+}
+size_t GLCPUBackingArena::cachedBytes()	{
+	lock_guard<mutex>		lock(_lock);
+	return _cachedBytes;
+}
+size_t GLCPUBackingArena::bytesInUse()	{
+	lock_guard<mutex>		lock(_lock);
+	return _bytesInUse;
+}
+void GLCPUBackingArena::trimTo(const size_t & inMaxBytes)	{
+	if (_cachedBytes <= inMaxBytes)
+		return;
+	//	free the largest blocks first- they're the ones most likely to be replaced by blocks of different sizes anyway
+	vector<size_t>		sizeClasses;
+	sizeClasses.reserve(_freeBlocks.size());
+	for (const auto & it : _freeBlocks)
+		sizeClasses.push_back(it.first);
+	sort(sizeClasses.begin(), sizeClasses.end(), greater<size_t>());
+	for (const size_t & sizeClass : sizeClasses)	{
+		vector<void*>		&blocks = _freeBlocks[sizeClass];
+		while (blocks.size() > 0 && _cachedBytes > inMaxBytes)	{
+			FreeRawArenaBlock(blocks.back());
+			blocks.pop_back();
+			_cachedBytes -= sizeClass;
+		}
+		if (blocks.size() == 0)
+			_freeBlocks.erase(sizeClass);
+		if (_cachedBytes <= inMaxBytes)
+			break;
+	}
+}
+
+
+GLCPUBackingArena & GetCPUBackingArena()	{
+	//	deliberately leaked- CPU buffers can be freed during static destruction, so the arena has to outlive everything else
+	static GLCPUBackingArena		*arena = new GLCPUBackingArena();
+	return *arena;
+}
+
+
+
+
+}
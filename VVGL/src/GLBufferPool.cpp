@@ -1,11 +1,18 @@
 #include "GLBufferPool.hpp"
 #include "GLBuffer.hpp"
 #include "GLTexToTexCopier.hpp"
+#include "GLBufferAllocator.hpp"
 
 #include "VVGL_Base.hpp"
 
 #include <set>
+#include <unordered_set>
 #include <algorithm>
+#include <iterator>
+#include <thread>
+#include <chrono>
+#include <sstream>
+#include <cmath>
 
 #if defined(VVGL_SDK_QT)
 #include <QImage>
@@ -33,6 +40,67 @@ using namespace std;
 //	this is the global buffer pool
 static GLBufferPoolRef _globalBufferPool = nullptr;
 static GLBufferPoolRef _nullGlobalBufferPool = nullptr;
+//	used to give every buffer pool a unique ID
+static atomic<uint64_t> _poolCount { 0 };
+
+
+//	works like lock_guard, but adds the amount of time the lock was held to the passed stats counter
+template <typename LockType>
+class TimedLockGuard	{
+	public:
+		TimedLockGuard(LockType & inLock, atomic<uint64_t> & inCounter) : _lock(inLock), _counter(inCounter)	{
+			_lock.lock();
+			_start = chrono::steady_clock::now();
+		}
+		~TimedLockGuard()	{
+			_counter.fetch_add(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - _start).count(), memory_order_relaxed);
+			_lock.unlock();
+		}
+		TimedLockGuard(const TimedLockGuard &) = delete;
+		TimedLockGuard & operator=(const TimedLockGuard &) = delete;
+	private:
+		LockType			&_lock;
+		atomic<uint64_t>	&_counter;
+		chrono::steady_clock::time_point	_start;
+};
+//	returns the sized internal format that should be used to create a texture with the passed descriptor using immutable storage, or 0 if the texture can't be created with immutable storage (immutable storage is core in GL 4.2 and GLES 3, older GL contexts may have ARB_texture_storage)
+static uint32_t ImmutableTexStorageFormat(const GLBuffer::Descriptor & inDesc)	{
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL) || defined(VVGL_TARGETENV_GLES3)
+#if !defined(VVGL_TARGETENV_GLES3)
+	//	GLEW leaves the function ptr null if the context doesn't support it
+	if (glTexStorage2D == nullptr)
+		return 0;
+#endif
+	if (inDesc.target != GLBuffer::Target_2D)
+		return 0;
+	switch (static_cast<uint32_t>(inDesc.internalFormat))	{
+	//	glTexStorage2D() requires a sized internal format
+	case GL_RGBA:		return GL_RGBA8;
+	case GL_RGB:		return GL_RGB8;
+	case GL_RED:		return GL_R8;
+	case GL_RGBA8:
+	case GL_RGB8:
+	case GL_R8:
+	case GL_RGBA16F:
+	case GL_RGBA32F:
+	case GL_DEPTH_COMPONENT16:
+	case GL_DEPTH_COMPONENT24:
+		return static_cast<uint32_t>(inDesc.internalFormat);
+	default:
+		break;
+	}
+	return 0;
+#else
+	(void)inDesc;
+	return 0;
+#endif
+}
+//	raises the passed peak to the passed value if it's higher
+static inline void RaisePeak(atomic<int64_t> & inPeak, const int64_t & inVal)	{
+	int64_t			tmpPeak = inPeak.load(memory_order_relaxed);
+	while (inVal > tmpPeak && !inPeak.compare_exchange_weak(tmpPeak, inVal, memory_order_relaxed))	{
+	}
+}
 
 
 
@@ -47,9 +115,9 @@ GLBufferPool::GLBufferPool(const GLContextRef & inCtx)	{
 	//_context = (inShareCtx==nullptr) ? new GLContext() : new GLContext(inShareCtx);
 	//_context = (inShareCtx==nullptr) ? CreateNewGLContextRef() : inShareCtx->newContextSharingMe();
 	_context = (inCtx==nullptr) ? CreateNewGLContextRef() : inCtx;
+	_poolID = ++_poolCount;
 	//cout << "\tcontext is " << *_context << endl;
 	//cout << "\tmy ctx is " << _context << endl;
-	_freeBuffers.reserve(50);
 	
 #if defined(VVGL_SDK_MAC) || defined(VVGL_SDK_IOS)
 	_colorSpace = CGColorSpaceCreateDeviceRGB();
@@ -58,6 +126,9 @@ GLBufferPool::GLBufferPool(const GLContextRef & inCtx)	{
 GLBufferPool::~GLBufferPool()	{
 	//cout << __PRETTY_FUNCTION__ << endl;
 	
+	//	delete any GL resources that are still waiting to be deleted
+	drainDeletions();
+	
 	lock_guard<recursive_mutex>		lock(_contextLock);
 	if (_context != nullptr)	{
 		//delete _context;
@@ -69,6 +140,188 @@ GLBufferPool::~GLBufferPool()	{
 }
 
 
+/*	========================================	*/
+#pragma mark --------------------- free buffer keys
+
+
+GLBufferPool::FreeBufferKey::FreeBufferKey(const GLBuffer::Descriptor & inDesc, const Size & inSize)	{
+	desc = inDesc;
+	//	FBOs are recycled regardless of size, everything else has to be an exact match
+	size = (inDesc.type==GLBuffer::Type_FBO) ? Size(0,0) : inSize;
+}
+size_t GLBufferPool::FreeBufferKeyHash::operator()(const FreeBufferKey & n) const	{
+	size_t		returnMe = n.desc.recyclingHash();
+	returnMe = returnMe * 31 + hash<double>()(n.size.width);
+	returnMe = returnMe * 31 + hash<double>()(n.size.height);
+	return returnMe;
+}
+
+
+/*	========================================	*/
+#pragma mark --------------------- thread caches
+
+
+struct GLBufferPool::ThreadCache	{
+	//	the owning thread is the only thread that touches the cache outside of housekeeping, so this spin lock is almost never contended
+	atomic<bool>		busy { false };
+	//	set when the owning thread exits- the next housekeeping pass drains the cache and discards it
+	atomic<bool>		orphaned { false };
+	unordered_map<FreeBufferKey,FreeBufferBucket,FreeBufferKeyHash>		buckets;
+	
+	inline void lock() { while (busy.exchange(true, memory_order_acquire)) { this_thread::yield(); } }
+	inline void unlock() { busy.store(false, memory_order_release); }
+};
+
+
+GLBufferPool::ThreadCacheRef GLBufferPool::currentThreadCache()	{
+	//	buffers may be freed by other thread-local destructors after the thread's list of caches has been destroyed- they go straight to the shared pool
+	static thread_local bool		threadExiting = false;
+	//	every thread keeps a list of its caches (one per pool it has used).  the list only holds weak refs, the caches are owned by their pools.
+	struct CacheList	{
+		vector<pair<uint64_t,weak_ptr<ThreadCache>>>		caches;
+		~CacheList()	{
+			threadExiting = true;
+			for (auto & cacheIt : caches)	{
+				ThreadCacheRef		tmpCache = cacheIt.second.lock();
+				if (tmpCache != nullptr)
+					tmpCache->orphaned = true;
+			}
+		}
+	};
+	if (threadExiting)
+		return nullptr;
+	static thread_local CacheList		cacheList;
+	
+	ThreadCacheRef		returnMe = nullptr;
+	for (auto it=cacheList.caches.begin(); it!=cacheList.caches.end(); )	{
+		if (it->first == _poolID)	{
+			returnMe = it->second.lock();
+			if (returnMe != nullptr)
+				break;
+		}
+		//	prune the caches of pools that have been deleted
+		if (it->second.expired())
+			it = cacheList.caches.erase(it);
+		else
+			++it;
+	}
+	
+	if (returnMe == nullptr)	{
+		returnMe = make_shared<ThreadCache>();
+		{
+			lock_guard<mutex>		lock(_threadCachesLock);
+			_threadCaches.push_back(returnMe);
+		}
+		cacheList.caches.emplace_back(_poolID, returnMe);
+	}
+	
+	return returnMe;
+}
+void GLBufferPool::drainThreadCaches()	{
+	vector<pair<FreeBufferKey,FreeBufferBucket>>		drainedBuckets;
+	
+	{
+		lock_guard<mutex>		lock(_threadCachesLock);
+		for (auto cacheIt=_threadCaches.begin(); cacheIt!=_threadCaches.end(); )	{
+			ThreadCache			*cache = cacheIt->get();
+			cache->lock();
+			for (auto bucketIt=cache->buckets.begin(); bucketIt!=cache->buckets.end(); )	{
+				//	buckets that have been empty since the last drain are dropped, the rest are kept around so the thread doesn't have to re-allocate them
+				if (bucketIt->second.empty())	{
+					bucketIt = cache->buckets.erase(bucketIt);
+					continue;
+				}
+				drainedBuckets.emplace_back(bucketIt->first, FreeBufferBucket());
+				drainedBuckets.back().second.swap(bucketIt->second);
+				++bucketIt;
+			}
+			bool				threadExited = cache->orphaned;
+			cache->unlock();
+			
+			if (threadExited)
+				cacheIt = _threadCaches.erase(cacheIt);
+			else
+				++cacheIt;
+		}
+	}
+	
+	if (drainedBuckets.size() < 1)
+		return;
+	
+	TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+	for (auto & drainedIt : drainedBuckets)	{
+		FreeBufferBucket		&bucket = _freeBuffers[drainedIt.first];
+		bucket.insert(bucket.end(), make_move_iterator(drainedIt.second.begin()), make_move_iterator(drainedIt.second.end()));
+	}
+}
+GLBufferRef GLBufferPool::popFreeBuffer(FreeBufferBucket & inBucket)	{
+	//	run through the bucket from the back (the most recently used buffers are at the back)
+	for (auto it=inBucket.rbegin(); it!=inBucket.rend(); ++it)	{
+#if defined(VVGL_SDK_MAC)
+		//	check to make sure that the IOSurface-related aspects of this buffer are compatible
+		GLBuffer			*bufferPtr = (*it).get();
+		IOSurfaceRef		srf = bufferPtr->localSurfaceRef();
+		if ((bufferPtr->desc.localSurfaceID!=0 && srf==nullptr)	||
+		(bufferPtr->desc.localSurfaceID==0 && srf!=nullptr))	{
+			continue;
+		}
+#endif
+		//	if i'm here, this buffer is a match- remove it from the bucket (empty buckets are left in place and pruned during housekeeping)
+		GLBufferRef			returnMe = *it;
+		inBucket.erase(next(it).base());
+		return returnMe;
+	}
+	return nullptr;
+}
+
+
+/*	========================================	*/
+#pragma mark --------------------- stats
+
+
+GLBufferPool::StatsCounters::StatsCounters()	{
+	for (int i=0; i<=GLBuffer::Type_VAO; ++i)	{
+		creations[i] = 0;
+		deletions[i] = 0;
+	}
+}
+uint64_t GLBufferPool::Stats::totalCreations() const	{
+	uint64_t		returnMe = 0;
+	for (const uint64_t & n : creations)
+		returnMe += n;
+	return returnMe;
+}
+uint64_t GLBufferPool::Stats::totalDeletions() const	{
+	uint64_t		returnMe = 0;
+	for (const uint64_t & n : deletions)
+		returnMe += n;
+	return returnMe;
+}
+string GLBufferPool::Stats::getDescriptionString() const	{
+	const char		*typeNames[] = { "CPU", "RB", "FBO", "Tex", "PBO", "VBO", "EBO", "VAO" };
+	ostringstream	returnMe;
+	returnMe << "<GLBufferPool::Stats hits:" << fetchHits << " misses:" << fetchMisses;
+	returnMe << " created:";
+	for (int i=0; i<=GLBuffer::Type_VAO; ++i)	{
+		if (creations[i] > 0)
+			returnMe << " " << typeNames[i] << "=" << creations[i];
+	}
+	returnMe << " deleted:";
+	for (int i=0; i<=GLBuffer::Type_VAO; ++i)	{
+		if (deletions[i] > 0)
+			returnMe << " " << typeNames[i] << "=" << deletions[i];
+	}
+	returnMe << " free:" << freeBufferCount << " (peak " << peakFreeBufferCount << ")";
+	returnMe << " freeBytes:" << freeGPUBytes << "/" << freeCPUBytes;
+	returnMe << " inFlightBytes:" << inFlightGPUBytes << "/" << inFlightCPUBytes;
+	returnMe << " peakResidentBytes:" << peakResidentBytes;
+	returnMe << " lockTime(ms):" << double(freeBuffersLockNanos)/1000000.0 << "/" << double(contextLockNanos)/1000000.0 << ">";
+	return returnMe.str();
+}
+
+
+
+
 /*	========================================	*/
 #pragma mark --------------------- public API
 
@@ -80,25 +333,106 @@ GLBufferRef GLBufferPool::createBufferRef(const GLBuffer::Descriptor & d, const
 	
 	GLBufferRef		returnMe = nullptr;
 	
+	//	if size classes are enabled, textures that aren't populated from a backing are allocated at the next size class up, and the srcRect describes the region that was requested
+	Size			allocSize = (b==nullptr) ? allocationSizeForSize(d, s) : s;
+	
 	//	if i wasn't passed a backing ptr, try to find a free buffer matching the passed descriptor
 	if (b==nullptr)
-		returnMe = fetchMatchingFreeBuffer(d, s);
-	//	if i found an unused buffer, i can return it immediately
-	if (returnMe != nullptr)	{
-		//cout << "\tfound a matching buffer, returning that instead!\n";
-		return returnMe;
+		returnMe = fetchMatchingFreeBuffer(d, allocSize);
+	//	...if i'm here then i couldn't find a free buffer, and i need to create one
+	if (returnMe == nullptr)
+		returnMe = createNewBufferRef(d, allocSize, b, bs, inCreateInCurrentContext);
+	
+	//	buffers recycled from a size class still have the srcRect of the request they were last vended for, so it's always reset to the region that was requested
+	if (returnMe != nullptr)
+		returnMe->srcRect = Rect(0, 0, s.width, s.height);
+	
+	return returnMe;
+}
+void GLBufferPool::reserve(const GLBuffer::Descriptor & inDesc, const Size & inSize, const size_t & inCount)	{
+	if (_deleted || inCount==0)
+		return;
+	
+	//	only resources that createBufferRef() creates completely (without a backing from the caller) can be reserved
+	switch (inDesc.type)	{
+	case GLBuffer::Type_RB:
+	case GLBuffer::Type_FBO:
+	case GLBuffer::Type_Tex:
+		break;
+	default:
+		return;
 	}
+	if (inDesc.cpuBackingType != GLBuffer::Backing_None)
+		return;
 	
-	//	...if i'm here then i couldn't find a free buffer, and i need to create one
+	GLBufferPoolRef		selfRef = shared_from_this();
+	Size				allocSize = allocationSizeForSize(inDesc, inSize);
+	FreeBufferKey		key(inDesc, allocSize);
+	
+	//	figure out how many buffers we need to create
+	size_t				freeCount = 0;
+	{
+		TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+		auto				bucketIt = _freeBuffers.find(key);
+		if (bucketIt != _freeBuffers.end())
+			freeCount = bucketIt->second.size();
+	}
+	if (freeCount >= inCount)
+		return;
+	
+	FreeBufferBucket		newBuffers;
+	{
+		TimedLockGuard<recursive_mutex>		lock(_contextLock, _stats.contextLockNanos);
+		if (_context == nullptr)
+			return;
+		
+		//	Qt has thread-specific contexts: you cannot make them current on any other threads or they crash
+#if defined(VVGL_SDK_QT)
+		QThread			*currentThread = QThread::currentThread();
+		QObject			*qCtxAsObj = (QObject*)_context->context();
+		QThread			*ctxThread = (qCtxAsObj==nullptr) ? nullptr : qCtxAsObj->thread();
+		//	if we can't make the context current on this thread, reserve the buffers on the context's thread
+		if (currentThread != ctxThread)	{
+			GLBuffer::Descriptor		tmpDesc = inDesc;
+			Size				tmpSize = inSize;
+			size_t				tmpCount = inCount;
+			perform_async([=](){
+				selfRef->reserve(tmpDesc, tmpSize, tmpCount);
+			}, qCtxAsObj);
+			return;
+		}
+#endif	//	VVGL_SDK_QT
+		
+		//	make the pool's context current once and create the buffers "in the current context", so we don't flush after every buffer
+		_context->makeCurrentIfNotCurrent();
+		for (size_t i=freeCount; i<inCount; ++i)	{
+			GLBufferRef			tmpBuffer = createNewBufferRef(inDesc, allocSize, nullptr, Size(), true);
+			if (tmpBuffer == nullptr)
+				break;
+			tmpBuffer->parentBufferPool = selfRef;
+			recordBufferReturnedToPool(*tmpBuffer);
+			newBuffers.push_back(tmpBuffer);
+		}
+		glFlush();
+		GLERRLOG
+	}
 	
+	//	the new buffers go straight to the shared pool (not this thread's cache) so they can be fetched by any thread.  they go at the front of the bucket so buffers that were used more recently are still vended first.
+	TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+	FreeBufferBucket		&bucket = _freeBuffers[key];
+	bucket.insert(bucket.begin(), make_move_iterator(newBuffers.begin()), make_move_iterator(newBuffers.end()));
+}
+
+
+GLBufferRef GLBufferPool::createNewBufferRef(const GLBuffer::Descriptor & d, const Size & s, const void * b, const Size & bs, const bool & inCreateInCurrentContext)	{
 	//	make the buffer
-	returnMe = make_shared<GLBuffer>();
+	GLBufferRef		returnMe = MakeGLBufferRef();
 	//	copy the passed descriptor to the buffer i just created
 	GLBuffer::Descriptor 		&newBufferDesc = returnMe->desc;
 	newBufferDesc = d;
 	
 	//	grab a context lock so we can do stuff with the GL context
-	lock_guard<recursive_mutex>		lock(_contextLock);
+	TimedLockGuard<recursive_mutex>		lock(_contextLock, _stats.contextLockNanos);
 	
 #if defined(VVGL_SDK_MAC)
 	CGLError			err = kCGLNoError;
@@ -123,6 +457,7 @@ GLBufferRef GLBufferPool::createBufferRef(const GLBuffer::Descriptor & d, const
 #endif
 	uint32_t			pixelFormat = 0x00;
 	bool				compressedTex = false;
+	uint32_t			immutableFormat = (d.type==GLBuffer::Type_Tex && d.immutableStorageFlag) ? ImmutableTexStorageFormat(d) : 0;
 	
 #if defined(VVGL_SDK_MAC)
 	switch (d.internalFormat)	{
@@ -235,8 +570,7 @@ GLBufferRef GLBufferPool::createBufferRef(const GLBuffer::Descriptor & d, const
 #endif
 		//	enable the tex target, gen the texture, and bind it
 		GLERRLOG
-		glActiveTexture(GL_TEXTURE0);
-		GLERRLOG
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
 		if (_context->version <= GLVersion_2)	{
 #if defined(VVGL_TARGETENV_GL2)
 			glEnable(newBufferDesc.target);
@@ -245,8 +579,7 @@ GLBufferRef GLBufferPool::createBufferRef(const GLBuffer::Descriptor & d, const
 		}
 		glGenTextures(1, &(returnMe->name));
 		GLERRLOG
-		glBindTexture(newBufferDesc.target, returnMe->name);
-		GLERRLOG
+		GLStateCache::BindTexture(newBufferDesc.target, returnMe->name);
 		
 #if defined(VVGL_SDK_MAC)
 		//	if i want a texture range, there are a couple cases where i can apply it
@@ -362,6 +695,29 @@ GLBufferRef GLBufferPool::createBufferRef(const GLBuffer::Descriptor & d, const
 					nullptr);
 				GLERRLOG
 			}
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL) || defined(VVGL_TARGETENV_GLES3)
+			else if (immutableFormat != 0)	{
+				//	immutable storage- the texture's size and format can't change, so the driver can skip the checks it would otherwise have to do every time the texture is used
+				glTexStorage2D(newBufferDesc.target,
+					1,
+					immutableFormat,
+					static_cast<int>(round(s.width)),
+					static_cast<int>(round(s.height)));
+				GLERRLOG
+				if (b != nullptr)	{
+					glTexSubImage2D(newBufferDesc.target,
+						0,
+						0,
+						0,
+						static_cast<int>(round(s.width)),
+						static_cast<int>(round(s.height)),
+						newBufferDesc.pixelFormat,
+						newBufferDesc.pixelType,
+						b);
+					GLERRLOG
+				}
+			}
+#endif
 			else	{
 				//NSLog(@"\t\ttarget is %ld (should be %ld)",newBufferDesc.target,GL_TEXTURE_2D);
 				//NSLog(@"\t\tinternal is %ld (should be %ld)",newBufferDesc.internalFormat,GL_RGBA);
@@ -392,8 +748,7 @@ GLBufferRef GLBufferPool::createBufferRef(const GLBuffer::Descriptor & d, const
 #endif
 		
 		//	un-bind the tex and disable the target
-		glBindTexture(newBufferDesc.target, 0);
-		GLERRLOG
+		GLStateCache::ReleaseTexture(newBufferDesc.target);
 		if (_context->version <= GLVersion_2)	{
 #if defined(VVGL_TARGETENV_GL2)
 			glDisable(newBufferDesc.target);
@@ -421,6 +776,8 @@ GLBufferRef GLBufferPool::createBufferRef(const GLBuffer::Descriptor & d, const
 	returnMe->backingSize = bs;
 	returnMe->cpuBackingPtr = const_cast<void*>(b);
 	
+	recordBufferCreation(*returnMe);
+	
 	//	timestamp the buffer!
 	timestampThisBuffer(returnMe);
 	
@@ -441,65 +798,73 @@ GLBufferRef GLBufferPool::fetchMatchingFreeBuffer(const GLBuffer::Descriptor & d
 	if (_deleted)
 		return nullptr;
 	
-	//	get a lock on the array of free buffers
-	lock_guard<mutex>		lock(_freeBuffersLock);
+	//	VBOs, EBOs, and VAOs are populated by their factory functions, so they're never recycled
+	switch (desc.type)	{
+	case GLBuffer::Type_VBO:
+	case GLBuffer::Type_EBO:
+	case GLBuffer::Type_VAO:
+		return nullptr;
+	default:
+		break;
+	}
 	
+	FreeBufferKey		key(desc, size);
 	GLBufferRef			returnMe = nullptr;
 	
-	vector<GLBufferRef>::iterator		it;
-	int						tmpIndex = 0;
-	for (it=_freeBuffers.begin(); it!=_freeBuffers.end(); ++it)	{
-		//	if this buffer is comparable to the passed descriptor and can be used for recycling...
-		GLBuffer			*bufferPtr = (*it).get();
-		if (bufferPtr->isComparableForRecycling(desc))	{
-			//	check to make sure that the dimensions of this buffer are compatible...
-			bool				sizeIsOK = false;
-			GLBuffer::Descriptor & desc = bufferPtr->desc;
-			//GLBuffer::Descriptor	*desc = &(bufferPtr->desc);
-			switch (desc.type)	{
-			case GLBuffer::Type_FBO:
-				sizeIsOK = true;
-				break;
-			case GLBuffer::Type_CPU:
-			case GLBuffer::Type_RB:
-			case GLBuffer::Type_Tex:
-			case GLBuffer::Type_PBO:
-				if (bufferPtr->size == size)
-					sizeIsOK = true;
-				break;
-			case GLBuffer::Type_VBO:
-			case GLBuffer::Type_EBO:
-			case GLBuffer::Type_VAO:
-				break;
-			}
-			
-			//	if the size of this buffer is compatible with what's requested...
-			if (sizeIsOK)	{
-#if defined(VVGL_SDK_MAC)
-				//	check to make sure that the IOSurface-related aspects of this buffer are compatible
-				IOSurfaceRef		srf = bufferPtr->localSurfaceRef();
-				if ((desc.localSurfaceID!=0 && srf!=nullptr)	||
-				(desc.localSurfaceID==0 && srf==nullptr))	{
-#endif
-					//	if i'm here, this buffer is a match and i want to use it
-					returnMe = *it;
-					//	remove the buffer from the array
-					_freeBuffers.erase(_freeBuffers.begin()+tmpIndex);
-					//	reset the idleCount to 0 so it's "fresh" (so it gets returned to the pool when it's no longer needed)
-					(*returnMe).idleCount = 0;
-					//	break out of the for loop
-					break;
-#if defined(VVGL_SDK_MAC)
+	//	try the calling thread's cache first- it doesn't require a lock on the shared pool
+	size_t				cacheCapacity = _threadCacheCapacity;
+	ThreadCacheRef		cache = (cacheCapacity==0) ? nullptr : currentThreadCache();
+	if (cache != nullptr)	{
+		cache->lock();
+		auto				bucketIt = cache->buckets.find(key);
+		if (bucketIt != cache->buckets.end())
+			returnMe = popFreeBuffer(bucketIt->second);
+		cache->unlock();
+	}
+	
+	//	if the thread's cache didn't have anything, check the shared pool
+	if (returnMe == nullptr)	{
+		FreeBufferBucket		refill;
+		{
+			//	get a lock on the free buffers
+			TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+			//	every buffer in the bucket for this key is comparable to the passed descriptor and has a compatible size
+			auto				bucketIt = _freeBuffers.find(key);
+			if (bucketIt != _freeBuffers.end())	{
+				returnMe = popFreeBuffer(bucketIt->second);
+				//	while we have the lock, move a batch of buffers into the thread's cache so the next few fetches don't need the lock
+				if (returnMe != nullptr && cache != nullptr)	{
+					size_t				batchSize = max(cacheCapacity/2, size_t(1));
+					while (refill.size() < batchSize)	{
+						GLBufferRef			tmpBuffer = popFreeBuffer(bucketIt->second);
+						if (tmpBuffer == nullptr)
+							break;
+						refill.push_back(tmpBuffer);
+					}
 				}
-#endif
 			}
 		}
-		++tmpIndex;
+		if (refill.size() > 0)	{
+			cache->lock();
+			FreeBufferBucket		&bucket = cache->buckets[key];
+			//	the refill was popped from the back of the shared bucket (most recent first), so reverse it to keep the most recent buffer at the back
+			bucket.insert(bucket.end(), make_move_iterator(refill.rbegin()), make_move_iterator(refill.rend()));
+			cache->unlock();
+		}
 	}
 	
+	if (returnMe == nullptr)	{
+		_stats.fetchMisses.fetch_add(1, memory_order_relaxed);
+		return nullptr;
+	}
+	_stats.fetchHits.fetch_add(1, memory_order_relaxed);
+	recordBufferRemovedFromPool(*returnMe, true);
+	
+	//	reset the idleCount to 0 so it's "fresh" (so it gets returned to the pool when it's no longer needed)
+	(*returnMe).idleCount = 0;
+	
 	//	timestamp the buffer
-	if (returnMe != nullptr)
-		timestampThisBuffer(returnMe);
+	timestampThisBuffer(returnMe);
 	
 	return returnMe;
 }
@@ -508,29 +873,251 @@ void GLBufferPool::housekeeping()	{
 	//cout << __PRETTY_FUNCTION__ << endl;
 	//cout << "\tthis is " << this << endl;
 	
-	lock_guard<mutex>		lock(_freeBuffersLock);
-	
-	bool			needsToClearStuff = false;
-	for_each(_freeBuffers.begin(), _freeBuffers.end(), [&](const GLBufferRef & n)	{
-		(*n).idleCount++;
-		if ((*n).idleCount >= IDLEBUFFERCOUNT)
-			needsToClearStuff = true;
-	});
+	//	buffers sitting in thread caches are idle too- move them back into the shared pool so they age (and can be fetched by any thread)
+	drainThreadCaches();
 	
-	//	if there are indices that need to be removed...
-	if (needsToClearStuff)	{
-		auto		removeIt = remove_if(_freeBuffers.begin(), _freeBuffers.end(), [&](GLBufferRef n){ return (*n).idleCount >= IDLEBUFFERCOUNT; });
-		_freeBuffers.erase(removeIt, _freeBuffers.end());
+	{
+		TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+		
+		if (_memoryBudgetEnabled)	{
+			evictFreeBuffersOverBudget();
+		}
+		else	{
+			for (auto bucketIt=_freeBuffers.begin(); bucketIt!=_freeBuffers.end(); )	{
+				FreeBufferBucket	&bucket = bucketIt->second;
+				
+				bool			needsToClearStuff = false;
+				for_each(bucket.begin(), bucket.end(), [&](const GLBufferRef & n)	{
+					(*n).idleCount++;
+					if ((*n).idleCount >= IDLEBUFFERCOUNT)
+						needsToClearStuff = true;
+				});
+				
+				//	if there are indices that need to be removed...
+				if (needsToClearStuff)	{
+					auto		removeIt = remove_if(bucket.begin(), bucket.end(), [&](GLBufferRef n){ return (*n).idleCount >= IDLEBUFFERCOUNT; });
+					bucket.erase(removeIt, bucket.end());
+				}
+				
+				//	prune empty buckets so sizes we stopped using don't accumulate
+				if (bucket.empty())
+					bucketIt = _freeBuffers.erase(bucketIt);
+				else
+					++bucketIt;
+			}
+		}
 	}
+	
+	//	delete the GL resources of the buffers that were just freed (and any other buffers freed since the last pass) in a batch
+	drainDeletions();
 }
 void GLBufferPool::purge()	{
+	drainThreadCaches();
+	
 	{
-		lock_guard<mutex>		lock(_freeBuffersLock);
-		for_each(_freeBuffers.begin(), _freeBuffers.end(), [&](const GLBufferRef & n)	{
-			n->idleCount = (IDLEBUFFERCOUNT+1);
+		TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+		//	flag every free buffer as having been idle for "too long" so its resources are released when it's freed
+		for (auto & bucketIt : _freeBuffers)	{
+			for_each(bucketIt.second.begin(), bucketIt.second.end(), [&](const GLBufferRef & n)	{
+				n->idleCount = (IDLEBUFFERCOUNT+1);
+			});
+		}
+		_freeBuffers.clear();
+	}
+	
+	drainDeletions();
+}
+void GLBufferPool::evictFreeBuffersOverBudget()	{
+	struct EvictionCandidate	{
+		GLBuffer			*buffer;
+		int					idleCount;
+		uint64_t			gpuBytes;
+		uint64_t			cpuBytes;
+	};
+	vector<EvictionCandidate>		candidates;
+	unordered_set<GLBuffer*>		evictions;
+	uint64_t			gpuTotal = 0;
+	uint64_t			cpuTotal = 0;
+	
+	//	age every free buffer and total up how much memory the pool is holding on to
+	for (auto & bucketIt : _freeBuffers)	{
+		for (const GLBufferRef & n : bucketIt.second)	{
+			(*n).idleCount++;
+			EvictionCandidate		tmpCandidate = { n.get(), (*n).idleCount, 0, 0 };
+			calculateBufferFootprint(*n, tmpCandidate.gpuBytes, tmpCandidate.cpuBytes);
+			//	buffers that don't occupy any memory (FBOs) can't be evicted to get under budget- they expire after sitting idle, same as the default mode
+			if (tmpCandidate.gpuBytes==0 && tmpCandidate.cpuBytes==0)	{
+				if ((*n).idleCount >= IDLEBUFFERCOUNT)
+					evictions.insert(n.get());
+				continue;
+			}
+			gpuTotal += tmpCandidate.gpuBytes;
+			cpuTotal += tmpCandidate.cpuBytes;
+			candidates.push_back(tmpCandidate);
+		}
+	}
+	
+	//	if we're over budget, free the least recently used buffers (the ones that have been idle for the most passes) until we're under budget.  the larger of two equally-idle buffers goes first.
+	if (gpuTotal>_gpuMemoryBudget || cpuTotal>_cpuMemoryBudget)	{
+		sort(candidates.begin(), candidates.end(), [](const EvictionCandidate & a, const EvictionCandidate & b)	{
+			if (a.idleCount != b.idleCount)
+				return a.idleCount > b.idleCount;
+			return (a.gpuBytes + a.cpuBytes) > (b.gpuBytes + b.cpuBytes);
 		});
+		for (const EvictionCandidate & candidate : candidates)	{
+			bool				gpuOverBudget = (gpuTotal > _gpuMemoryBudget);
+			bool				cpuOverBudget = (cpuTotal > _cpuMemoryBudget);
+			if (!gpuOverBudget && !cpuOverBudget)
+				break;
+			//	skip buffers that wouldn't bring us closer to the budget we're over
+			if ((gpuOverBudget && candidate.gpuBytes>0) || (cpuOverBudget && candidate.cpuBytes>0))	{
+				evictions.insert(candidate.buffer);
+				gpuTotal -= candidate.gpuBytes;
+				cpuTotal -= candidate.cpuBytes;
+			}
+		}
+	}
+	
+	//	remove the evicted buffers (their idleCount is non-zero, so their resources are released when they're freed), prune empty buckets
+	for (auto bucketIt=_freeBuffers.begin(); bucketIt!=_freeBuffers.end(); )	{
+		FreeBufferBucket	&bucket = bucketIt->second;
+		if (evictions.size() > 0)	{
+			auto		removeIt = remove_if(bucket.begin(), bucket.end(), [&](const GLBufferRef & n){ return evictions.count(n.get()) > 0; });
+			bucket.erase(removeIt, bucket.end());
+		}
+		if (bucket.empty())
+			bucketIt = _freeBuffers.erase(bucketIt);
+		else
+			++bucketIt;
+	}
+}
+void GLBufferPool::setThreadCacheCapacity(const size_t & n)	{
+	_threadCacheCapacity = n;
+	//	if we're disabling the thread caches, move everything they hold back into the shared pool now
+	if (n == 0)
+		drainThreadCaches();
+}
+void GLBufferPool::setMemoryBudget(const uint64_t & inGPUBytes, const uint64_t & inCPUBytes)	{
+	TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+	_memoryBudgetEnabled = true;
+	_gpuMemoryBudget = inGPUBytes;
+	_cpuMemoryBudget = inCPUBytes;
+}
+void GLBufferPool::disableMemoryBudget()	{
+	TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+	_memoryBudgetEnabled = false;
+}
+bool GLBufferPool::memoryBudgetEnabled()	{
+	TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+	return _memoryBudgetEnabled;
+}
+void GLBufferPool::setSizeClassStep(const uint32_t & inStepInPixels)	{
+	_sizeClassStep = inStepInPixels;
+}
+Size GLBufferPool::allocationSizeForSize(const GLBuffer::Descriptor & inDesc, const Size & inSize) const	{
+	uint32_t		step = _sizeClassStep;
+	if (step == 0)
+		return inSize;
+	//	only textures that the pool allocates entirely on the GPU can be bigger than requested- CPU-backed textures are populated from (and sized to) their backings, and IOSurfaces are shared with other processes at their exact size.
+	if (inDesc.type != GLBuffer::Type_Tex)
+		return inSize;
+	switch (inDesc.target)	{
+	case GLBuffer::Target_2D:
+#if defined(VVGL_SDK_MAC) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN)
+	case GLBuffer::Target_Rect:
+#endif
+		break;
+	default:
+		return inSize;
+	}
+	if (inDesc.cpuBackingType != GLBuffer::Backing_None || inDesc.gpuBackingType != GLBuffer::Backing_Internal)
+		return inSize;
+	if (inDesc.localSurfaceID != 0)
+		return inSize;
+	if (inSize.width <= 0. || inSize.height <= 0.)
+		return inSize;
+	Size			returnMe;
+	returnMe.width = ceil(inSize.width / double(step)) * double(step);
+	returnMe.height = ceil(inSize.height / double(step)) * double(step);
+	return returnMe;
+}
+void GLBufferPool::calculateBufferFootprint(const GLBuffer & inBuffer, uint64_t & outGPUBytes, uint64_t & outCPUBytes)	{
+	outGPUBytes = 0;
+	outCPUBytes = 0;
+	const GLBuffer::Descriptor		&desc = inBuffer.desc;
+	//	only count backings that were allocated by this lib- external backings don't belong to the pool
+	switch (desc.gpuBackingType == GLBuffer::Backing_Internal ? desc.type : GLBuffer::Type_CPU)	{
+	case GLBuffer::Type_CPU:
+		break;
+	case GLBuffer::Type_RB:
+		outGPUBytes = uint64_t(desc.backingLengthForSize(inBuffer.size)) * max(desc.msAmount, uint32_t(1));
+		break;
+	case GLBuffer::Type_Tex:
+	case GLBuffer::Type_PBO:
+		outGPUBytes = desc.backingLengthForSize(inBuffer.size);
+		break;
+	case GLBuffer::Type_FBO:
+	case GLBuffer::Type_VBO:
+	case GLBuffer::Type_EBO:
+	case GLBuffer::Type_VAO:
+		break;
+	}
+	if (desc.cpuBackingType == GLBuffer::Backing_Internal)
+		outCPUBytes = desc.backingLengthForSize(inBuffer.backingSize);
+}
+GLBufferPool::Stats GLBufferPool::stats() const	{
+	Stats			returnMe;
+	returnMe.fetchHits = _stats.fetchHits.load(memory_order_relaxed);
+	returnMe.fetchMisses = _stats.fetchMisses.load(memory_order_relaxed);
+	for (int i=0; i<=GLBuffer::Type_VAO; ++i)	{
+		returnMe.creations[i] = _stats.creations[i].load(memory_order_relaxed);
+		returnMe.deletions[i] = _stats.deletions[i].load(memory_order_relaxed);
+	}
+	returnMe.freeBufferCount = static_cast<uint64_t>(max(_stats.freeBufferCount.load(memory_order_relaxed), int64_t(0)));
+	returnMe.freeGPUBytes = static_cast<uint64_t>(max(_stats.freeGPUBytes.load(memory_order_relaxed), int64_t(0)));
+	returnMe.freeCPUBytes = static_cast<uint64_t>(max(_stats.freeCPUBytes.load(memory_order_relaxed), int64_t(0)));
+	returnMe.inFlightGPUBytes = static_cast<uint64_t>(max(_stats.inFlightGPUBytes.load(memory_order_relaxed), int64_t(0)));
+	returnMe.inFlightCPUBytes = static_cast<uint64_t>(max(_stats.inFlightCPUBytes.load(memory_order_relaxed), int64_t(0)));
+	returnMe.peakFreeBufferCount = static_cast<uint64_t>(max(_stats.peakFreeBufferCount.load(memory_order_relaxed), int64_t(0)));
+	returnMe.peakResidentBytes = static_cast<uint64_t>(max(_stats.peakResidentBytes.load(memory_order_relaxed), int64_t(0)));
+	returnMe.freeBuffersLockNanos = _stats.freeBuffersLockNanos.load(memory_order_relaxed);
+	returnMe.contextLockNanos = _stats.contextLockNanos.load(memory_order_relaxed);
+	return returnMe;
+}
+GLBufferPool::Stats GLBufferPool::snapshotAndResetStats()	{
+	Stats			returnMe;
+	returnMe.fetchHits = _stats.fetchHits.exchange(0, memory_order_relaxed);
+	returnMe.fetchMisses = _stats.fetchMisses.exchange(0, memory_order_relaxed);
+	for (int i=0; i<=GLBuffer::Type_VAO; ++i)	{
+		returnMe.creations[i] = _stats.creations[i].exchange(0, memory_order_relaxed);
+		returnMe.deletions[i] = _stats.deletions[i].exchange(0, memory_order_relaxed);
 	}
-	housekeeping();
+	returnMe.freeBuffersLockNanos = _stats.freeBuffersLockNanos.exchange(0, memory_order_relaxed);
+	returnMe.contextLockNanos = _stats.contextLockNanos.exchange(0, memory_order_relaxed);
+	
+	//	the gauges aren't reset- the peaks restart from the pool's current state
+	int64_t			freeCount = max(_stats.freeBufferCount.load(memory_order_relaxed), int64_t(0));
+	int64_t			freeGPU = max(_stats.freeGPUBytes.load(memory_order_relaxed), int64_t(0));
+	int64_t			freeCPU = max(_stats.freeCPUBytes.load(memory_order_relaxed), int64_t(0));
+	int64_t			inFlightGPU = max(_stats.inFlightGPUBytes.load(memory_order_relaxed), int64_t(0));
+	int64_t			inFlightCPU = max(_stats.inFlightCPUBytes.load(memory_order_relaxed), int64_t(0));
+	returnMe.freeBufferCount = static_cast<uint64_t>(freeCount);
+	returnMe.freeGPUBytes = static_cast<uint64_t>(freeGPU);
+	returnMe.freeCPUBytes = static_cast<uint64_t>(freeCPU);
+	returnMe.inFlightGPUBytes = static_cast<uint64_t>(inFlightGPU);
+	returnMe.inFlightCPUBytes = static_cast<uint64_t>(inFlightCPU);
+	returnMe.peakFreeBufferCount = static_cast<uint64_t>(max(_stats.peakFreeBufferCount.exchange(freeCount, memory_order_relaxed), int64_t(0)));
+	returnMe.peakResidentBytes = static_cast<uint64_t>(max(_stats.peakResidentBytes.exchange(freeGPU+freeCPU+inFlightGPU+inFlightCPU, memory_order_relaxed), int64_t(0)));
+	return returnMe;
+}
+void GLBufferPool::recordBufferCreation(const GLBuffer & inBuffer)	{
+	uint64_t			gpuBytes = 0;
+	uint64_t			cpuBytes = 0;
+	calculateBufferFootprint(inBuffer, gpuBytes, cpuBytes);
+	_stats.creations[inBuffer.desc.type].fetch_add(1, memory_order_relaxed);
+	int64_t			inFlightGPU = _stats.inFlightGPUBytes.fetch_add(static_cast<int64_t>(gpuBytes), memory_order_relaxed) + static_cast<int64_t>(gpuBytes);
+	int64_t			inFlightCPU = _stats.inFlightCPUBytes.fetch_add(static_cast<int64_t>(cpuBytes), memory_order_relaxed) + static_cast<int64_t>(cpuBytes);
+	RaisePeak(_stats.peakResidentBytes, inFlightGPU + inFlightCPU + _stats.freeGPUBytes.load(memory_order_relaxed) + _stats.freeCPUBytes.load(memory_order_relaxed));
 }
 ostream & operator<<(ostream & os, const GLBufferPool & n)	{
 	os << "<GLBufferPool " << &n << ">";
@@ -538,7 +1125,7 @@ ostream & operator<<(ostream & os, const GLBufferPool & n)	{
 }
 
 void GLBufferPool::flush()	{
-	lock_guard<recursive_mutex>		lock(_contextLock);
+	TimedLockGuard<recursive_mutex>		lock(_contextLock, _stats.contextLockNanos);
 	if (_context != nullptr)	{
 		//_context->makeCurrentIfNull();
 		//_context->makeCurrent();
@@ -547,6 +1134,40 @@ void GLBufferPool::flush()	{
 		GLERRLOG
 	}
 }
+void GLBufferPool::drainDeletions()	{
+	PendingDeletions		tmpNames;
+	{
+		lock_guard<mutex>		lock(_pendingDeletionsLock);
+		if (_pendingDeletions.empty())
+			return;
+		swap(tmpNames, _pendingDeletions);
+	}
+	
+	TimedLockGuard<recursive_mutex>		lock(_contextLock, _stats.contextLockNanos);
+	if (_context == nullptr)
+		return;
+	
+	//	Qt has thread-specific contexts: you cannot make them current on any other threads or they crash
+#if defined(VVGL_SDK_QT)
+	QThread			*currentThread = QThread::currentThread();
+	QObject			*qCtxAsObj = (QObject*)_context->context();
+	QThread			*ctxThread = (qCtxAsObj==nullptr) ? nullptr : qCtxAsObj->thread();
+	//	if we can't make the context current on this thread, delete the whole batch on the context's thread
+	if (currentThread != ctxThread)	{
+		GLContextRef		tmpCtx = _context;
+		perform_async([=](){
+			tmpCtx->makeCurrentIfNotCurrent();
+			deletePendingGLNames(tmpNames);
+		}, qCtxAsObj);
+		return;
+	}
+#endif	//	VVGL_SDK_QT
+	
+	//_context->makeCurrentIfNull();
+	//_context->makeCurrent();
+	_context->makeCurrentIfNotCurrent();
+	deletePendingGLNames(tmpNames);
+}
 
 
 
@@ -566,20 +1187,65 @@ void GLBufferPool::returnBufferToPool(GLBuffer * inBuffer)	{
 		return;
 	}
 	
-	//	get a lock for the _freeBuffers array
-	lock_guard<mutex>		lock(_freeBuffersLock);
-	
-	//	if '_freeBuffers' is at capacity, increase its capacity
-	if (_freeBuffers.size() == _freeBuffers.capacity())
-		_freeBuffers.reserve(_freeBuffers.capacity()+25);
-	
-	//	make a shared ptr for the passed buffer, stick it in the vector
-	_freeBuffers.emplace_back(make_shared<GLBuffer>(*inBuffer));
+	//	make a shared ptr for the passed buffer
+	GLBufferRef			pooledBuffer = MakeGLBufferRef(*inBuffer);
+	FreeBufferKey		key(pooledBuffer->desc, pooledBuffer->size);
+	recordBufferReturnedToPool(*pooledBuffer);
 	
 	//	now clear out some vars in the passed buffer- we don't want to release a backing if we're putting it back in the pool
 	inBuffer->backingReleaseCallback = nullptr;
 	inBuffer->backingContext = nullptr;
 	
+	//	try to stick the buffer in the calling thread's cache, which doesn't require a lock on the shared pool
+	size_t				cacheCapacity = _threadCacheCapacity;
+	ThreadCacheRef		cache = (cacheCapacity==0) ? nullptr : currentThreadCache();
+	if (cache != nullptr)	{
+		FreeBufferBucket		spill;
+		cache->lock();
+		FreeBufferBucket		&bucket = cache->buckets[key];
+		bucket.emplace_back(pooledBuffer);
+		//	if the cache is over capacity for this key, spill its oldest buffers back to the shared pool as a batch
+		if (bucket.size() > cacheCapacity)	{
+			auto				spillEnd = bucket.begin() + (bucket.size() - cacheCapacity/2);
+			spill.assign(make_move_iterator(bucket.begin()), make_move_iterator(spillEnd));
+			bucket.erase(bucket.begin(), spillEnd);
+		}
+		cache->unlock();
+		
+		if (spill.size() > 0)	{
+			TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+			FreeBufferBucket		&sharedBucket = _freeBuffers[key];
+			sharedBucket.insert(sharedBucket.end(), make_move_iterator(spill.begin()), make_move_iterator(spill.end()));
+		}
+		return;
+	}
+	
+	//	get a lock for the free buffers, stick the buffer at the back of the bucket for its descriptor/size
+	TimedLockGuard<mutex>		lock(_freeBuffersLock, _stats.freeBuffersLockNanos);
+	_freeBuffers[key].emplace_back(pooledBuffer);
+}
+
+void GLBufferPool::recordBufferReturnedToPool(const GLBuffer & inBuffer)	{
+	uint64_t			gpuBytes = 0;
+	uint64_t			cpuBytes = 0;
+	calculateBufferFootprint(inBuffer, gpuBytes, cpuBytes);
+	_stats.inFlightGPUBytes.fetch_sub(static_cast<int64_t>(gpuBytes), memory_order_relaxed);
+	_stats.inFlightCPUBytes.fetch_sub(static_cast<int64_t>(cpuBytes), memory_order_relaxed);
+	_stats.freeGPUBytes.fetch_add(static_cast<int64_t>(gpuBytes), memory_order_relaxed);
+	_stats.freeCPUBytes.fetch_add(static_cast<int64_t>(cpuBytes), memory_order_relaxed);
+	RaisePeak(_stats.peakFreeBufferCount, _stats.freeBufferCount.fetch_add(1, memory_order_relaxed) + 1);
+}
+void GLBufferPool::recordBufferRemovedFromPool(const GLBuffer & inBuffer, const bool & inVended)	{
+	uint64_t			gpuBytes = 0;
+	uint64_t			cpuBytes = 0;
+	calculateBufferFootprint(inBuffer, gpuBytes, cpuBytes);
+	_stats.freeGPUBytes.fetch_sub(static_cast<int64_t>(gpuBytes), memory_order_relaxed);
+	_stats.freeCPUBytes.fetch_sub(static_cast<int64_t>(cpuBytes), memory_order_relaxed);
+	_stats.freeBufferCount.fetch_sub(1, memory_order_relaxed);
+	if (inVended)	{
+		_stats.inFlightGPUBytes.fetch_add(static_cast<int64_t>(gpuBytes), memory_order_relaxed);
+		_stats.inFlightCPUBytes.fetch_add(static_cast<int64_t>(cpuBytes), memory_order_relaxed);
+	}
 }
 
 void GLBufferPool::releaseBufferResources(GLBuffer * inBuffer)	{
@@ -588,75 +1254,71 @@ void GLBufferPool::releaseBufferResources(GLBuffer * inBuffer)	{
 	if (inBuffer == nullptr)
 		return;
 	
-	lock_guard<recursive_mutex>		lock(_contextLock);
-	if (_context == nullptr)
-		return;
-	
-	//	Qt has thread-specific contexts: you cannot make them current on any other threads or they crash
-#if defined(VVGL_SDK_QT)
-	//	if we can't make the context current on this thread
-	QThread			*currentThread = QThread::currentThread();
-	QObject			*qCtxAsObj = (QObject*)_context->context();
-	QThread			*ctxThread = (qCtxAsObj==nullptr) ? nullptr : qCtxAsObj->thread();
-	
-	if (currentThread != ctxThread)	{
-		//cout << "\terr: can't release buffer " << inBuffer->getDescriptionString() << " on this thread..." << endl;
-		//	make a new GLBuffer that duplicates the GLBuffer we were passed (which is being freed)
-		GLBuffer		*copiedBuffer = inBuffer->allocShallowCopy();
-		//	now we want this buffer to get deleted on the context's thread...
-		perform_async([=](){
-			//cout << "\tshould be deleting the copied buffer now..." << endl;
-			delete copiedBuffer;
-		}, qCtxAsObj);
-		//	return- we can't make the context current or delete anything on this thread
-		return;
+	//	a non-zero idleCount means the buffer was sitting in the pool, otherwise it's being released while in use
+	if (inBuffer->idleCount != 0)
+		recordBufferRemovedFromPool(*inBuffer, false);
+	else	{
+		uint64_t			gpuBytes = 0;
+		uint64_t			cpuBytes = 0;
+		calculateBufferFootprint(*inBuffer, gpuBytes, cpuBytes);
+		_stats.inFlightGPUBytes.fetch_sub(static_cast<int64_t>(gpuBytes), memory_order_relaxed);
+		_stats.inFlightCPUBytes.fetch_sub(static_cast<int64_t>(cpuBytes), memory_order_relaxed);
 	}
-#endif	//	VVGL_SDK_QT
+	_stats.deletions[inBuffer->desc.type].fetch_add(1, memory_order_relaxed);
 	
-	//_context->makeCurrentIfNull();
-	//_context->makeCurrent();
-	_context->makeCurrentIfNotCurrent();
+	if (inBuffer->desc.type==GLBuffer::Type_CPU || inBuffer->name==0)
+		return;
 	
+	//	we don't delete the GL resource here- its name is queued, and the queue is deleted in a batch (one glDelete* call per type, one flush) by drainDeletions().  this avoids a context switch and a flush for every buffer that's freed, and lets buffers be freed on any thread.  deleting a mapped PBO implicitly unmaps it.
+	lock_guard<mutex>		lock(_pendingDeletionsLock);
 	switch (inBuffer->desc.type)	{
 	case GLBuffer::Type_CPU:
 		break;
 	case GLBuffer::Type_RB:
-		glDeleteRenderbuffers(1, &inBuffer->name);
-		GLERRLOG
+		_pendingDeletions.renderbuffers.push_back(inBuffer->name);
 		break;
 	case GLBuffer::Type_FBO:
-		glDeleteFramebuffers(1, &inBuffer->name);
-		GLERRLOG
+		_pendingDeletions.framebuffers.push_back(inBuffer->name);
 		break;
 	case GLBuffer::Type_Tex:
-		glDeleteTextures(1, &inBuffer->name);
-		GLERRLOG
+		_pendingDeletions.textures.push_back(inBuffer->name);
 		break;
 	case GLBuffer::Type_PBO:
-//	none of this stuff should be available if we're running ES
-#if !defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
-		if (inBuffer->pboMapped)	{
-			inBuffer->unmapPBO(true);
-		}
-#endif	//	!defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
-		glDeleteBuffers(1, &inBuffer->name);
-		GLERRLOG
-		break;
 	case GLBuffer::Type_VBO:
-		glDeleteBuffers(1, &inBuffer->name);
-		GLERRLOG
-		break;
 	case GLBuffer::Type_EBO:
-		glDeleteBuffers(1, &inBuffer->name);
-		GLERRLOG
+		_pendingDeletions.buffers.push_back(inBuffer->name);
 		break;
 	case GLBuffer::Type_VAO:
-		glDeleteVertexArrays(1, &inBuffer->name);
-		GLERRLOG
+		_pendingDeletions.vertexArrays.push_back(inBuffer->name);
 		break;
 	}
+}
+void GLBufferPool::deletePendingGLNames(const PendingDeletions & inNames)	{
+	if (inNames.textures.size() > 0)	{
+		glDeleteTextures(static_cast<GLsizei>(inNames.textures.size()), inNames.textures.data());
+		GLERRLOG
+	}
+	if (inNames.renderbuffers.size() > 0)	{
+		glDeleteRenderbuffers(static_cast<GLsizei>(inNames.renderbuffers.size()), inNames.renderbuffers.data());
+		GLERRLOG
+	}
+	if (inNames.framebuffers.size() > 0)	{
+		glDeleteFramebuffers(static_cast<GLsizei>(inNames.framebuffers.size()), inNames.framebuffers.data());
+		GLERRLOG
+	}
+	if (inNames.buffers.size() > 0)	{
+		glDeleteBuffers(static_cast<GLsizei>(inNames.buffers.size()), inNames.buffers.data());
+		GLERRLOG
+	}
+	if (inNames.vertexArrays.size() > 0)	{
+		glDeleteVertexArrays(static_cast<GLsizei>(inNames.vertexArrays.size()), inNames.vertexArrays.data());
+		GLERRLOG
+	}
 	glFlush();
 	GLERRLOG
+	//	the names may be reused, so state caches (in every context) have to forget the objects they think are bound
+	if (inNames.textures.size()>0 || inNames.framebuffers.size()>0 || inNames.vertexArrays.size()>0)
+		GLStateCache::NoteDeletedObjects();
 }
 
 
@@ -763,7 +1425,7 @@ GLBufferRef CreateFBO(const bool & inCreateInCurrentContext, const GLBufferPoolR
 GLBufferRef CreateVBO(const void * inBytes, const size_t & inByteSize, const int32_t & inUsage, const bool & inCreateInCurrentContext, const GLBufferPoolRef & inPoolRef)	{
 	if (inPoolRef == nullptr)
 		return nullptr;
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor &	desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_VBO;
@@ -802,6 +1464,7 @@ GLBufferRef CreateVBO(const void * inBytes, const size_t & inByteSize, const int
 	returnMe->size = {0.,0.};
 	returnMe->srcRect = {0., 0., 0., 0.};
 	inPoolRef->timestampThisBuffer(returnMe);
+	inPoolRef->recordBufferCreation(*returnMe);
 	returnMe->preferDeletion = true;
 	
 	return returnMe;
@@ -809,7 +1472,7 @@ GLBufferRef CreateVBO(const void * inBytes, const size_t & inByteSize, const int
 GLBufferRef CreateEBO(const void * inBytes, const size_t & inByteSize, const int32_t & inUsage, const bool & inCreateInCurrentContext, const GLBufferPoolRef & inPoolRef)	{
 	if (inPoolRef == nullptr)
 		return nullptr;
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor &	desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_EBO;
@@ -848,6 +1511,7 @@ GLBufferRef CreateEBO(const void * inBytes, const size_t & inByteSize, const int
 	returnMe->size = {0.,0.};
 	returnMe->srcRect = {0., 0., 0., 0.};
 	inPoolRef->timestampThisBuffer(returnMe);
+	inPoolRef->recordBufferCreation(*returnMe);
 	returnMe->preferDeletion = true;
 	
 	return returnMe;
@@ -858,7 +1522,7 @@ GLBufferRef CreateVAO(const bool & inCreateInCurrentContext, const GLBufferPoolR
 		return nullptr;
 	if (inPoolRef->context()->version < GLVersion_ES3)
 		return nullptr;
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor &	desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_VAO;
@@ -891,6 +1555,7 @@ GLBufferRef CreateVAO(const bool & inCreateInCurrentContext, const GLBufferPoolR
 	returnMe->size = {0.,0.};
 	returnMe->srcRect = {0., 0., 0., 0.};
 	inPoolRef->timestampThisBuffer(returnMe);
+	inPoolRef->recordBufferCreation(*returnMe);
 	returnMe->preferDeletion = true;
 	
 	return returnMe;
@@ -966,13 +1631,13 @@ GLBufferRef CreateRGBACPUBuffer(const Size & size, const GLBufferPoolRef & inPoo
 	
 	GLBufferRef		returnMe = inPoolRef->fetchMatchingFreeBuffer(desc, size);
 	if (returnMe == nullptr)	{
-		void			*bufferMemory = malloc(desc.backingLengthForSize(size));
+		void			*bufferMemory = GetCPUBackingArena().allocate(desc.backingLengthForSize(size));
 		returnMe = inPoolRef->createBufferRef(desc, size, bufferMemory, size, false);
 		returnMe->parentBufferPool = inPoolRef;
 		returnMe->backingID = GLBuffer::BackingID_Pixels;
 		returnMe->backingContext = bufferMemory;
 		returnMe->backingReleaseCallback = [](GLBuffer & /*inBuffer*/, void* inReleaseContext)	{
-			free(inReleaseContext);
+			GetCPUBackingArena().release(inReleaseContext);
 		};
 	}
 	
@@ -999,13 +1664,13 @@ GLBufferRef CreateRGBAFloatCPUBuffer(const Size & size, const GLBufferPoolRef &
 	
 	GLBufferRef		returnMe = inPoolRef->fetchMatchingFreeBuffer(desc, size);
 	if (returnMe == nullptr)	{
-		void			*bufferMemory = malloc(desc.backingLengthForSize(size));
+		void			*bufferMemory = GetCPUBackingArena().allocate(desc.backingLengthForSize(size));
 		returnMe = inPoolRef->createBufferRef(desc, size, bufferMemory, size, false);
 		returnMe->parentBufferPool = inPoolRef;
 		returnMe->backingID = GLBuffer::BackingID_Pixels;
 		returnMe->backingContext = bufferMemory;
 		returnMe->backingReleaseCallback = [](GLBuffer & /*inBuffer*/, void* inReleaseContext)	{
-			free(inReleaseContext);
+			GetCPUBackingArena().release(inReleaseContext);
 		};
 	}
 	
@@ -1038,13 +1703,13 @@ GLBufferRef CreateBGRACPUBuffer(const Size & size, const GLBufferPoolRef & inPoo
 	
 	GLBufferRef		returnMe = inPoolRef->fetchMatchingFreeBuffer(desc, size);
 	if (returnMe == nullptr)	{
-		void			*bufferMemory = malloc(desc.backingLengthForSize(size));
+		void			*bufferMemory = GetCPUBackingArena().allocate(desc.backingLengthForSize(size));
 		returnMe = inPoolRef->createBufferRef(desc, size, bufferMemory, size, false);
 		returnMe->parentBufferPool = inPoolRef;
 		returnMe->backingID = GLBuffer::BackingID_Pixels;
 		returnMe->backingContext = bufferMemory;
 		returnMe->backingReleaseCallback = [](GLBuffer & /*inBuffer*/, void* inReleaseContext)	{
-			free(inReleaseContext);
+			GetCPUBackingArena().release(inReleaseContext);
 		};
 	}
 	
@@ -1071,20 +1736,20 @@ GLBufferRef CreateBGRAFloatCPUBuffer(const Size & size, const GLBufferPoolRef &
 	
 	GLBufferRef		returnMe = inPoolRef->fetchMatchingFreeBuffer(desc, size);
 	if (returnMe == nullptr)	{
-		void			*bufferMemory = malloc(desc.backingLengthForSize(size));
+		void			*bufferMemory = GetCPUBackingArena().allocate(desc.backingLengthForSize(size));
 		returnMe = inPoolRef->createBufferRef(desc, size, bufferMemory, size, false);
 		returnMe->parentBufferPool = inPoolRef;
 		returnMe->backingID = GLBuffer::BackingID_Pixels;
 		returnMe->backingContext = bufferMemory;
 		returnMe->backingReleaseCallback = [](GLBuffer & /*inBuffer*/, void* inReleaseContext)	{
-			free(inReleaseContext);
+			GetCPUBackingArena().release(inReleaseContext);
 		};
 	}
 	
 	return returnMe;
 }
 GLBufferRef CreateRGBACPUBufferUsing(const Size & inCPUBufferSizeInPixels, const void * inCPUBackingPtr, const Size & inImageSizeInPixels, const void * inReleaseCallbackContext, const GLBuffer::BackingReleaseCallback & inReleaseCallback, const GLBufferPoolRef & inPoolRef)	{
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor		&desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_CPU;
@@ -1118,7 +1783,7 @@ GLBufferRef CreateRGBACPUBufferUsing(const Size & inCPUBufferSizeInPixels, const
 	return returnMe;
 }
 GLBufferRef CreateRGBAFloatCPUBufferUsing(const Size & inCPUBufferSizeInPixels, const void * inCPUBackingPtr, const Size & inImageSizeInPixels, const void * inReleaseCallbackContext, const GLBuffer::BackingReleaseCallback & inReleaseCallback, const GLBufferPoolRef & inPoolRef)	{
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor		&desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_CPU;
@@ -1152,7 +1817,7 @@ GLBufferRef CreateRGBAFloatCPUBufferUsing(const Size & inCPUBufferSizeInPixels,
 	return returnMe;
 }
 GLBufferRef CreateBGRACPUBufferUsing(const Size & inCPUBufferSizeInPixels, const void * inCPUBackingPtr, const Size & inImageSizeInPixels, const void * inReleaseCallbackContext, const GLBuffer::BackingReleaseCallback & inReleaseCallback, const GLBufferPoolRef & inPoolRef)	{
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor		&desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_CPU;
@@ -1186,7 +1851,7 @@ GLBufferRef CreateBGRACPUBufferUsing(const Size & inCPUBufferSizeInPixels, const
 	return returnMe;
 }
 GLBufferRef CreateBGRAFloatCPUBufferUsing(const Size & inCPUBufferSizeInPixels, const void * inCPUBackingPtr, const Size & inImageSizeInPixels, const void * inReleaseCallbackContext, const GLBuffer::BackingReleaseCallback & inReleaseCallback, const GLBufferPoolRef & inPoolRef)	{
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor		&desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_CPU;
@@ -1222,7 +1887,7 @@ GLBufferRef CreateBGRAFloatCPUBufferUsing(const Size & inCPUBufferSizeInPixels,
 //	none of this stuff should be available if we're running ES
 #if !defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
 VVGL_EXPORT GLBufferRef CreateYCbCrCPUBufferUsing(const Size & inCPUBufferSizeInPixels, const void * inCPUBackingPtr, const Size & inImageSizeInPixels, const void * inReleaseCallbackContext, const GLBuffer::BackingReleaseCallback & inReleaseCallback, const GLBufferPoolRef & inPoolRef)	{
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor		&desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_CPU;
@@ -1262,11 +1927,8 @@ VVGL_EXPORT GLBufferRef CreateYCbCrCPUBufferUsing(const Size & inCPUBufferSizeIn
 #pragma mark --------------------- texture buffer creation methods
 
 
-GLBufferRef CreateRGBATex(const Size & size, const bool & inCreateInCurrentContext, const GLBufferPoolRef & inPoolRef)	{
-	//cout << __PRETTY_FUNCTION__ << endl;
-	if (inPoolRef == nullptr)
-		return nullptr;
-	
+//	the descriptors used by the RGBA tex create/reserve functions (reserved buffers are only recycled if their descriptor matches)
+static GLBuffer::Descriptor RGBATexDescriptor(const bool & inImmutableStorage)	{
 	GLBuffer::Descriptor	desc;
 	
 	desc.type = GLBuffer::Type_Tex;
@@ -1286,17 +1948,11 @@ GLBufferRef CreateRGBATex(const Size & size, const bool & inCreateInCurrentConte
 	desc.texClientStorageFlag = false;
 	desc.msAmount = 0;
 	desc.localSurfaceID = 0;
+	desc.immutableStorageFlag = inImmutableStorage;
 	
-	GLBufferRef	returnMe = inPoolRef->createBufferRef(desc, size, nullptr, Size(), inCreateInCurrentContext);
-	returnMe->parentBufferPool = inPoolRef;
-	
-	return returnMe;
+	return desc;
 }
-GLBufferRef CreateRGBAFloatTex(const Size & size, const bool & inCreateInCurrentContext, const GLBufferPoolRef & inPoolRef)	{
-	//cout << __PRETTY_FUNCTION__ << endl;
-	if (inPoolRef == nullptr)
-		return nullptr;
-	
+static GLBuffer::Descriptor RGBAFloatTexDescriptor(const bool & inImmutableStorage)	{
 	GLBuffer::Descriptor	desc;
 	
 	desc.type = GLBuffer::Type_Tex;
@@ -1319,12 +1975,76 @@ GLBufferRef CreateRGBAFloatTex(const Size & size, const bool & inCreateInCurrent
 	desc.texClientStorageFlag = false;
 	desc.msAmount = 0;
 	desc.localSurfaceID = 0;
+	desc.immutableStorageFlag = inImmutableStorage;
+	
+	return desc;
+}
+GLBufferRef CreateRGBATex(const Size & size, const bool & inCreateInCurrentContext, const GLBufferPoolRef & inPoolRef)	{
+	//cout << __PRETTY_FUNCTION__ << endl;
+	if (inPoolRef == nullptr)
+		return nullptr;
+	
+	GLBuffer::Descriptor	desc = RGBATexDescriptor(false);
+	
+	GLBufferRef	returnMe = inPoolRef->createBufferRef(desc, size, nullptr, Size(), inCreateInCurrentContext);
+	returnMe->parentBufferPool = inPoolRef;
+	
+	return returnMe;
+}
+GLBufferRef CreateRGBAFloatTex(const Size & size, const bool & inCreateInCurrentContext, const GLBufferPoolRef & inPoolRef)	{
+	//cout << __PRETTY_FUNCTION__ << endl;
+	if (inPoolRef == nullptr)
+		return nullptr;
+	
+	GLBuffer::Descriptor	desc = RGBAFloatTexDescriptor(false);
+	
+	GLBufferRef	returnMe = inPoolRef->createBufferRef(desc, size, nullptr, Size(), inCreateInCurrentContext);
+	returnMe->parentBufferPool = inPoolRef;
+	
+	return returnMe;
+}
+GLBufferRef CreateRGBATexImmutable(const Size & size, const bool & inCreateInCurrentContext, const GLBufferPoolRef & inPoolRef)	{
+	if (inPoolRef == nullptr)
+		return nullptr;
+	
+	GLBuffer::Descriptor	desc = RGBATexDescriptor(true);
+	
+	GLBufferRef	returnMe = inPoolRef->createBufferRef(desc, size, nullptr, Size(), inCreateInCurrentContext);
+	returnMe->parentBufferPool = inPoolRef;
+	
+	return returnMe;
+}
+GLBufferRef CreateRGBAFloatTexImmutable(const Size & size, const bool & inCreateInCurrentContext, const GLBufferPoolRef & inPoolRef)	{
+	if (inPoolRef == nullptr)
+		return nullptr;
+	
+	GLBuffer::Descriptor	desc = RGBAFloatTexDescriptor(true);
 	
 	GLBufferRef	returnMe = inPoolRef->createBufferRef(desc, size, nullptr, Size(), inCreateInCurrentContext);
 	returnMe->parentBufferPool = inPoolRef;
 	
 	return returnMe;
 }
+void ReserveRGBATex(const Size & size, const size_t & count, const GLBufferPoolRef & inPoolRef)	{
+	if (inPoolRef == nullptr)
+		return;
+	inPoolRef->reserve(RGBATexDescriptor(false), size, count);
+}
+void ReserveRGBAFloatTex(const Size & size, const size_t & count, const GLBufferPoolRef & inPoolRef)	{
+	if (inPoolRef == nullptr)
+		return;
+	inPoolRef->reserve(RGBAFloatTexDescriptor(false), size, count);
+}
+void ReserveRGBATexImmutable(const Size & size, const size_t & count, const GLBufferPoolRef & inPoolRef)	{
+	if (inPoolRef == nullptr)
+		return;
+	inPoolRef->reserve(RGBATexDescriptor(true), size, count);
+}
+void ReserveRGBAFloatTexImmutable(const Size & size, const size_t & count, const GLBufferPoolRef & inPoolRef)	{
+	if (inPoolRef == nullptr)
+		return;
+	inPoolRef->reserve(RGBAFloatTexDescriptor(true), size, count);
+}
 #if !defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
 GLBufferRef CreateYCbCrTex(const Size & size, const bool & createInCurrentContext, const GLBufferPoolRef & inPoolRef)	{
 	//cout << __PRETTY_FUNCTION__ << endl;
@@ -1382,7 +2102,7 @@ GLBufferRef CreateDepthBuffer(const Size & size, const bool & inCreateInCurrentC
 }
 
 GLBufferRef CreateFromExistingGLTexture(const int32_t & inTexName, const GLBuffer::Target & inTexTarget, const GLBuffer::InternalFormat & inTexIntFmt, const GLBuffer::PixelFormat & inTexPxlFmt, const GLBuffer::PixelType & inTexPxlType, const Size & inTexSize, const bool & inTexFlipped, const Rect & inImgRectInTex, const void * inReleaseCallbackContext, const GLBuffer::BackingReleaseCallback & inReleaseCallback, const GLBufferPoolRef & inPoolRef)	{
-	GLBufferRef		returnMe = make_shared<GLBuffer>();
+	GLBufferRef		returnMe = MakeGLBufferRef();
 	returnMe->desc.type = GLBuffer::Type_Tex;
 	returnMe->desc.target = static_cast<GLBuffer::Target>(inTexTarget);
 	returnMe->desc.internalFormat = static_cast<GLBuffer::InternalFormat>(inTexIntFmt);
@@ -1504,13 +2224,13 @@ GLBufferRef CreateRGBACPUBackedTex(const Size & size, const bool & createInCurre
 	if (returnMe != nullptr)
 		return returnMe;
 	
-	void			*bufferMemory = malloc(desc.backingLengthForSize(size));
+	void			*bufferMemory = GetCPUBackingArena().allocate(desc.backingLengthForSize(size));
 	returnMe = inPoolRef->createBufferRef(desc, size, bufferMemory, size, createInCurrentContext);
 	returnMe->parentBufferPool = inPoolRef;
 	returnMe->backingID = GLBuffer::BackingID_Pixels;
 	returnMe->backingContext = bufferMemory;
 	returnMe->backingReleaseCallback = [](GLBuffer & /*inBuffer*/, void* inReleaseContext)	{
-		free(inReleaseContext);
+		GetCPUBackingArena().release(inReleaseContext);
 	};
 	
 	return returnMe;
@@ -1536,13 +2256,13 @@ GLBufferRef CreateRGBAFloatCPUBackedTex(const Size & size, const bool & createIn
 	if (returnMe != nullptr)
 		return returnMe;
 	
-	void			*bufferMemory = malloc(desc.backingLengthForSize(size));
+	void			*bufferMemory = GetCPUBackingArena().allocate(desc.backingLengthForSize(size));
 	returnMe = inPoolRef->createBufferRef(desc, size, bufferMemory, size, createInCurrentContext);
 	returnMe->parentBufferPool = inPoolRef;
 	returnMe->backingID = GLBuffer::BackingID_Pixels;
 	returnMe->backingContext = bufferMemory;
 	returnMe->backingReleaseCallback = [](GLBuffer & /*inBuffer*/, void* inReleaseContext)	{
-		free(inReleaseContext);
+		GetCPUBackingArena().release(inReleaseContext);
 	};
 	
 	return returnMe;
@@ -1574,13 +2294,13 @@ GLBufferRef CreateBGRACPUBackedTex(const Size & size, const bool & createInCurre
 	if (returnMe != nullptr)
 		return returnMe;
 	
-	void			*bufferMemory = malloc(desc.backingLengthForSize(size));
+	void			*bufferMemory = GetCPUBackingArena().allocate(desc.backingLengthForSize(size));
 	returnMe = inPoolRef->createBufferRef(desc, size, bufferMemory, size, createInCurrentContext);
 	returnMe->parentBufferPool = inPoolRef;
 	returnMe->backingID = GLBuffer::BackingID_Pixels;
 	returnMe->backingContext = bufferMemory;
 	returnMe->backingReleaseCallback = [](GLBuffer & /*inBuffer*/, void* inReleaseContext)	{
-		free(inReleaseContext);
+		GetCPUBackingArena().release(inReleaseContext);
 	};
 	
 	return returnMe;
@@ -1606,13 +2326,13 @@ GLBufferRef CreateBGRAFloatCPUBackedTex(const Size & size, const bool & createIn
 	if (returnMe != nullptr)
 		return returnMe;
 	
-	void			*bufferMemory = malloc(desc.backingLengthForSize(size));
+	void			*bufferMemory = GetCPUBackingArena().allocate(desc.backingLengthForSize(size));
 	returnMe = inPoolRef->createBufferRef(desc, size, bufferMemory, size, createInCurrentContext);
 	returnMe->parentBufferPool = inPoolRef;
 	returnMe->backingID = GLBuffer::BackingID_Pixels;
 	returnMe->backingContext = bufferMemory;
 	returnMe->backingReleaseCallback = [](GLBuffer & /*inBuffer*/, void* inReleaseContext)	{
-		free(inReleaseContext);
+		GetCPUBackingArena().release(inReleaseContext);
 	};
 	
 	return returnMe;
@@ -2266,7 +2986,7 @@ GLBufferRef CreateCPUBufferForQImage(QImage * inImg, const GLBufferPoolRef & inP
 	VVGL::Size		repSize(imgCopy->bytesPerLine()*8/32, rawImgSize.height());
 	//VVGL::Size		gpuSize = imgSize;
 	
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor		&desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_CPU;
@@ -2339,7 +3059,7 @@ GLBufferRef CreateCPUBufferForQVideoFrame(QVideoFrame * inFrame, const GLBufferP
 	VVGL::Size		repSize(newFrame->bytesPerLine()*8/32, rawImgSize.height());	//	only works for 32 bits per pixel!
 	//cout << "\timgSize is " << imgSize << ", repSize is " << repSize << endl;
 	
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	GLBuffer::Descriptor		&desc = returnMe->desc;
 	
 	desc.type = GLBuffer::Type_CPU;
@@ -2504,15 +3224,13 @@ void PushTexRangeBufferRAMtoVRAM(const GLBufferRef & inBufferRef, const GLContex
 	inContextRef->makeCurrentIfNotCurrent();
 	
 //#if defined(VVGL_TARGETENV_GL2)
-	glActiveTexture(GL_TEXTURE0);
-	GLERRLOG
+	GLStateCache::ActiveTexture(GL_TEXTURE0);
 	if (inContextRef->version == GLVersion_2)	{
 		glEnable(desc.target);
 		GLERRLOG
 	}
 //#endif
-	glBindTexture(desc.target, inBufferRef->name);
-	GLERRLOG
+	GLStateCache::BindTexture(desc.target, inBufferRef->name);
 	
 	if (desc.texClientStorageFlag)	{
 		glPixelStorei(GL_UNPACK_CLIENT_STORAGE_APPLE, GL_TRUE);
@@ -2590,8 +3308,7 @@ void PushTexRangeBufferRAMtoVRAM(const GLBufferRef & inBufferRef, const GLContex
 		GLERRLOG
 	}
 	
-	glBindTexture(desc.target, 0);
-	GLERRLOG
+	GLStateCache::ReleaseTexture(desc.target);
 	if (inContextRef->version == GLVersion_2)	{
 		glDisable(desc.target);
 		GLERRLOG
@@ -2671,7 +3388,7 @@ GLBufferRef CreateRGBATexFromIOSurfaceID(const IOSurfaceID & inID, const bool &
 	size_t			bytesPerRow = IOSurfaceGetBytesPerRow(newSurface);
 	bool			isRGBAFloatTex = (bytesPerRow >= (32*4*newAssetSize.width/8)) ? true : false;
 	//	make the buffer i'll be returning, set up as much of it as i can
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	inPoolRef->timestampThisBuffer(returnMe);
 	returnMe->desc.type = GLBuffer::Type_Tex;
 	returnMe->desc.target = GLBuffer::Target_Rect;
@@ -2763,8 +3480,7 @@ GLBufferRef CreateRGBATexFromIOSurfaceID(const IOSurfaceID & inID, const bool &
 	}
 	CGLContextObj		cglCtx = CGLGetCurrentContext();
 	if (cglCtx != NULL)	{
-		glActiveTexture(GL_TEXTURE0);
-		GLERRLOG
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
 		if (inPoolRef->context()->version <= GLVersion_2)	{
 #if defined(VVGL_TARGETENV_GL2)
 			glEnable(returnMe->desc.target);
@@ -2773,8 +3489,7 @@ GLBufferRef CreateRGBATexFromIOSurfaceID(const IOSurfaceID & inID, const bool &
 		}
 		glGenTextures(1,&(returnMe->name));
 		GLERRLOG
-		glBindTexture(returnMe->desc.target, returnMe->name);
-		GLERRLOG
+		GLStateCache::BindTexture(returnMe->desc.target, returnMe->name);
 		CGLError		err = CGLTexImageIOSurface2D(cglCtx,
 			returnMe->desc.target,
 			returnMe->desc.internalFormat,
@@ -2796,8 +3511,7 @@ GLBufferRef CreateRGBATexFromIOSurfaceID(const IOSurfaceID & inID, const bool &
 		GLERRLOG
 		glFlush();
 		GLERRLOG
-		glBindTexture(returnMe->desc.target, 0);
-		GLERRLOG
+		GLStateCache::ReleaseTexture(returnMe->desc.target);
 		if (inPoolRef->context()->version <= GLVersion_2)	{
 #if defined(VVGL_TARGETENV_GL2)
 			glDisable(returnMe->desc.target);
@@ -3197,7 +3911,7 @@ GLBufferRef CreateCubeTexFromImages(const vector<CGImageRef> & inImgs, const boo
 	desc.msAmount = 0;
 	desc.localSurfaceID = 0;
 	//	create the GLBuffer we'll be returning, set it up with the basic info
-	GLBufferRef		returnMe = make_shared<GLBuffer>();
+	GLBufferRef		returnMe = MakeGLBufferRef();
 	returnMe->parentBufferPool = inPoolRef;
 	returnMe->desc = desc;
 	returnMe->preferDeletion = true;
@@ -3218,8 +3932,7 @@ GLBufferRef CreateCubeTexFromImages(const vector<CGImageRef> & inImgs, const boo
 	}
 	
 	//	create the GL resource, do some basic setup before we upload data to it
-	glActiveTexture(GL_TEXTURE0);
-	GLERRLOG
+	GLStateCache::ActiveTexture(GL_TEXTURE0);
 	if (inPoolRef->context()->version <= GLVersion_2)	{
 #if defined(VVGL_TARGETENV_GL2)
 		glEnable(desc.target);
@@ -3228,8 +3941,7 @@ GLBufferRef CreateCubeTexFromImages(const vector<CGImageRef> & inImgs, const boo
 	}
 	glGenTextures(1, &(returnMe->name));
 	GLERRLOG
-	glBindTexture(desc.target, returnMe->name);
-	GLERRLOG
+	GLStateCache::BindTexture(desc.target, returnMe->name);
 	
 	glPixelStorei(GL_UNPACK_SKIP_ROWS, GL_FALSE);
 	GLERRLOG
@@ -3295,8 +4007,7 @@ GLBufferRef CreateCubeTexFromImages(const vector<CGImageRef> & inImgs, const boo
 		returnMe = nullptr;
 	}
 	
-	glBindTexture(desc.target, 0);
-	GLERRLOG
+	GLStateCache::ReleaseTexture(desc.target);
 //#if !defined(VVGL_SDK_IOS) && !defined(VVGL_SDK_RPI)
 	if (inPoolRef->context()->version <= GLVersion_2)	{
 		glDisable(desc.target);
@@ -3375,7 +4086,7 @@ GLBufferRef CreateBufferForCVGLTex(CVOpenGLESTextureRef & inTexRef, const bool &
 	}
 	
 	//VVBuffer			*returnMe = [[VVBuffer alloc] initWithPool:self];
-	GLBufferRef		returnMe = make_shared<GLBuffer>(inPoolRef);
+	GLBufferRef		returnMe = MakeGLBufferRef(inPoolRef);
 	//[VVBufferPool timestampThisBuffer:returnMe];
 	GetGlobalBufferPool()->timestampThisBuffer(returnMe);
 	//GLBuffer::Descriptor	&desc = returnMe->desc;
@@ -1,5 +1,6 @@
 #include "GLCPUToTexCopier.hpp"
 #include <cstring> // memcpy
+#include <algorithm>
 
 
 
@@ -35,6 +36,19 @@ GLCPUToTexCopier::GLCPUToTexCopier()	{
 }
 GLCPUToTexCopier::~GLCPUToTexCopier()	{
 	clearStream();
+	//	delete the persistently mapped ring(s)- any ring CPU buffers that are still around point to memory that is no longer mapped
+	lock_guard<recursive_mutex>		lock(_queueLock);
+	if (_ring!=nullptr || _retiredRings.size()>0)	{
+		if (_queueCtx != nullptr)	{
+			_queueCtx->makeCurrentIfNotCurrent();
+			if (_ring != nullptr)
+				_deleteRing(_ring);
+			for (const auto & ring : _retiredRings)
+				_deleteRing(ring);
+		}
+		_ring = nullptr;
+		_retiredRings.clear();
+	}
 }
 void GLCPUToTexCopier::clearStream()	{
 	lock_guard<recursive_mutex>		lock(_queueLock);
@@ -85,9 +99,17 @@ void GLCPUToTexCopier::_beginProcessing(const GLBufferRef & inCPUBuffer, const G
 		size_t		pboBPR = inPBOBuffer->desc.bytesPerRowForWidth(static_cast<uint32_t>(inPBOBuffer->size.width));
 		uint8_t		*rPtr = (uint8_t*)inCPUBuffer->cpuBackingPtr;
 		uint8_t		*wPtr = (uint8_t*)inPBOBuffer->cpuBackingPtr;
+		PixelLayout		cpuLayout = PixelLayoutForDescriptor(inCPUBuffer->desc);
+		PixelLayout		pboLayout = PixelLayoutForDescriptor(inPBOBuffer->desc);
+		uint32_t		copyWidth = static_cast<uint32_t>(fmin(inCPUBuffer->size.width, inPBOBuffer->size.width));
+		uint32_t		copyHeight = static_cast<uint32_t>(fmin(inCPUBuffer->size.height, inPBOBuffer->size.height));
 
-		//	if the cpu buffer's bytes per row differs from the PBO's bytes per row, we have to copy one row at a time
-		if (cpuBPR != pboBPR)	{
+		//	if we know both layouts, convert (or just copy) the pixels straight into the mapped PBO- large images are split across worker threads
+		if (ConvertPixels(rPtr, cpuBPR, cpuLayout, wPtr, pboBPR, pboLayout, copyWidth, copyHeight))	{
+			//	intentionally blank
+		}
+		//	else if the cpu buffer's bytes per row differs from the PBO's bytes per row, we have to copy one row at a time
+		else if (cpuBPR != pboBPR)	{
 			size_t		copyBytesPerRow = (cpuBPR<pboBPR) ? cpuBPR : pboBPR;
 			for (int i=0; i<inPBOBuffer->size.height; ++i)	{
 				memcpy(wPtr, rPtr, copyBytesPerRow);
@@ -140,8 +162,7 @@ void GLCPUToTexCopier::_finishProcessing(const GLBufferRef & inCPUBuffer, const
 		glEnable(inTexBuffer->desc.target);
 		GLERRLOG
 	}
-	glBindTexture(inTexBuffer->desc.target, inTexBuffer->name);
-	GLERRLOG
+	GLStateCache::BindTexture(inTexBuffer->desc.target, inTexBuffer->name);
 	
 	//	set up some pixel transfer modes
 	glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(inCPUBuffer->size.width));
@@ -176,8 +197,7 @@ void GLCPUToTexCopier::_finishProcessing(const GLBufferRef & inCPUBuffer, const
 	GLERRLOG
 	
 	//	unbind the PBO and texture
-	glBindTexture(inTexBuffer->desc.target, 0);
-	GLERRLOG
+	GLStateCache::ReleaseTexture(inTexBuffer->desc.target);
 	if (myVers==GLVersion_2)	{
 		glDisable(inTexBuffer->desc.target);
 		GLERRLOG
@@ -203,6 +223,348 @@ void GLCPUToTexCopier::_finishProcessing(const GLBufferRef & inCPUBuffer, const
 }
 
 
+//	returns true if a CPU buffer can be uploaded to the texture straight from the ring- GL converts between RGBA/BGRA and 8-bit/float as it uploads, but anything else has to be uploaded to a texture in the same layout
+static bool RingCanUploadTo(const GLBuffer::Descriptor & inCPUDesc, const GLBuffer::Descriptor & inTexDesc)	{
+	PixelLayout		cpuLayout = PixelLayoutForDescriptor(inCPUDesc);
+	PixelLayout		texLayout = PixelLayoutForDescriptor(inTexDesc);
+	if (cpuLayout==PixelLayout_Unknown || texLayout==PixelLayout_Unknown)
+		return false;
+	if (cpuLayout == texLayout)
+		return true;
+	auto			isRGBAOrBGRA = [](const PixelLayout & n)	{
+		return (n==PixelLayout_RGBA8 || n==PixelLayout_BGRA8 || n==PixelLayout_RGBA32F || n==PixelLayout_BGRA32F);
+	};
+	return (isRGBAOrBGRA(cpuLayout) && isRGBAOrBGRA(texLayout));
+}
+
+
+bool GLCPUToTexCopier::persistentRingAvailable()	{
+	lock_guard<recursive_mutex>		lock(_queueLock);
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+	//	the ring needs sync objects (core as of GL 3.2) and buffer storage (core in GL 4.4, older contexts may have ARB_buffer_storage- GLEW leaves the function ptr null if the context doesn't support it)
+	if (_queueCtx == nullptr)
+		return false;
+	if (_queueCtx->version!=GLVersion_33 && _queueCtx->version!=GLVersion_4)
+		return false;
+	return (glBufferStorage != nullptr);
+#else
+	return false;
+#endif
+}
+void GLCPUToTexCopier::setPersistentRingSlotCount(const int & n)	{
+	lock_guard<recursive_mutex>		lock(_queueLock);
+	_ringSlotCount = max(n, 2);
+}
+GLBufferRef GLCPUToTexCopier::createRingCPUBuffer(const Size & inSize, const PixelLayout & inLayout, const bool & createInCurrentContext)	{
+	if (inSize.width<1. || inSize.height<1.)
+		return nullptr;
+	if (!persistentRingAvailable())
+		return nullptr;
+	
+	//	figure out how much memory the image needs
+	size_t			bytesPerRow = BytesPerPixelForLayout(inLayout) * static_cast<size_t>(round(inSize.width));
+	size_t			imageBytes = bytesPerRow * static_cast<size_t>(round(inSize.height));
+	if (imageBytes==0 || inLayout==PixelLayout_RGBA16F)
+		return nullptr;
+	
+	lock_guard<recursive_mutex>		lock(_queueLock);
+	
+	GLBufferPoolRef		bp = (_privatePool!=nullptr) ? _privatePool : GetGlobalBufferPool();
+	if (bp == nullptr)
+		return nullptr;
+	//	make the queue context current if appropriate- otherwise we are to assume that a GL context is current in this thread
+	if (!createInCurrentContext)
+		_queueCtx->makeCurrentIfNotCurrent();
+	
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+	//	if there's no ring (or its slots are too small or the slot count changed) we need to make a new one.  the old ring is retired- it's deleted as soon as none of its slots are in use.
+	if (_ring==nullptr || _ring->slotSize<imageBytes || static_cast<int>(_ring->ringSlots.size())!=_ringSlotCount)	{
+		if (_ring != nullptr)
+			_retiredRings.push_back(_ring);
+		_ring = nullptr;
+		
+		shared_ptr<PersistentRing>		newRing = make_shared<PersistentRing>();
+		//	every slot starts on a page boundary
+		newRing->slotSize = ((imageBytes + 4095) / 4096) * 4096;
+		newRing->ringSlots.resize(static_cast<size_t>(_ringSlotCount));
+		size_t			totalBytes = newRing->slotSize * newRing->ringSlots.size();
+		GLbitfield		flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		
+		glGenBuffers(1, &newRing->name);
+		GLERRLOG
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, newRing->name);
+		GLERRLOG
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(totalBytes), nullptr, flags);
+		GLERRLOG
+		newRing->basePtr = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(totalBytes), flags));
+		GLERRLOG
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		GLERRLOG
+		if (newRing->basePtr == nullptr)	{
+			cout << "\tERR: couldnt map persistent ring, " << __PRETTY_FUNCTION__ << endl;
+			_deleteRing(newRing);
+			return nullptr;
+		}
+		_ring = newRing;
+	}
+	
+	//	free the slots that the GPU has finished reading (waiting for the oldest if there aren't any free slots)
+	_reclaimRingSlots(true);
+	
+	//	find a free slot
+	shared_ptr<PersistentRing>		ring = _ring;
+	size_t			slotIndex = 0;
+	uint64_t		generation = 0;
+	bool			foundSlot = false;
+	{
+		lock_guard<mutex>		ringLock(ring->lock);
+		for (size_t i=0; i<ring->ringSlots.size(); ++i)	{
+			RingSlot		&slot = ring->ringSlots[i];
+			if (slot.state == RingSlot::State_Free)	{
+				slot.state = RingSlot::State_Writing;
+				generation = ++slot.generation;
+				slotIndex = i;
+				foundSlot = true;
+				break;
+			}
+		}
+	}
+	if (!foundSlot)
+		return nullptr;
+	
+	//	when the buffer is released, its slot is returned to the ring- unless it was uploaded (or the slot has been vended again since then)
+	void			*slotPtr = ring->basePtr + (slotIndex * ring->slotSize);
+	GLBuffer::BackingReleaseCallback		releaseCallback = [ring,slotIndex,generation](GLBuffer & /*inBuffer*/, void * /*inReleaseContext*/)	{
+		lock_guard<mutex>		ringLock(ring->lock);
+		RingSlot		&slot = ring->ringSlots[slotIndex];
+		if (slot.generation==generation && slot.state==RingSlot::State_Writing)
+			slot.state = RingSlot::State_Free;
+	};
+	
+	GLBufferRef		returnMe = nullptr;
+	switch (inLayout)	{
+	case PixelLayout_RGBA8:
+		returnMe = CreateRGBACPUBufferUsing(inSize, slotPtr, inSize, ring.get(), releaseCallback, bp);
+		break;
+	case PixelLayout_BGRA8:
+		returnMe = CreateBGRACPUBufferUsing(inSize, slotPtr, inSize, ring.get(), releaseCallback, bp);
+		break;
+	case PixelLayout_RGBA32F:
+		returnMe = CreateRGBAFloatCPUBufferUsing(inSize, slotPtr, inSize, ring.get(), releaseCallback, bp);
+		break;
+	case PixelLayout_BGRA32F:
+		returnMe = CreateBGRAFloatCPUBufferUsing(inSize, slotPtr, inSize, ring.get(), releaseCallback, bp);
+		break;
+	case PixelLayout_UYVY:
+		returnMe = CreateYCbCrCPUBufferUsing(inSize, slotPtr, inSize, ring.get(), releaseCallback, bp);
+		break;
+	default:
+		break;
+	}
+	if (returnMe == nullptr)	{
+		lock_guard<mutex>		ringLock(ring->lock);
+		ring->ringSlots[slotIndex].state = RingSlot::State_Free;
+		return nullptr;
+	}
+	returnMe->backingID = GLBuffer::BackingID_PersistentPBO;
+	return returnMe;
+#else
+	//	persistently mapped buffers (glBufferStorage) aren't available in this SDK's headers
+	return nullptr;
+#endif
+}
+shared_ptr<GLCPUToTexCopier::PersistentRing> GLCPUToTexCopier::_ringForBuffer(const GLBufferRef & inCPUBuffer, size_t & outSlotIndex)	{
+	if (inCPUBuffer==nullptr || inCPUBuffer->backingID!=GLBuffer::BackingID_PersistentPBO || inCPUBuffer->backingContext==nullptr)
+		return nullptr;
+	auto			slotIndexInRing = [&](const shared_ptr<PersistentRing> & inRing)	{
+		return static_cast<size_t>(static_cast<uint8_t*>(inCPUBuffer->cpuBackingPtr) - inRing->basePtr) / inRing->slotSize;
+	};
+	if (_ring!=nullptr && _ring.get()==inCPUBuffer->backingContext)	{
+		outSlotIndex = slotIndexInRing(_ring);
+		return _ring;
+	}
+	for (const auto & ring : _retiredRings)	{
+		if (ring.get() == inCPUBuffer->backingContext)	{
+			outSlotIndex = slotIndexInRing(ring);
+			return ring;
+		}
+	}
+	//	the buffer was vended by another copier
+	return nullptr;
+}
+void GLCPUToTexCopier::_uploadFromRing(const GLBufferRef & inCPUBuffer, const GLBufferRef & inTexBuffer)	{
+	size_t			slotIndex = 0;
+	shared_ptr<PersistentRing>		ring = _ringForBuffer(inCPUBuffer, slotIndex);
+	if (ring==nullptr || inTexBuffer==nullptr)
+		return;
+	
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+	GLVersion		myVers = _queueCtx->version;
+	//	bind the ring and texture
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring->name);
+	GLERRLOG
+	if (myVers==GLVersion_2)	{
+		glEnable(inTexBuffer->desc.target);
+		GLERRLOG
+	}
+	GLStateCache::BindTexture(inTexBuffer->desc.target, inTexBuffer->name);
+	
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(inCPUBuffer->size.width));
+	GLERRLOG
+	glPixelStorei(GL_UNPACK_SWAP_BYTES, (_swapBytes) ? GL_TRUE : GL_FALSE);
+	GLERRLOG
+	
+	//	upload straight from the slot- the pixels are described using the CPU buffer's format/type (GL converts them to the texture's format if necessary).  the ring is mapped coherently, so the GPU sees everything written to the slot before this call.
+	glTexSubImage2D(inTexBuffer->desc.target,
+		0,
+		0,
+		0,
+		static_cast<GLsizei>(inCPUBuffer->srcRect.size.width),
+		static_cast<GLsizei>(inCPUBuffer->srcRect.size.height),
+		inCPUBuffer->desc.pixelFormat,
+		inCPUBuffer->desc.pixelType,
+		reinterpret_cast<const void*>(slotIndex * ring->slotSize));
+	GLERRLOG
+	
+	glPixelStorei(GL_UNPACK_SWAP_BYTES, GL_FALSE);
+	GLERRLOG
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	GLERRLOG
+	GLStateCache::ReleaseTexture(inTexBuffer->desc.target);
+	if (myVers==GLVersion_2)	{
+		glDisable(inTexBuffer->desc.target);
+		GLERRLOG
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	GLERRLOG
+	
+	//	fence the upload- the slot can't be reused until the GPU has finished reading it
+	GLsync			fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	GLERRLOG
+	glFlush();
+	GLERRLOG
+	{
+		lock_guard<mutex>		ringLock(ring->lock);
+		RingSlot		&slot = ring->ringSlots[slotIndex];
+		if (slot.fence != nullptr)
+			glDeleteSync(slot.fence);
+		slot.fence = fence;
+		slot.state = RingSlot::State_InFlight;
+	}
+	
+	//	timestamp the buffer...
+	GLBufferPoolRef		bp = (_privatePool==nullptr) ? GetGlobalBufferPool() : _privatePool;
+	if (bp != nullptr)
+		bp->timestampThisBuffer(inTexBuffer);
+	
+	//	make sure the texture inherits the source's flippedness and timestamp
+	inTexBuffer->flipped = inCPUBuffer->flipped;
+	inTexBuffer->contentTimestamp = inCPUBuffer->contentTimestamp;
+#endif
+}
+void GLCPUToTexCopier::_reclaimRingSlots(const bool & inWait)	{
+	//	frees the in-flight slots in the passed ring whose fences have been signaled, returns the number of free slots
+	auto			reclaim = [](const shared_ptr<PersistentRing> & inRing)	{
+		int				returnMe = 0;
+		lock_guard<mutex>		ringLock(inRing->lock);
+		for (auto & slot : inRing->ringSlots)	{
+			if (slot.state==RingSlot::State_InFlight && slot.fence!=nullptr)	{
+				GLenum			waitResult = glClientWaitSync(slot.fence, 0, 0);
+				GLERRLOG
+				if (waitResult == GL_TIMEOUT_EXPIRED)
+					continue;
+				if (waitResult == GL_WAIT_FAILED)
+					cout << "\tERR: glClientWaitSync() failed, " << __PRETTY_FUNCTION__ << endl;
+				glDeleteSync(slot.fence);
+				slot.fence = nullptr;
+				slot.state = RingSlot::State_Free;
+			}
+			if (slot.state == RingSlot::State_Free)
+				++returnMe;
+		}
+		return returnMe;
+	};
+	
+	//	delete retired rings as soon as none of their slots are in use
+	for (auto it=_retiredRings.begin(); it!=_retiredRings.end(); )	{
+		if (reclaim(*it) == static_cast<int>((*it)->ringSlots.size()))	{
+			_deleteRing(*it);
+			it = _retiredRings.erase(it);
+		}
+		else
+			++it;
+	}
+	
+	if (_ring == nullptr)
+		return;
+	if (reclaim(_ring)>0 || !inWait)
+		return;
+	
+	//	there aren't any free slots- if any are in flight, wait for the one that was vended first (without the ring's lock held, so buffers can still be released on other threads)
+	GLsync			oldestFence = nullptr;
+	{
+		lock_guard<mutex>		ringLock(_ring->lock);
+		uint64_t		oldestGeneration = 0;
+		for (const auto & slot : _ring->ringSlots)	{
+			if (slot.state==RingSlot::State_InFlight && slot.fence!=nullptr && (oldestFence==nullptr || slot.generation<oldestGeneration))	{
+				oldestFence = slot.fence;
+				oldestGeneration = slot.generation;
+			}
+		}
+	}
+	if (oldestFence == nullptr)
+		return;
+	GLenum			waitResult = GL_TIMEOUT_EXPIRED;
+	while (waitResult == GL_TIMEOUT_EXPIRED)
+		waitResult = glClientWaitSync(oldestFence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+	GLERRLOG
+	if (waitResult == GL_WAIT_FAILED)
+		cout << "\tERR: glClientWaitSync() failed, " << __PRETTY_FUNCTION__ << endl;
+	reclaim(_ring);
+}
+void GLCPUToTexCopier::_deleteRing(const shared_ptr<PersistentRing> & inRing)	{
+	if (inRing == nullptr)
+		return;
+	lock_guard<mutex>		ringLock(inRing->lock);
+	for (auto & slot : inRing->ringSlots)	{
+		if (slot.fence != nullptr)
+			glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+	}
+	//	deleting the buffer unmaps it
+	if (inRing->name != 0)
+		glDeleteBuffers(1, &inRing->name);
+	inRing->name = 0;
+	inRing->basePtr = nullptr;
+}
+
+
+GLBufferRef GLCPUToTexCopier::_createConvertingPBO(const GLBufferRef & inCPUBuffer, const GLBufferRef & inTexBuffer, const bool & createInCurrentContext, const GLBufferPoolRef & inPool)	{
+#if PATHTYPE==0
+	//	path 0 initializes the PBO with the CPU buffer's memory, so there's no opportunity to convert it
+	return nullptr;
+#elif PATHTYPE==1
+	if (inCPUBuffer==nullptr || inTexBuffer==nullptr)
+		return nullptr;
+	PixelLayout		cpuLayout = PixelLayoutForDescriptor(inCPUBuffer->desc);
+	PixelLayout		texLayout = PixelLayoutForDescriptor(inTexBuffer->desc);
+	if (cpuLayout==texLayout || !CanConvertPixels(cpuLayout, texLayout))
+		return nullptr;
+	switch (texLayout)	{
+	case PixelLayout_RGBA8:
+		return CreateRGBAPBO(GLBuffer::Target_PBOUnpack, GL_STREAM_DRAW, inCPUBuffer->size, NULL, createInCurrentContext, inPool);
+	case PixelLayout_BGRA8:
+		return CreateBGRAPBO(GLBuffer::Target_PBOUnpack, GL_STREAM_DRAW, inCPUBuffer->size, NULL, createInCurrentContext, inPool);
+	case PixelLayout_RGBA32F:
+		return CreateRGBAFloatPBO(GLBuffer::Target_PBOUnpack, GL_STREAM_DRAW, inCPUBuffer->size, NULL, createInCurrentContext, inPool);
+	case PixelLayout_BGRA32F:
+		return CreateBGRAFloatPBO(GLBuffer::Target_PBOUnpack, GL_STREAM_DRAW, inCPUBuffer->size, NULL, createInCurrentContext, inPool);
+	default:
+		break;
+	}
+	return nullptr;
+#endif
+}
 GLBufferRef GLCPUToTexCopier::uploadCPUToTex(const GLBufferRef & inCPUBuffer, const bool & createInCurrentContext)	{
 	if (inCPUBuffer == nullptr)
 		return nullptr;
@@ -258,55 +620,77 @@ GLBufferRef GLCPUToTexCopier::uploadCPUToTex(const GLBufferRef & inCPUBuffer, co
 	if (!createInCurrentContext)
 		_queueCtx->makeCurrentIfNotCurrent();
 	
+	//	if the CPU buffer's memory is a slot in the persistent ring, upload it straight from the slot
+	size_t		ringSlotIndex = 0;
+	if (_ringForBuffer(inCPUBuffer, ringSlotIndex)!=nullptr && RingCanUploadTo(inCPUBuffer->desc, inTexBuffer->desc))	{
+		_uploadFromRing(inCPUBuffer, inTexBuffer);
+		return inTexBuffer;
+	}
+	
 	Size		cpuBufferDims = inCPUBuffer->size;
 	
-	//	create a PBO and a texture for the CPU buffer
-	GLBufferRef		pboBuffer = nullptr;
-	switch (inCPUBuffer->desc.pixelFormat)	{
-	case GLBuffer::PF_RGBA:
-		if (inCPUBuffer->desc.pixelType == GLBuffer::PT_Float)	{
-			pboBuffer = CreateRGBAFloatPBO(
-				GLBuffer::Target_PBOUnpack,
-				GL_STREAM_DRAW,
-				cpuBufferDims,
+	//	create a PBO for the CPU buffer (in the texture's format if the CPU buffer's pixels have to be converted)
+	GLBufferRef		pboBuffer = _createConvertingPBO(inCPUBuffer, inTexBuffer, createInCurrentContext, bp);
+	if (pboBuffer == nullptr)	{
+		switch (inCPUBuffer->desc.pixelFormat)	{
+		case GLBuffer::PF_RGBA:
+			if (inCPUBuffer->desc.pixelType == GLBuffer::PT_Float)	{
+				pboBuffer = CreateRGBAFloatPBO(
+					GLBuffer::Target_PBOUnpack,
+					GL_STREAM_DRAW,
+					cpuBufferDims,
 #if PATHTYPE==0
-				inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
+					inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
 #elif PATHTYPE==1
-				NULL,	//	this will delete-initialize the buffer
+					NULL,	//	this will delete-initialize the buffer
 #endif
-				createInCurrentContext,
-				bp);
-		}
-		else	{
-			pboBuffer = CreateRGBAPBO(
-				GLBuffer::Target_PBOUnpack,
-				GL_STREAM_DRAW,
-				cpuBufferDims,
+					createInCurrentContext,
+					bp);
+			}
+			else	{
+				pboBuffer = CreateRGBAPBO(
+					GLBuffer::Target_PBOUnpack,
+					GL_STREAM_DRAW,
+					cpuBufferDims,
 #if PATHTYPE==0
-				inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
+					inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
 #elif PATHTYPE==1
-				NULL,	//	this will delete-initialize the buffer
+					NULL,	//	this will delete-initialize the buffer
 #endif
-				createInCurrentContext,
-				bp);
-		}
-		break;
-	case GLBuffer::PF_BGRA:
-		if (inCPUBuffer->desc.pixelType == GLBuffer::PT_Float)	{
-			pboBuffer = CreateBGRAFloatPBO(
-				GLBuffer::Target_PBOUnpack,
-				GL_STREAM_DRAW,
-				cpuBufferDims,
+					createInCurrentContext,
+					bp);
+			}
+			break;
+		case GLBuffer::PF_BGRA:
+			if (inCPUBuffer->desc.pixelType == GLBuffer::PT_Float)	{
+				pboBuffer = CreateBGRAFloatPBO(
+					GLBuffer::Target_PBOUnpack,
+					GL_STREAM_DRAW,
+					cpuBufferDims,
 #if PATHTYPE==0
-				inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
+					inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
 #elif PATHTYPE==1
-				NULL,	//	this will delete-initialize the buffer
+					NULL,	//	this will delete-initialize the buffer
 #endif
-				createInCurrentContext,
-				bp);
-		}
-		else	{
-			pboBuffer = CreateBGRAPBO(
+					createInCurrentContext,
+					bp);
+			}
+			else	{
+				pboBuffer = CreateBGRAPBO(
+					GLBuffer::Target_PBOUnpack,
+					GL_STREAM_DRAW,
+					cpuBufferDims,
+#if PATHTYPE==0
+					inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
+#elif PATHTYPE==1
+					NULL,	//	this will delete-initialize the buffer
+#endif
+					createInCurrentContext,
+					bp);
+			}
+			break;
+		case GLBuffer::PF_YCbCr_422:
+			pboBuffer = CreateYCbCrPBO(
 				GLBuffer::Target_PBOUnpack,
 				GL_STREAM_DRAW,
 				cpuBufferDims,
@@ -317,23 +701,10 @@ GLBufferRef GLCPUToTexCopier::uploadCPUToTex(const GLBufferRef & inCPUBuffer, co
 #endif
 				createInCurrentContext,
 				bp);
+			break;
+		default:
+			break;
 		}
-		break;
-	case GLBuffer::PF_YCbCr_422:
-		pboBuffer = CreateYCbCrPBO(
-			GLBuffer::Target_PBOUnpack,
-			GL_STREAM_DRAW,
-			cpuBufferDims,
-#if PATHTYPE==0
-			inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
-#elif PATHTYPE==1
-			NULL,	//	this will delete-initialize the buffer
-#endif
-			createInCurrentContext,
-			bp);
-		break;
-	default:
-		break;
 	}
 	
 	if (pboBuffer==nullptr)
@@ -437,54 +808,75 @@ GLBufferRef GLCPUToTexCopier::streamCPUToTex(const GLBufferRef & inCPUBuffer, co
 	if (tmpQueueSize>=_queueSize && safeToPush)
 		safeToPop = true;
 	
+	//	if the CPU buffer's memory is a slot in the persistent ring, it's uploaded straight from the slot (it doesn't need a PBO)
+	size_t		ringSlotIndex = 0;
+	bool		fromRing = (safeToPush && _ringForBuffer(inCPUBuffer, ringSlotIndex)!=nullptr && RingCanUploadTo(inCPUBuffer->desc, inTexBuffer->desc));
+	
 	//	if we're safe to push, we need to create a PBO and a texture for the CPU buffer
 	GLBufferRef		inPBOBuffer = nullptr;
-	if (safeToPush)	{
-		switch (inCPUBuffer->desc.pixelFormat)	{
-		case GLBuffer::PF_RGBA:
-			if (inCPUBuffer->desc.pixelType == GLBuffer::PT_Float)	{
-				inPBOBuffer = CreateRGBAFloatPBO(
-					GLBuffer::Target_PBOUnpack,
-					GL_STREAM_DRAW,
-					cpuBufferDims,
+	if (safeToPush && !fromRing)	{
+		//	create the PBO in the texture's format if the CPU buffer's pixels have to be converted
+		inPBOBuffer = _createConvertingPBO(inCPUBuffer, inTexBuffer, createInCurrentContext, bp);
+		if (inPBOBuffer == nullptr)	{
+			switch (inCPUBuffer->desc.pixelFormat)	{
+			case GLBuffer::PF_RGBA:
+				if (inCPUBuffer->desc.pixelType == GLBuffer::PT_Float)	{
+					inPBOBuffer = CreateRGBAFloatPBO(
+						GLBuffer::Target_PBOUnpack,
+						GL_STREAM_DRAW,
+						cpuBufferDims,
 #if PATHTYPE==0
-					inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
+						inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
 #elif PATHTYPE==1
-					NULL,	//	this will delete-initialize the buffer
+						NULL,	//	this will delete-initialize the buffer
 #endif
-					createInCurrentContext,
-					bp);
-			}
-			else	{
-				inPBOBuffer = CreateRGBAPBO(
-					GLBuffer::Target_PBOUnpack,
-					GL_STREAM_DRAW,
-					cpuBufferDims,
+						createInCurrentContext,
+						bp);
+				}
+				else	{
+					inPBOBuffer = CreateRGBAPBO(
+						GLBuffer::Target_PBOUnpack,
+						GL_STREAM_DRAW,
+						cpuBufferDims,
 #if PATHTYPE==0
-					inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
+						inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
 #elif PATHTYPE==1
-					NULL,	//	this will delete-initialize the buffer
+						NULL,	//	this will delete-initialize the buffer
 #endif
-					createInCurrentContext,
-					bp);
-			}
-			break;
-		case GLBuffer::PF_BGRA:
-			if (inCPUBuffer->desc.pixelType == GLBuffer::PT_Float)	{
-				inPBOBuffer = CreateBGRAFloatPBO(
-					GLBuffer::Target_PBOUnpack,
-					GL_STREAM_DRAW,
-					cpuBufferDims,
+						createInCurrentContext,
+						bp);
+				}
+				break;
+			case GLBuffer::PF_BGRA:
+				if (inCPUBuffer->desc.pixelType == GLBuffer::PT_Float)	{
+					inPBOBuffer = CreateBGRAFloatPBO(
+						GLBuffer::Target_PBOUnpack,
+						GL_STREAM_DRAW,
+						cpuBufferDims,
 #if PATHTYPE==0
-					inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
+						inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
 #elif PATHTYPE==1
-					NULL,	//	this will delete-initialize the buffer
+						NULL,	//	this will delete-initialize the buffer
 #endif
-					createInCurrentContext,
-					bp);
-			}
-			else	{
-				inPBOBuffer = CreateBGRAPBO(
+						createInCurrentContext,
+						bp);
+				}
+				else	{
+					inPBOBuffer = CreateBGRAPBO(
+						GLBuffer::Target_PBOUnpack,
+						GL_STREAM_DRAW,
+						cpuBufferDims,
+#if PATHTYPE==0
+						inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
+#elif PATHTYPE==1
+						NULL,	//	this will delete-initialize the buffer
+#endif
+						createInCurrentContext,
+						bp);
+				}
+				break;
+			case GLBuffer::PF_YCbCr_422:
+				inPBOBuffer = CreateYCbCrPBO(
 					GLBuffer::Target_PBOUnpack,
 					GL_STREAM_DRAW,
 					cpuBufferDims,
@@ -495,23 +887,10 @@ GLBufferRef GLCPUToTexCopier::streamCPUToTex(const GLBufferRef & inCPUBuffer, co
 #endif
 					createInCurrentContext,
 					bp);
+				break;
+			default:
+				break;
 			}
-			break;
-		case GLBuffer::PF_YCbCr_422:
-			inPBOBuffer = CreateYCbCrPBO(
-				GLBuffer::Target_PBOUnpack,
-				GL_STREAM_DRAW,
-				cpuBufferDims,
-#if PATHTYPE==0
-				inCPUBuffer->cpuBackingPtr,	//	this will initialize the buffer with the provided backing
-#elif PATHTYPE==1
-				NULL,	//	this will delete-initialize the buffer
-#endif
-				createInCurrentContext,
-				bp);
-			break;
-		default:
-			break;
 		}
 		
 		//	if we couldn't create the buffers we need then we're not safe to push, and if we're not safe to push then we're not safe to pop.
@@ -539,7 +918,11 @@ GLBufferRef GLCPUToTexCopier::streamCPUToTex(const GLBufferRef & inCPUBuffer, co
 		_cpuQueue.push(inCPUBuffer);
 		_pboQueue.push(inPBOBuffer);
 		_texQueue.push(inTexBuffer);
-		_beginProcessing(inCPUBuffer, inPBOBuffer, inTexBuffer);
+		//	ring buffers are uploaded immediately (the upload is fenced, and the texture is returned when it's popped off the queue)
+		if (fromRing)
+			_uploadFromRing(inCPUBuffer, inTexBuffer);
+		else
+			_beginProcessing(inCPUBuffer, inPBOBuffer, inTexBuffer);
 	}
 	
 	return returnMe;
@@ -1,6 +1,8 @@
 #include "GLCachedProperty.hpp"
 #include "GLContext.hpp"
 
+#include <cstring>
+
 
 
 
@@ -18,6 +20,10 @@ void GLCachedProperty::cacheTheLoc(const int32_t & /*inPgmToCheck*/)
 {
 	//	subclasses of this should override this member function and cache the location and program here as appropriate
 }
+void GLCachedProperty::cacheTheLoc(const GLProgramReflection & /*inReflection*/)
+{
+	//	subclasses of this should override this member function and cache the location and program here as appropriate
+}
 
 
 
@@ -38,6 +44,11 @@ void GLCachedAttrib::cacheTheLoc(const int32_t & inPgmToCheck)	{
 		prog = -1;
 	}
 }
+void GLCachedAttrib::cacheTheLoc(const GLProgramReflection & inReflection)	{
+	//	the program is cached even if the attrib isn't in it, so location() doesn't look it up again
+	prog = static_cast<int32_t>(inReflection.program());
+	loc = inReflection.attribLocation(name);
+}
 void GLCachedAttrib::enable()	{
 	if (loc >= 0)	{
 		glEnableVertexAttribArray(loc);
@@ -72,6 +83,52 @@ void GLCachedUni::cacheTheLoc(const int32_t & inPgmToCheck)	{
 		//cout << "\terr: checked, uni for \"" << name << "\" not present.\n";
 		prog = -1;
 	}
+	//	the uniform (or the program) may be new, so we don't know what its value is
+	_sentSize = 0;
+}
+void GLCachedUni::cacheTheLoc(const GLProgramReflection & inReflection)	{
+	//	the program is cached even if the uniform isn't in it, so location() doesn't look it up again
+	prog = static_cast<int32_t>(inReflection.program());
+	loc = inReflection.uniformLocation(name);
+	_sentSize = 0;
+}
+bool GLCachedUni::set1i(const int32_t & n)	{
+	if (loc < 0 || !_changedSentVal(&n, sizeof(n)))
+		return false;
+	glUniform1i(loc, n);
+	GLERRLOG
+	return true;
+}
+bool GLCachedUni::set1f(const float & n)	{
+	if (loc < 0 || !_changedSentVal(&n, sizeof(n)))
+		return false;
+	glUniform1f(loc, n);
+	GLERRLOG
+	return true;
+}
+bool GLCachedUni::set2f(const float & n0, const float & n1)	{
+	float		tmpVals[2] = { n0, n1 };
+	if (loc < 0 || !_changedSentVal(tmpVals, sizeof(tmpVals)))
+		return false;
+	glUniform2f(loc, n0, n1);
+	GLERRLOG
+	return true;
+}
+bool GLCachedUni::set4f(const float & n0, const float & n1, const float & n2, const float & n3)	{
+	float		tmpVals[4] = { n0, n1, n2, n3 };
+	if (loc < 0 || !_changedSentVal(tmpVals, sizeof(tmpVals)))
+		return false;
+	glUniform4f(loc, n0, n1, n2, n3);
+	GLERRLOG
+	return true;
+}
+bool GLCachedUni::_changedSentVal(const void * inVal, const size_t & inSize)	{
+	//	values are compared bitwise (so -0 and 0 are different values, which only costs an extra call)
+	if (inSize == _sentSize && memcmp(_sentVal, inVal, inSize) == 0)
+		return false;
+	memcpy(_sentVal, inVal, inSize);
+	_sentSize = inSize;
+	return true;
 }
 
 
@@ -1,8 +1,11 @@
 #include "GLContext.hpp"
+#include "GLDebugLog.hpp"
 
 #include <iostream>
 //#include <cassert>
 #include <regex>
+#include <atomic>
+#include <sstream>
 
 
 
@@ -17,6 +20,8 @@
 #include "GLContext_Qt.txt"
 #elif defined(VVGL_SDK_WIN)
 #include "GLContext_Win.txt"
+#elif defined(VVGL_SDK_EGL)
+#include "GLContext_EGL.txt"
 #endif
 
 
@@ -71,7 +76,7 @@ using namespace std;
 void GLContext::calculateVersion()	{
 	//cout << __PRETTY_FUNCTION__ << endl;
 	version = GLVersion_Unknown;
-#if defined(VVGL_SDK_MAC) || defined(VVGL_SDK_IOS) || defined(VVGL_SDK_RPI) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN)
+#if defined(VVGL_SDK_MAC) || defined(VVGL_SDK_IOS) || defined(VVGL_SDK_RPI) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
 	if (ctx == nullptr)
 		return;
 #elif defined(VVGL_SDK_GLFW)
@@ -128,6 +133,112 @@ void GLContext::calculateVersion()	{
 	GLERRLOG
 	//cout << "\traw renderer string is " << rendererString << endl;
 	_renderer = std::string(rendererString);
+	
+	//	if debug output is enabled, install the debug message callback while the context is current
+	if (GLDebugLog::Enabled())
+		GLDebugLog::InstallOnCurrentContext();
+}
+
+
+
+
+#pragma mark ******************************************** CURRENT CONTEXT CACHE
+
+
+//	the context that was last made current on each thread (and its native context), so makeCurrentIfNotCurrent() can usually skip the SDK
+//	entirely.  contexts are identified by an instance ID rather than their address, so a context allocated where a deleted one used to be can't
+//	be mistaken for it.
+struct CurrentContextCache	{
+	uint64_t			instanceID = 0;
+	void				*nativeCtx = nullptr;
+};
+static thread_local CurrentContextCache		_currentContextCache;
+static atomic<uint64_t>		_nextInstanceID { 1 };
+static thread_local GLContext::SwitchStats	_threadSwitchStats;
+
+struct GlobalSwitchStats	{
+	atomic<uint64_t>		requests { 0 };
+	atomic<uint64_t>		cacheHits { 0 };
+	atomic<uint64_t>		switches { 0 };
+};
+static GlobalSwitchStats		_globalSwitchStats;
+
+
+string GLContext::SwitchStats::getDescriptionString() const	{
+	ostringstream	returnMe;
+	returnMe << "<GLContext::SwitchStats requests:" << requests << " cacheHits:" << cacheHits << " switches:" << switches << ">";
+	return returnMe.str();
+}
+GLContext::SwitchStats GLContext::GetThreadSwitchStats()	{
+	return _threadSwitchStats;
+}
+GLContext::SwitchStats GLContext::SnapshotAndResetThreadSwitchStats()	{
+	SwitchStats		returnMe = _threadSwitchStats;
+	_threadSwitchStats = SwitchStats();
+	return returnMe;
+}
+GLContext::SwitchStats GLContext::GetSwitchStats()	{
+	SwitchStats		returnMe;
+	returnMe.requests = _globalSwitchStats.requests.load(memory_order_relaxed);
+	returnMe.cacheHits = _globalSwitchStats.cacheHits.load(memory_order_relaxed);
+	returnMe.switches = _globalSwitchStats.switches.load(memory_order_relaxed);
+	return returnMe;
+}
+GLContext::SwitchStats GLContext::SnapshotAndResetSwitchStats()	{
+	SwitchStats		returnMe;
+	returnMe.requests = _globalSwitchStats.requests.exchange(0, memory_order_relaxed);
+	returnMe.cacheHits = _globalSwitchStats.cacheHits.exchange(0, memory_order_relaxed);
+	returnMe.switches = _globalSwitchStats.switches.exchange(0, memory_order_relaxed);
+	return returnMe;
+}
+void GLContext::_countCurrentContextRequest()	{
+	++_threadSwitchStats.requests;
+	_globalSwitchStats.requests.fetch_add(1, memory_order_relaxed);
+}
+void GLContext::InvalidateCurrentContextCache()	{
+	_currentContextCache = CurrentContextCache();
+}
+bool GLContext::_isCachedAsCurrentContext() const	{
+	return (_currentContextCache.instanceID == _instanceID && _currentContextCache.nativeCtx != nullptr);
+}
+void * GLContext::_CachedCurrentNativeContext()	{
+	return _currentContextCache.nativeCtx;
+}
+uint64_t GLContext::_NewInstanceID()	{
+	return _nextInstanceID.fetch_add(1, memory_order_relaxed);
+}
+bool GLContext::_currentContextCacheHit()	{
+	_countCurrentContextRequest();
+	if (_currentContextCache.instanceID != _instanceID || _currentContextCache.nativeCtx == nullptr)
+		return false;
+#if !defined(VVGL_SDK_EGL)
+	//	apps and SDKs (QOpenGLWidget, NSOpenGLView, glfwMakeContextCurrent()...) routinely make contexts current without going through
+	//	GLContext, so the cached context is checked against the SDK's current context.  these SDKs track the current context in a
+	//	thread-local var of their own, so checking is cheap.  under EGL the query goes through libglvnd's dispatch, which costs as much as
+	//	the rest of the call put together- the cache is trusted, and code that calls eglMakeCurrent() itself must invalidate it.
+	if (_NativeCurrentContextHandle() != _currentContextCache.nativeCtx)	{
+		_currentContextCache = CurrentContextCache();
+		return false;
+	}
+#endif
+	++_threadSwitchStats.cacheHits;
+	_globalSwitchStats.cacheHits.fetch_add(1, memory_order_relaxed);
+	return true;
+}
+void GLContext::_cacheAsCurrentContext(void * inPrevNativeCtx)	{
+	void			*nativeCtx = _nativeContextHandle();
+	void			*currentNativeCtx = _NativeCurrentContextHandle();
+	if (currentNativeCtx != inPrevNativeCtx)	{
+		++_threadSwitchStats.switches;
+		_globalSwitchStats.switches.fetch_add(1, memory_order_relaxed);
+	}
+	//	only cache the context if it's actually current (making it current may have failed, or it may have been a no-op)
+	if (nativeCtx != nullptr && currentNativeCtx == nativeCtx)	{
+		_currentContextCache.instanceID = _instanceID;
+		_currentContextCache.nativeCtx = nativeCtx;
+	}
+	else if (_currentContextCache.nativeCtx != currentNativeCtx)
+		_currentContextCache = CurrentContextCache();
 }
 
 
@@ -117,26 +117,42 @@ void GLContext::generalInit()	{
 #pragma mark --------------------- public methods
 
 
+void * GLContext::_nativeContextHandle() const	{
+	return ctx;
+}
+void * GLContext::_NativeCurrentContextHandle()	{
+	return (void *)[EAGLContext currentContext];
+}
 void GLContext::makeCurrent()	{
 	//cout << __PRETTY_FUNCTION__ << ", ctx is " << ctx << endl;
+	_countCurrentContextRequest();
 	if (ctx != nil)	{
+		void		*origCtx = _NativeCurrentContextHandle();
 		//[(EAGLContext *)ctx setCurrent];
 		[EAGLContext setCurrentContext:(EAGLContext *)ctx];
+		_cacheAsCurrentContext(origCtx);
 	}
 	
 }
 void GLContext::makeCurrentIfNotCurrent()	{
 	//cout << __PRETTY_FUNCTION__ << ", ctx is " << ctx << endl;
-	if ([EAGLContext currentContext] != (EAGLContext *)ctx)	{
+	if (_currentContextCacheHit())
+		return;
+	void		*origCtx = _NativeCurrentContextHandle();
+	if (origCtx != ctx)	{
 		//[(EAGLContext *)ctx setCurrent];
 		[EAGLContext setCurrentContext:(EAGLContext *)ctx];
 	}
+	_cacheAsCurrentContext(origCtx);
 }
 void GLContext::makeCurrentIfNull()	{
 	//cout << __PRETTY_FUNCTION__ << ", ctx is " << ctx << endl;
-	if ([EAGLContext currentContext] == nil)	{
+	_countCurrentContextRequest();
+	void		*origCtx = _NativeCurrentContextHandle();
+	if (origCtx == nil)	{
 		//[(EAGLContext *)ctx setCurrent];
 		[EAGLContext setCurrentContext:(EAGLContext *)ctx];
+		_cacheAsCurrentContext(origCtx);
 	}
 }
 bool GLContext::sameShareGroupAs(const GLContextRef & inCtx)	{
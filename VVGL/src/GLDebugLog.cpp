@@ -0,0 +1,291 @@
+#include "GLDebugLog.hpp"
+#include "GLContext.hpp"
+
+#include <mutex>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+
+
+
+
+namespace VVGL
+{
+
+
+using namespace std;
+
+
+
+
+//	the number of messages the log holds- if more messages than this are added between drains, the oldest are dropped
+#define LOG_SIZE 256
+//	the max length (including the null terminator) of the text and group label copied into each entry
+#define TEXT_SIZE 256
+#define GROUP_SIZE 64
+
+
+//	an entry in the ring buffer.  'seq' is odd while the entry is being written and even once it's been written (it's 2*(index+1) for
+//	the message at 'index')- readers copy the entry and check that 'seq' didn't change while they were copying it.
+struct GLDebugLogEntry	{
+	atomic<uint64_t>		seq { 0 };
+	uint32_t				source = 0;
+	uint32_t				type = 0;
+	uint32_t				id = 0;
+	uint32_t				severity = 0;
+	char					group[GROUP_SIZE];
+	char					text[TEXT_SIZE];
+};
+
+
+atomic<bool>						GLDebugLog::_enabled { false };
+static atomic<bool>					_synchronous { true };
+
+static GLDebugLogEntry				_log[LOG_SIZE];
+static atomic<uint64_t>				_writeIndex { 0 };
+//	only DrainMessages() reads the log, and it holds this lock while it does
+static mutex						_drainLock;
+static uint64_t						_readIndex = 0;
+
+static atomic<uint64_t>				_messageCount { 0 };
+static atomic<uint64_t>				_errorCount { 0 };
+static atomic<uint64_t>				_droppedCount { 0 };
+static atomic<uint64_t>				_attributedCount { 0 };
+
+static atomic<GLDebugLog::Site*>	_sites { nullptr };
+
+//	the labels of the groups that are open on this thread (innermost last)
+static thread_local vector<string>	_groupStack;
+//	the number of messages raised on this thread since the last call site was marked
+static thread_local uint64_t		_pendingSiteMessages = 0;
+
+
+
+
+#pragma mark --------------------- debug message callback
+
+
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+static void GLAPIENTRY DebugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar * message, const void * /*userParam*/)	{
+	if (!GLDebugLog::Enabled())
+		return;
+	GLDebugLog::AppendMessage(source, type, id, severity, message, length);
+	//	if the message was delivered synchronously, the next GLERRLOG on this thread is the one after the call that raised it
+	++_pendingSiteMessages;
+}
+#endif
+
+
+
+
+#pragma mark --------------------- structs
+
+
+string GLDebugLog::Message::getDescriptionString() const	{
+	ostringstream	returnMe;
+	returnMe << "<GLDebugLog::Message type 0x" << hex << type << ", id 0x" << id << dec;
+	if (group.size() > 0)
+		returnMe << " in \"" << group << "\"";
+	returnMe << ": " << text << ">";
+	return returnMe.str();
+}
+string GLDebugLog::Stats::getDescriptionString() const	{
+	ostringstream	returnMe;
+	returnMe << "<GLDebugLog::Stats messages:" << messages << " errors:" << errors << " dropped:" << dropped << " attributed:" << attributed << ">";
+	return returnMe.str();
+}
+
+
+GLDebugLog::Site::Site(const char * inFile, const int & inLine) : file(inFile), line(inLine)	{
+	GLDebugLog::_RegisterSite(this);
+}
+
+
+GLDebugLog::Group::Group(const string & inLabel)	{
+	if (!GLDebugLog::Enabled() || inLabel.size() < 1)
+		return;
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+	if (glPushDebugGroup == nullptr || glPopDebugGroup == nullptr)
+		return;
+	glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, inLabel.c_str());
+	GLERRLOG
+	_groupStack.push_back(inLabel);
+	_pushed = true;
+#endif
+}
+GLDebugLog::Group::~Group()	{
+	if (!_pushed)
+		return;
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+	glPopDebugGroup();
+	GLERRLOG
+#endif
+	if (_groupStack.size() > 0)
+		_groupStack.pop_back();
+}
+
+
+
+
+#pragma mark --------------------- static methods
+
+
+void GLDebugLog::SetEnabled(const bool & n, const bool & inSynchronous)	{
+	_synchronous.store(inSynchronous, memory_order_relaxed);
+	_enabled.store(n, memory_order_relaxed);
+}
+bool GLDebugLog::InstallOnCurrentContext()	{
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+	if (glDebugMessageCallback == nullptr || glDebugMessageControl == nullptr)
+		return false;
+	glEnable(GL_DEBUG_OUTPUT);
+	GLERRLOG
+	if (_synchronous.load(memory_order_relaxed))
+		glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	else
+		glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	GLERRLOG
+	glDebugMessageCallback(DebugMessageCallback, nullptr);
+	GLERRLOG
+	//	we don't want notifications (some drivers send one every time a buffer is allocated), or the messages generated by our own groups
+	glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+	GLERRLOG
+	glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PUSH_GROUP, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+	GLERRLOG
+	glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_POP_GROUP, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+	GLERRLOG
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+void GLDebugLog::AppendMessage(const uint32_t & inSource, const uint32_t & inType, const uint32_t & inID, const uint32_t & inSeverity, const char * inText, const int32_t & inLength)	{
+	_messageCount.fetch_add(1, memory_order_relaxed);
+#if defined(GL_DEBUG_TYPE_ERROR)
+	if (inType == GL_DEBUG_TYPE_ERROR)
+		_errorCount.fetch_add(1, memory_order_relaxed);
+#endif
+
+	//	claim an entry, mark it as being written
+	uint64_t			index = _writeIndex.fetch_add(1, memory_order_relaxed);
+	GLDebugLogEntry		&entry = _log[index % LOG_SIZE];
+	entry.seq.store(index*2+1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+
+	entry.source = inSource;
+	entry.type = inType;
+	entry.id = inID;
+	entry.severity = inSeverity;
+
+	size_t				textLength = (inText==nullptr) ? 0 : (inLength<0) ? strlen(inText) : static_cast<size_t>(inLength);
+	textLength = min(textLength, static_cast<size_t>(TEXT_SIZE-1));
+	if (textLength > 0)
+		memcpy(entry.text, inText, textLength);
+	entry.text[textLength] = 0;
+
+	size_t				groupLength = 0;
+	if (_groupStack.size() > 0)	{
+		const string		&group = _groupStack.back();
+		groupLength = min(group.size(), static_cast<size_t>(GROUP_SIZE-1));
+		memcpy(entry.group, group.c_str(), groupLength);
+	}
+	entry.group[groupLength] = 0;
+
+	//	the entry's been written
+	entry.seq.store(index*2+2, memory_order_release);
+}
+vector<GLDebugLog::Message> GLDebugLog::DrainMessages()	{
+	vector<Message>		returnMe;
+	lock_guard<mutex>	lock(_drainLock);
+	uint64_t			writeIndex = _writeIndex.load(memory_order_acquire);
+	//	if more messages were written than the log holds, the oldest were overwritten
+	if (writeIndex - _readIndex > LOG_SIZE)	{
+		_droppedCount.fetch_add(writeIndex - _readIndex - LOG_SIZE, memory_order_relaxed);
+		_readIndex = writeIndex - LOG_SIZE;
+	}
+	for ( ; _readIndex<writeIndex; ++_readIndex)	{
+		GLDebugLogEntry		&entry = _log[_readIndex % LOG_SIZE];
+		uint64_t			expectedSeq = _readIndex*2+2;
+		uint64_t			seq = entry.seq.load(memory_order_acquire);
+		//	if the entry hasn't been written yet (or is still being written), stop- we'll pick it up next time
+		if (seq < expectedSeq)
+			break;
+		//	if the entry was overwritten by a newer message, the message is lost
+		if (seq != expectedSeq)	{
+			_droppedCount.fetch_add(1, memory_order_relaxed);
+			continue;
+		}
+		Message				tmpMsg;
+		tmpMsg.source = entry.source;
+		tmpMsg.type = entry.type;
+		tmpMsg.id = entry.id;
+		tmpMsg.severity = entry.severity;
+		tmpMsg.group = string(entry.group, strnlen(entry.group, GROUP_SIZE));
+		tmpMsg.text = string(entry.text, strnlen(entry.text, TEXT_SIZE));
+		//	if the entry was overwritten while we were copying it, the message is lost
+		atomic_thread_fence(memory_order_acquire);
+		if (entry.seq.load(memory_order_relaxed) != expectedSeq)	{
+			_droppedCount.fetch_add(1, memory_order_relaxed);
+			continue;
+		}
+		returnMe.push_back(tmpMsg);
+	}
+	return returnMe;
+}
+GLDebugLog::Stats GLDebugLog::GetStats()	{
+	Stats		returnMe;
+	returnMe.messages = _messageCount.load(memory_order_relaxed);
+	returnMe.errors = _errorCount.load(memory_order_relaxed);
+	returnMe.dropped = _droppedCount.load(memory_order_relaxed);
+	returnMe.attributed = _attributedCount.load(memory_order_relaxed);
+	return returnMe;
+}
+GLDebugLog::Stats GLDebugLog::SnapshotAndResetStats()	{
+	Stats		returnMe;
+	returnMe.messages = _messageCount.exchange(0, memory_order_relaxed);
+	returnMe.errors = _errorCount.exchange(0, memory_order_relaxed);
+	returnMe.dropped = _droppedCount.exchange(0, memory_order_relaxed);
+	returnMe.attributed = _attributedCount.exchange(0, memory_order_relaxed);
+	return returnMe;
+}
+
+
+vector<GLDebugLog::SiteCount> GLDebugLog::GetSiteCounts()	{
+	vector<SiteCount>		returnMe;
+	for (Site * site = _sites.load(memory_order_acquire); site!=nullptr; site=site->next)	{
+		uint64_t		count = site->messageCount.load(memory_order_relaxed);
+		if (count < 1)
+			continue;
+		SiteCount		tmpCount;
+		tmpCount.file = string(site->file);
+		tmpCount.line = site->line;
+		tmpCount.count = count;
+		returnMe.push_back(tmpCount);
+	}
+	sort(returnMe.begin(), returnMe.end(), [](const SiteCount & a, const SiteCount & b) { return a.count > b.count; });
+	return returnMe;
+}
+void GLDebugLog::ResetSiteCounts()	{
+	for (Site * site = _sites.load(memory_order_acquire); site!=nullptr; site=site->next)
+		site->messageCount.store(0, memory_order_relaxed);
+}
+void GLDebugLog::MarkSite(Site * inSite)	{
+	if (_pendingSiteMessages == 0 || inSite == nullptr)
+		return;
+	inSite->messageCount.fetch_add(_pendingSiteMessages, memory_order_relaxed);
+	_attributedCount.fetch_add(_pendingSiteMessages, memory_order_relaxed);
+	_pendingSiteMessages = 0;
+}
+void GLDebugLog::_RegisterSite(Site * inSite)	{
+	Site		*head = _sites.load(memory_order_relaxed);
+	do	{
+		inSite->next = head;
+	} while (!_sites.compare_exchange_weak(head, inSite, memory_order_release, memory_order_relaxed));
+}
+
+
+
+
+}
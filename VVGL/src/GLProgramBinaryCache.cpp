@@ -0,0 +1,345 @@
+#include "GLProgramBinaryCache.hpp"
+#include "GLContext.hpp"
+#include "GLProgramCache.hpp"
+#include "VVGL_Time.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+
+
+
+namespace VVGL
+{
+
+
+using namespace std;
+
+
+
+
+//	the first bytes of every file- change the number if the layout of the file changes
+#define FILE_MAGIC "VVGLPGB1"
+#define FILE_MAGIC_SIZE 8
+
+
+//	protects the directory and the stats
+static mutex								_lock;
+static string								_directory;
+static GLProgramBinaryCache::Stats			_stats;
+//	used to give the temp files written by Store() unique names
+static atomic<uint64_t>						_tmpFileCount { 0 };
+
+
+//	returns one of the strings describing the current context (GL_RENDERER or GL_VERSION)
+static string CurrentGLString(const GLenum & inName)	{
+	const char		*tmpString = reinterpret_cast<const char *>(glGetString(inName));
+	GLERRLOG
+	return (tmpString==nullptr) ? string("") : string(tmpString);
+}
+//	returns the path of the file for the passed sources in the passed directory- the name is a hash of the sources and the strings describing the GPU/driver
+static string PathForProgram(const string & inDir, const GLVersion & inVersion, const string & inVS, const string & inGS, const string & inFS, const string & inRenderer, const string & inGLVersion)	{
+	uint64_t		hash = GLProgramCache::HashSources(inVS, inGS, inFS, inVersion);
+	//	the null terminators are hashed too, so the strings can't run into one another
+	hash = GLProgramCache::HashBytes(inRenderer.c_str(), inRenderer.size()+1, hash);
+	hash = GLProgramCache::HashBytes(inGLVersion.c_str(), inGLVersion.size()+1, hash);
+
+	ostringstream	returnMe;
+	returnMe << inDir;
+	if (inDir.back()!='/' && inDir.back()!='\\')
+		returnMe << '/';
+	returnMe << hex << setfill('0') << setw(16) << hash << ".vvglprogram";
+	return returnMe.str();
+}
+
+//	the file is a series of values in native byte order: the magic, the binary format (uint32), the compile time (double), and then the
+//	renderer, GL version, vertex/geometry/fragment sources and binary (each a uint32 length followed by that many bytes)
+static void AppendBytes(vector<char> & ioData, const void * inBytes, const size_t & inLength)	{
+	const char		*rPtr = static_cast<const char*>(inBytes);
+	ioData.insert(ioData.end(), rPtr, rPtr+inLength);
+}
+static void AppendString(vector<char> & ioData, const string & inString)	{
+	uint32_t		tmpLength = uint32_t(inString.size());
+	AppendBytes(ioData, &tmpLength, sizeof(tmpLength));
+	AppendBytes(ioData, inString.data(), inString.size());
+}
+static bool ReadBytes(const vector<char> & inData, size_t & ioOffset, void * outBytes, const size_t & inLength)	{
+	if (inLength > inData.size() || ioOffset > inData.size()-inLength)
+		return false;
+	memcpy(outBytes, inData.data()+ioOffset, inLength);
+	ioOffset += inLength;
+	return true;
+}
+static bool ReadString(const vector<char> & inData, size_t & ioOffset, string & outString)	{
+	uint32_t		tmpLength = 0;
+	if (!ReadBytes(inData, ioOffset, &tmpLength, sizeof(tmpLength)))
+		return false;
+	if (tmpLength > inData.size() || ioOffset > inData.size()-tmpLength)
+		return false;
+	outString.assign(inData.data()+ioOffset, tmpLength);
+	ioOffset += tmpLength;
+	return true;
+}
+
+
+
+
+/*	========================================	*/
+#pragma mark --------------------- settings
+
+
+void GLProgramBinaryCache::SetDirectory(const string & n)	{
+	lock_guard<mutex>		lock(_lock);
+	_directory = n;
+}
+string GLProgramBinaryCache::Directory()	{
+	lock_guard<mutex>		lock(_lock);
+	return _directory;
+}
+bool GLProgramBinaryCache::Enabled()	{
+	lock_guard<mutex>		lock(_lock);
+	return (_directory.size() > 0);
+}
+bool GLProgramBinaryCache::AvailableInContext(const GLContextRef & inCtx)	{
+	if (inCtx == nullptr)
+		return false;
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+	//	program binaries are core in GL 4.1 and GL ES 3 (older contexts may have ARB_get_program_binary)
+	if (inCtx->version!=GLVersion_33 && inCtx->version!=GLVersion_4 && inCtx->version!=GLVersion_ES3)
+		return false;
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+	//	GLEW leaves the function ptrs null if the context doesn't support program binaries
+	if (glGetProgramBinary==nullptr || glProgramBinary==nullptr || glProgramParameteri==nullptr)
+		return false;
+#endif
+	//	drivers that support the functions but can't save binaries report no formats
+	GLint			formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	GLERRLOG
+	return (formatCount > 0);
+#else
+	return false;
+#endif
+}
+
+
+
+
+/*	========================================	*/
+#pragma mark --------------------- loading/storing
+
+
+uint32_t GLProgramBinaryCache::Load(const GLContextRef & inCtx, const string & inVS, const string & inGS, const string & inFS)	{
+	string			dir = Directory();
+	if (dir.size()<1 || inCtx==nullptr)
+		return 0;
+	if (!AvailableInContext(inCtx))
+		return 0;
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+	Timestamp		startTime;
+	string			renderer = CurrentGLString(GL_RENDERER);
+	string			glVersion = CurrentGLString(GL_VERSION);
+	string			path = PathForProgram(dir, inCtx->version, inVS, inGS, inFS, renderer, glVersion);
+
+	//	read the whole file- if there isn't one, the program isn't in the cache
+	vector<char>	data;
+	{
+		ifstream		fin(path, ios::in | ios::binary);
+		if (!fin.is_open())	{
+			lock_guard<mutex>		lock(_lock);
+			++_stats.misses;
+			return 0;
+		}
+		fin.seekg(0, ios::end);
+		streamoff		fileSize = fin.tellg();
+		fin.seekg(0, ios::beg);
+		if (fileSize > 0)	{
+			data.resize(size_t(fileSize));
+			fin.read(data.data(), fileSize);
+			if (fin.gcount() != fileSize)
+				data.clear();
+		}
+	}
+
+	//	this block deletes the file and counts it as rejected (and the program as a miss)
+	auto			rejectBlock = [&]()	{
+		remove(path.c_str());
+		lock_guard<mutex>		lock(_lock);
+		++_stats.rejected;
+		++_stats.misses;
+	};
+
+	size_t			offset = 0;
+	char			magic[FILE_MAGIC_SIZE];
+	uint32_t		binaryFormat = 0;
+	double			compileSeconds = 0.;
+	string			fileRenderer;
+	string			fileGLVersion;
+	string			fileVS;
+	string			fileGS;
+	string			fileFS;
+	string			binary;
+	if (!ReadBytes(data, offset, magic, FILE_MAGIC_SIZE) || memcmp(magic, FILE_MAGIC, FILE_MAGIC_SIZE)!=0
+	|| !ReadBytes(data, offset, &binaryFormat, sizeof(binaryFormat))
+	|| !ReadBytes(data, offset, &compileSeconds, sizeof(compileSeconds))
+	|| !ReadString(data, offset, fileRenderer)
+	|| !ReadString(data, offset, fileGLVersion)
+	|| !ReadString(data, offset, fileVS)
+	|| !ReadString(data, offset, fileGS)
+	|| !ReadString(data, offset, fileFS)
+	|| !ReadString(data, offset, binary)
+	|| binary.size() < 1)	{
+		rejectBlock();
+		return 0;
+	}
+	//	the name of the file is only a hash- if the file is for a different program (or GPU/driver), it's a miss (and will be overwritten when the program is stored)
+	if (fileRenderer!=renderer || fileGLVersion!=glVersion || fileVS!=inVS || fileGS!=inGS || fileFS!=inFS)	{
+		lock_guard<mutex>		lock(_lock);
+		++_stats.misses;
+		return 0;
+	}
+
+	//	load the binary- the driver may reject it (the program won't be linked if it did)
+	GLuint			returnMe = glCreateProgram();
+	GLERRLOG
+	glProgramBinary(returnMe, GLenum(binaryFormat), binary.data(), GLsizei(binary.size()));
+	GLERRLOG
+	GLint			linked = 0;
+	glGetProgramiv(returnMe, GL_LINK_STATUS, &linked);
+	GLERRLOG
+	if (!linked)	{
+		glDeleteProgram(returnMe);
+		GLERRLOG
+		rejectBlock();
+		return 0;
+	}
+
+	double			loadSeconds = (Timestamp()-startTime).getTimeInSeconds();
+	lock_guard<mutex>		lock(_lock);
+	++_stats.hits;
+	_stats.loadSeconds += loadSeconds;
+	if (compileSeconds > loadSeconds)
+		_stats.savedSeconds += (compileSeconds - loadSeconds);
+	return returnMe;
+#else
+	return 0;
+#endif
+}
+
+void GLProgramBinaryCache::PrepareToLink(const GLContextRef & inCtx, const uint32_t & inProgram)	{
+	if (inProgram==0 || !Enabled() || !AvailableInContext(inCtx))
+		return;
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+	glProgramParameteri(inProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	GLERRLOG
+#endif
+}
+
+void GLProgramBinaryCache::Store(const GLContextRef & inCtx, const string & inVS, const string & inGS, const string & inFS, const uint32_t & inProgram, const double & inCompileSeconds)	{
+	string			dir = Directory();
+	if (dir.size()<1 || inCtx==nullptr || inProgram==0)
+		return;
+	if (!AvailableInContext(inCtx))
+		return;
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+	//	get the program's binary
+	GLint			binaryLength = 0;
+	glGetProgramiv(inProgram, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	GLERRLOG
+	if (binaryLength < 1)
+		return;
+	string			binary(size_t(binaryLength), '\0');
+	GLsizei			writtenLength = 0;
+	GLenum			binaryFormat = 0;
+	glGetProgramBinary(inProgram, binaryLength, &writtenLength, &binaryFormat, &binary[0]);
+	GLERRLOG
+	if (writtenLength < 1)
+		return;
+	binary.resize(size_t(writtenLength));
+
+	string			renderer = CurrentGLString(GL_RENDERER);
+	string			glVersion = CurrentGLString(GL_VERSION);
+	string			path = PathForProgram(dir, inCtx->version, inVS, inGS, inFS, renderer, glVersion);
+
+	vector<char>	data;
+	uint32_t		tmpFormat = uint32_t(binaryFormat);
+	double			tmpSeconds = inCompileSeconds;
+	AppendBytes(data, FILE_MAGIC, FILE_MAGIC_SIZE);
+	AppendBytes(data, &tmpFormat, sizeof(tmpFormat));
+	AppendBytes(data, &tmpSeconds, sizeof(tmpSeconds));
+	AppendString(data, renderer);
+	AppendString(data, glVersion);
+	AppendString(data, inVS);
+	AppendString(data, inGS);
+	AppendString(data, inFS);
+	AppendString(data, binary);
+
+	//	write a temp file and then rename it, so other threads (or apps) never read a partially-written file
+	ostringstream	tmpPath;
+	tmpPath << path << "." << hash<thread::id>()(this_thread::get_id()) << "-" << (++_tmpFileCount) << ".tmp";
+	{
+		ofstream		fout(tmpPath.str(), ios::out | ios::binary | ios::trunc);
+		if (!fout.is_open())
+			return;
+		fout.write(data.data(), streamsize(data.size()));
+		if (!fout.good())	{
+			fout.close();
+			remove(tmpPath.str().c_str());
+			return;
+		}
+	}
+	if (rename(tmpPath.str().c_str(), path.c_str()) != 0)	{
+		//	renaming onto an existing file fails on some platforms
+		remove(path.c_str());
+		if (rename(tmpPath.str().c_str(), path.c_str()) != 0)	{
+			remove(tmpPath.str().c_str());
+			return;
+		}
+	}
+
+	lock_guard<mutex>		lock(_lock);
+	++_stats.stored;
+#endif
+}
+
+
+
+
+/*	========================================	*/
+#pragma mark --------------------- stats
+
+
+GLProgramBinaryCache::Stats GLProgramBinaryCache::GetStats()	{
+	lock_guard<mutex>		lock(_lock);
+	return _stats;
+}
+GLProgramBinaryCache::Stats GLProgramBinaryCache::SnapshotAndResetStats()	{
+	lock_guard<mutex>		lock(_lock);
+	Stats			returnMe = _stats;
+	_stats = Stats();
+	return returnMe;
+}
+
+
+string GLProgramBinaryCache::Stats::getDescriptionString() const	{
+	ostringstream	returnMe;
+	uint64_t		lookups = hits + misses;
+	returnMe << "<GLProgramBinaryCache::Stats " << hits << " hits, " << misses << " misses";
+	if (lookups > 0)
+		returnMe << " (" << (100 * hits / lookups) << "% hit)";
+	returnMe << ", " << rejected << " rejected, " << stored << " stored, ";
+	returnMe << fixed << setprecision(1) << (loadSeconds*1000.) << "ms loading, " << (savedSeconds*1000.) << "ms saved>";
+	return returnMe.str();
+}
+
+
+
+
+}
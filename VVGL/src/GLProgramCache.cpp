@@ -0,0 +1,183 @@
+#include "GLProgramCache.hpp"
+#include "GLContext.hpp"
+#include "GLStateCache.hpp"
+
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+
+
+
+namespace VVGL
+{
+
+
+using namespace std;
+
+
+
+
+//	the programs in the cache, keyed by the hash of their sources.  programs with the same hash may be in different sharegroups (or- very rarely- have different sources), so there can be more than one per hash.
+static unordered_multimap<uint64_t,GLProgramCache::ProgramRef>		_programs;
+static mutex						_programsLock;
+
+static atomic<uint64_t>				_hitCount { 0 };
+static atomic<uint64_t>				_missCount { 0 };
+
+
+
+
+/*	========================================	*/
+#pragma mark --------------------- Program
+
+
+GLProgramCache::Program::Program(const uint64_t & inHash, const GLContextRef & inCtx, const string & inVS, const string & inGS, const string & inFS) :
+	_hash(inHash),
+	_version((inCtx==nullptr) ? GLVersion_Unknown : inCtx->version),
+	_ctx(inCtx),
+	_vs(inVS),
+	_gs(inGS),
+	_fs(inFS)
+{
+}
+
+
+
+
+/*	========================================	*/
+#pragma mark --------------------- cache
+
+
+uint64_t GLProgramCache::HashBytes(const void * inBytes, const size_t & inLength, const uint64_t & inHash)	{
+	uint64_t			returnMe = inHash;
+	const uint8_t		*rPtr = static_cast<const uint8_t*>(inBytes);
+	for (size_t i=0; i<inLength; ++i)	{
+		returnMe ^= uint64_t(rPtr[i]);
+		returnMe *= 0x100000001b3ULL;
+	}
+	return returnMe;
+}
+uint64_t GLProgramCache::HashSources(const string & inVS, const string & inGS, const string & inFS, const GLVersion & inVersion)	{
+	//	the length of each source is hashed too, so moving text from the end of one shader to the start of the next changes the hash
+	uint64_t		returnMe = HashBytes(nullptr, 0);
+	for (const string * srcPtr : { &inVS, &inGS, &inFS })	{
+		uint64_t		tmpLength = srcPtr->size();
+		returnMe = HashBytes(&tmpLength, sizeof(tmpLength), returnMe);
+		returnMe = HashBytes(srcPtr->data(), srcPtr->size(), returnMe);
+	}
+	int32_t			tmpVersion = int32_t(inVersion);
+	returnMe = HashBytes(&tmpVersion, sizeof(tmpVersion), returnMe);
+	return returnMe;
+}
+
+GLProgramCache::ProgramRef GLProgramCache::Acquire(const GLContextRef & inCtx, const string & inVS, const string & inGS, const string & inFS)	{
+	if (inCtx == nullptr)
+		return nullptr;
+	uint64_t		hash = HashSources(inVS, inGS, inFS, inCtx->version);
+
+	lock_guard<mutex>		lock(_programsLock);
+	auto			range = _programs.equal_range(hash);
+	for (auto it=range.first; it!=range.second; ++it)	{
+		const ProgramRef	&pgm = it->second;
+		if (pgm->_version != inCtx->version)
+			continue;
+		if (pgm->_ctx!=inCtx && !pgm->_ctx->sameShareGroupAs(inCtx))
+			continue;
+		//	the hash is only 64 bits, so make sure it's really the same program
+		if (pgm->_vs!=inVS || pgm->_gs!=inGS || pgm->_fs!=inFS)
+			continue;
+		++pgm->_useCount;
+		++_hitCount;
+		return pgm;
+	}
+	++_missCount;
+	return nullptr;
+}
+
+GLProgramCache::ProgramRef GLProgramCache::Add(const GLContextRef & inCtx, const string & inVS, const string & inGS, const string & inFS, const uint32_t & inProgram, const uint32_t & inVertShader, const uint32_t & inGeoShader, const uint32_t & inFragShader, const GLProgramReflectionRef & inReflection)	{
+	if (inCtx==nullptr || inProgram==0)
+		return nullptr;
+	ProgramRef		returnMe = make_shared<Program>(HashSources(inVS, inGS, inFS, inCtx->version), inCtx, inVS, inGS, inFS);
+	returnMe->_program = inProgram;
+	returnMe->_shaders[0] = inVertShader;
+	returnMe->_shaders[1] = inGeoShader;
+	returnMe->_shaders[2] = inFragShader;
+	returnMe->_reflection = inReflection;
+	returnMe->_useCount = 1;
+
+	//	if another scene linked the same program at the same time, both are kept- neither is shared with the other, but both are still shared with scenes that come later
+	lock_guard<mutex>		lock(_programsLock);
+	_programs.insert(make_pair(returnMe->_hash, returnMe));
+	return returnMe;
+}
+
+void GLProgramCache::Release(const ProgramRef & inProgram)	{
+	if (inProgram == nullptr)
+		return;
+
+	{
+		lock_guard<mutex>		lock(_programsLock);
+		if (inProgram->_useCount > 0)
+			--inProgram->_useCount;
+		if (inProgram->_useCount > 0)
+			return;
+		auto			range = _programs.equal_range(inProgram->_hash);
+		for (auto it=range.first; it!=range.second; ++it)	{
+			if (it->second == inProgram)	{
+				_programs.erase(it);
+				break;
+			}
+		}
+	}
+
+	//	nobody's using the program any more- delete it (and the shaders attached to it)
+	if (inProgram->_program > 0)	{
+		glDeleteProgram(inProgram->_program);
+		GLERRLOG
+		GLStateCache::NoteDeletedObjects();
+		inProgram->_program = 0;
+	}
+	for (uint32_t & shader : inProgram->_shaders)	{
+		if (shader > 0)	{
+			glDeleteShader(shader);
+			GLERRLOG
+			shader = 0;
+		}
+	}
+	inProgram->_reflection = nullptr;
+}
+
+
+GLProgramCache::Stats GLProgramCache::GetStats()	{
+	Stats			returnMe;
+	returnMe.hits = _hitCount.load();
+	returnMe.misses = _missCount.load();
+	lock_guard<mutex>		lock(_programsLock);
+	returnMe.programs = _programs.size();
+	for (const auto & pgmIt : _programs)
+		returnMe.users += pgmIt.second->_useCount;
+	return returnMe;
+}
+GLProgramCache::Stats GLProgramCache::SnapshotAndResetStats()	{
+	Stats			returnMe = GetStats();
+	returnMe.hits = _hitCount.exchange(0);
+	returnMe.misses = _missCount.exchange(0);
+	return returnMe;
+}
+
+
+string GLProgramCache::Stats::getDescriptionString() const	{
+	ostringstream	returnMe;
+	uint64_t		lookups = hits + misses;
+	returnMe << "<GLProgramCache::Stats " << hits << " hits, " << misses << " misses";
+	if (lookups > 0)
+		returnMe << " (" << (100 * hits / lookups) << "% hit)";
+	returnMe << ", " << programs << " programs, " << users << " users>";
+	return returnMe.str();
+}
+
+
+
+
+}
@@ -0,0 +1,104 @@
+#include "GLProgramReflection.hpp"
+#include "GLContext.hpp"
+
+#include <vector>
+#include <sstream>
+
+
+
+
+namespace VVGL
+{
+
+
+using namespace std;
+
+
+
+
+GLProgramReflection::GLProgramReflection(const uint32_t & inProgram) : _program(inProgram)	{
+	if (_program == 0)
+		return;
+
+	//	the names are copied into a buffer as long as the longest name, so they're never truncated
+	GLint			count = 0;
+	GLint			maxLength = 0;
+	vector<GLchar>	nameBuffer;
+
+	glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &count);
+	GLERRLOG
+	glGetProgramiv(_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+	GLERRLOG
+	nameBuffer.resize((maxLength>0) ? maxLength+1 : 1);
+	_uniforms.reserve((count>0) ? count*2 : 0);
+	for (GLint i=0; i<count; ++i)	{
+		GLsizei			nameLength = 0;
+		GLint			arraySize = 0;
+		GLenum			type = 0;
+		glGetActiveUniform(_program, GLuint(i), GLsizei(nameBuffer.size()), &nameLength, &arraySize, &type, nameBuffer.data());
+		GLERRLOG
+		if (nameLength < 1)
+			continue;
+		string			name(nameBuffer.data(), nameLength);
+		//	members of uniform blocks don't have locations (this returns -1 for them)
+		GLint			loc = glGetUniformLocation(_program, name.c_str());
+		GLERRLOG
+		_uniforms[name] = loc;
+		//	arrays are reported as "name[0]"- they can also be looked up without the subscript
+		if (name.size()>3 && name.compare(name.size()-3, 3, "[0]")==0)
+			_uniforms[name.substr(0, name.size()-3)] = loc;
+		++_activeUniformCount;
+	}
+
+	count = 0;
+	maxLength = 0;
+	glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &count);
+	GLERRLOG
+	glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+	GLERRLOG
+	nameBuffer.resize((maxLength>0) ? maxLength+1 : 1);
+	_attribs.reserve((count>0) ? count : 0);
+	for (GLint i=0; i<count; ++i)	{
+		GLsizei			nameLength = 0;
+		GLint			arraySize = 0;
+		GLenum			type = 0;
+		glGetActiveAttrib(_program, GLuint(i), GLsizei(nameBuffer.size()), &nameLength, &arraySize, &type, nameBuffer.data());
+		GLERRLOG
+		if (nameLength < 1)
+			continue;
+		string			name(nameBuffer.data(), nameLength);
+		GLint			loc = glGetAttribLocation(_program, name.c_str());
+		GLERRLOG
+		_attribs[name] = loc;
+	}
+}
+
+
+int32_t GLProgramReflection::uniformLocation(const string & inName) const	{
+	auto			it = _uniforms.find(inName);
+	if (it != _uniforms.end())
+		return it->second;
+	//	only the first element of an array was enumerated- ask GL for the others
+	if (_program > 0 && inName.size() > 0 && inName.back() == ']')	{
+		GLint			returnMe = glGetUniformLocation(_program, inName.c_str());
+		GLERRLOG
+		return returnMe;
+	}
+	return -1;
+}
+int32_t GLProgramReflection::attribLocation(const string & inName) const	{
+	auto			it = _attribs.find(inName);
+	return (it == _attribs.end()) ? -1 : it->second;
+}
+
+
+string GLProgramReflection::getDescriptionString() const	{
+	ostringstream	returnMe;
+	returnMe << "<GLProgramReflection " << _program << ", " << _activeUniformCount << " uniforms, " << _attribs.size() << " attribs>";
+	return returnMe.str();
+}
+
+
+
+
+}
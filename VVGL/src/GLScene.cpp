@@ -1,4 +1,6 @@
 #include "GLScene.hpp"
+#include "GLProgramBinaryCache.hpp"
+#include "VVGL_Time.hpp"
 #include <cstring> //memset
 
 
@@ -50,22 +52,7 @@ void GLScene::prepareToBeDeleted()	{
 		lock_guard<recursive_mutex>		lock(_renderLock);
 		if (_context != nullptr)	{
 			_context->makeCurrentIfNotCurrent();
-			if (_program > 0)	{
-				glDeleteProgram(_program);
-				GLERRLOG
-			}
-			if (_vs > 0)	{
-				glDeleteShader(_vs);
-				GLERRLOG
-			}
-			if (_gs > 0)	{
-				glDeleteShader(_gs);
-				GLERRLOG
-			}
-			if (_fs > 0)	{
-				glDeleteShader(_fs);
-				GLERRLOG
-			}
+			_releaseProgram();
 		}
 		if (_vsString != nullptr)	{
 			delete _vsString;
@@ -176,6 +163,8 @@ void GLScene::render(const RenderTarget & inRenderTarget)	{
 		return;
 	}
 	_context->makeCurrentIfNotCurrent();
+	//	redundant state changes are skipped until we return
+	GLStateCache::Scope		tmpScope(_context);
 	
 	//	update the member var for the fbo attachments
 	_renderTarget = inRenderTarget;
@@ -186,8 +175,15 @@ void GLScene::render(const RenderTarget & inRenderTarget)	{
 	bool		looksLikeItShouldHaveAProgram = ((_vsString!=nullptr && _vsString->size()>0) || (_gsString!=nullptr && _gsString->size()>0) || (_fsString!=nullptr && _fsString->size()>0));
 	if ((_program==0 && !looksLikeItShouldHaveAProgram) ||	(_program!=0 && looksLikeItShouldHaveAProgram))	{
 		//	execute the render callback
-		if (_renderCallback != nullptr)
-			_renderCallback(*this);
+		if (_renderCallback != nullptr)	{
+			if (_callbacksUseStateCache)
+				_renderCallback(*this);
+			else	{
+				GLStateCache::FlushReleases();
+				_renderCallback(*this);
+				_context->stateCache().invalidate();
+			}
+		}
 	}
 	
 	//	cleanup after render
@@ -206,6 +202,8 @@ void GLScene::renderBlackFrame(const RenderTarget & inRenderTarget)	{
 		return;
 	}
 	_context->makeCurrentIfNotCurrent();
+	//	redundant state changes are skipped until we return
+	GLStateCache::Scope		tmpScope(_context);
 	
 	//	update the member var for the fbo attachments
 	_renderTarget = inRenderTarget;
@@ -213,8 +211,7 @@ void GLScene::renderBlackFrame(const RenderTarget & inRenderTarget)	{
 	_renderPrep();
 	
 	//	clear the context
-	glClearColor(0., 0., 0., 0.);
-	GLERRLOG
+	GLStateCache::ClearColor(GLColor(0., 0., 0., 0.));
 	uint32_t		mask = GL_COLOR_BUFFER_BIT;
 #if !defined(VVGL_SDK_IOS) && !defined(VVGL_SDK_RPI)
 	mask |= GL_DEPTH_BUFFER_BIT;
@@ -237,6 +234,8 @@ void GLScene::renderOpaqueBlackFrame(const RenderTarget & inRenderTarget)	{
 		return;
 	}
 	_context->makeCurrentIfNotCurrent();
+	//	redundant state changes are skipped until we return
+	GLStateCache::Scope		tmpScope(_context);
 	
 	//	update the member var for the fbo attachments
 	_renderTarget = inRenderTarget;
@@ -244,8 +243,7 @@ void GLScene::renderOpaqueBlackFrame(const RenderTarget & inRenderTarget)	{
 	_renderPrep();
 	
 	//	get the context, clear
-	glClearColor(0., 0., 0., 1.);
-	GLERRLOG
+	GLStateCache::ClearColor(GLColor(0., 0., 0., 1.));
 	uint32_t		mask = GL_COLOR_BUFFER_BIT;
 #if !defined(VVGL_SDK_IOS) && !defined(VVGL_SDK_RPI)
 	mask |= GL_DEPTH_BUFFER_BIT;
@@ -268,6 +266,8 @@ void GLScene::renderRedFrame(const RenderTarget & inRenderTarget)	{
 		return;
 	}
 	_context->makeCurrentIfNotCurrent();
+	//	redundant state changes are skipped until we return
+	GLStateCache::Scope		tmpScope(_context);
 	
 	//	update the member var for the fbo attachments
 	_renderTarget = inRenderTarget;
@@ -275,8 +275,7 @@ void GLScene::renderRedFrame(const RenderTarget & inRenderTarget)	{
 	_renderPrep();
 	
 	//	get the context, clear
-	glClearColor(1., 0., 0., 1.);
-	GLERRLOG
+	GLStateCache::ClearColor(GLColor(1., 0., 0., 1.));
 	uint32_t		mask = GL_COLOR_BUFFER_BIT;
 #if !defined(VVGL_SDK_IOS) && !defined(VVGL_SDK_RPI)
 	if (inRenderTarget.depth != nullptr)	{
@@ -301,15 +300,19 @@ void GLScene::renderRedFrame(const RenderTarget & inRenderTarget)	{
 
 void GLScene::setRenderPrepCallback(const RenderPrepCallback & n)	{
 	_renderPrepCallback = n;
+	_callbacksUseStateCache = false;
 }
 void GLScene::setRenderPreLinkCallback(const RenderCallback & n)	{
 	_renderPreLinkCallback = n;
+	_callbacksUseStateCache = false;
 }
 void GLScene::setRenderCallback(const RenderCallback & n)	{
 	_renderCallback = n;
+	_callbacksUseStateCache = false;
 }
 void GLScene::setRenderCleanupCallback(const RenderCallback & n)	{
 	_renderCleanupCallback = n;
+	_callbacksUseStateCache = false;
 }
 
 
@@ -430,6 +433,7 @@ void GLScene::compileProgramIfNecessary()	{
 		return;
 	}
 	_context->makeCurrentIfNotCurrent();
+	GLStateCache::Scope		tmpScope(_context);
 	
 	//	prep for render
 	_renderPrep();
@@ -437,6 +441,16 @@ void GLScene::compileProgramIfNecessary()	{
 	//	cleanup after render
 	_renderCleanup();
 }
+void GLScene::setSharesProgram(const bool & n)	{
+	lock_guard<recursive_mutex>		lock(_renderLock);
+	if (_sharesProgram == n)
+		return;
+	_sharesProgram = n;
+	//	the program has to be looked up in the cache (or stop being shared)- it'll be relinked the next time the scene renders
+	_vsStringUpdated = true;
+	_needsReshape = true;
+	_orthoUni.purgeCache();
+}
 
 
 /*	========================================	*/
@@ -462,29 +476,9 @@ void GLScene::_renderPrep()	{
 	if (_vsStringUpdated || _gsStringUpdated || _fsStringUpdated)	{
 		pgmChangedFlag = true;
 		
-		glUseProgram(0);
-		GLERRLOG
+		GLStateCache::UseProgram(0);
 		
-		if (_program > 0)	{
-			glDeleteProgram(_program);
-			GLERRLOG
-			_program = 0;
-		}
-		if (_vs > 0)	{
-			glDeleteShader(_vs);
-			GLERRLOG
-			_vs = 0;
-		}
-		if (_gs > 0)	{
-			glDeleteShader(_gs);
-			GLERRLOG
-			_gs = 0;
-		}
-		if (_fs > 0)	{
-			glDeleteShader(_fs);
-			GLERRLOG
-			_fs = 0;
-		}
+		_releaseProgram();
 		_programReady = false;
 		
 		
@@ -493,8 +487,40 @@ void GLScene::_renderPrep()	{
 			_errDict.clear();
 		}
 		
+		//	the program is looked up in the caches by its sources
+		const string		emptyString;
+		const string		&vsSrc = (_vsString==nullptr) ? emptyString : *_vsString;
+		const string		&gsSrc = (_gsString==nullptr) ? emptyString : *_gsString;
+		const string		&fsSrc = (_fsString==nullptr) ? emptyString : *_fsString;
+		
+		//	if the program's shared, another scene may have already linked it- if so, there's nothing to compile
+		bool			shareProgram = (_sharesProgram && _renderPreLinkCallback==nullptr);
+		if (shareProgram)	{
+			_sharedProgram = GLProgramCache::Acquire(_context, vsSrc, gsSrc, fsSrc);
+			if (_sharedProgram != nullptr)	{
+				_program = _sharedProgram->program();
+				_programReflection = _sharedProgram->reflection();
+				_programReady = true;
+				_orthoUni.cacheTheLoc(*_programReflection);
+			}
+		}
+		//	if the program was saved to the binary cache, load it instead of compiling it
+		bool			useBinaryCache = (_renderPreLinkCallback==nullptr && GLProgramBinaryCache::Enabled());
+		if (_program==0 && useBinaryCache)	{
+			_program = GLProgramBinaryCache::Load(_context, vsSrc, gsSrc, fsSrc);
+			if (_program > 0)	{
+				_programReady = true;
+				_programReflection = make_shared<GLProgramReflection>(_program);
+				_orthoUni.cacheTheLoc(*_programReflection);
+				if (shareProgram)
+					_sharedProgram = GLProgramCache::Add(_context, vsSrc, gsSrc, fsSrc, _program, 0, 0, 0, _programReflection);
+			}
+		}
+		bool			needsCompile = (_program == 0);
+		Timestamp		compileStart;
+		
 		bool			encounteredError = false;
-		if (_vsString!=nullptr && _vsString->size() > 0)	{
+		if (needsCompile && _vsString!=nullptr && _vsString->size() > 0)	{
 			_vs = glCreateShader(GL_VERTEX_SHADER);
 			GLERRLOG
 			const char		*shaderSrc = _vsString->c_str();
@@ -531,7 +557,7 @@ void GLScene::_renderPrep()	{
 				_vs = 0;
 			}
 		}
-		if (_gsString!=nullptr && _gsString->size() > 0)	{
+		if (needsCompile && _gsString!=nullptr && _gsString->size() > 0)	{
 #if !defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
 			_gs = glCreateShader(GL_GEOMETRY_SHADER);
 			GLERRLOG
@@ -570,7 +596,7 @@ void GLScene::_renderPrep()	{
 			}
 #endif
 		}
-		if (_fsString!=nullptr && _fsString->size() > 0)	{
+		if (needsCompile && _fsString!=nullptr && _fsString->size() > 0)	{
 			_fs = glCreateShader(GL_FRAGMENT_SHADER);
 			GLERRLOG
 			const char		*shaderSrc = _fsString->c_str();
@@ -622,8 +648,15 @@ void GLScene::_renderPrep()	{
 				glAttachShader(_program, _fs);
 				GLERRLOG
 			}
-			if (_renderPreLinkCallback != nullptr)
+			if (_renderPreLinkCallback != nullptr)	{
+				if (!_callbacksUseStateCache)
+					GLStateCache::FlushReleases();
 				_renderPreLinkCallback(*this);
+				if (!_callbacksUseStateCache)
+					_context->stateCache().invalidate();
+			}
+			if (useBinaryCache)
+				GLProgramBinaryCache::PrepareToLink(_context, _program);
 			glLinkProgram(_program);
 			GLERRLOG
 			
@@ -675,11 +708,26 @@ void GLScene::_renderPrep()	{
 				//free(log);
 				glDeleteProgram(_program);
 				GLERRLOG
+				GLStateCache::NoteDeletedObjects();
 				_program = 0;
 			}
 			else	{
 				_programReady = true;
-				_orthoUni.cacheTheLoc(_program);
+				//	save the program to the binary cache, so it doesn't have to be compiled next time
+				if (useBinaryCache)
+					GLProgramBinaryCache::Store(_context, vsSrc, gsSrc, fsSrc, _program, (Timestamp()-compileStart).getTimeInSeconds());
+				//	enumerate the program's uniforms/attributes once, so their locations can be looked up without querying GL
+				_programReflection = make_shared<GLProgramReflection>(_program);
+				_orthoUni.cacheTheLoc(*_programReflection);
+				//	give the program to the cache so other scenes can use it- the shaders belong to the cache now, too
+				if (shareProgram)	{
+					_sharedProgram = GLProgramCache::Add(_context, vsSrc, gsSrc, fsSrc, _program, _vs, _gs, _fs, _programReflection);
+					if (_sharedProgram != nullptr)	{
+						_vs = 0;
+						_gs = 0;
+						_fs = 0;
+					}
+				}
 			}
 		}
 		
@@ -689,10 +737,13 @@ void GLScene::_renderPrep()	{
 		_needsReshape = true;
 	}
 	
+	//	if the program's shared and another scene used it since we last did, its uniforms have that scene's values
+	if (_sharedProgram!=nullptr && _sharedProgram->claim(this))
+		_sharedProgramUsedElsewhere();
+	
 	//	bind the attachments in the render target to the FBO (also in the render target)
 	if (_renderTarget.fboName() > 0)	{
-		glBindFramebuffer(GL_FRAMEBUFFER, _renderTarget.fboName());
-		GLERRLOG
+		GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, _renderTarget.fboName());
 		
 		//	attach the depth buffer
 		if (_renderTarget.depthName() > 0)	{
@@ -732,11 +783,13 @@ void GLScene::_renderPrep()	{
 		}
 		*/
 	}
+	//	...if there's no FBO in the render target we draw into whatever framebuffer was bound before VVGL started rendering
+	else
+		GLStateCache::FlushReleasedFramebuffer();
 	
-	//	clear
-	if (_clearColorUpdated)	{
-		glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
-		GLERRLOG
+	//	clear (another scene on this context may have changed the clear color- the state cache skips this if it didn't)
+	if (_clearColorUpdated || _performClear)	{
+		GLStateCache::ClearColor(_clearColor);
 		_clearColorUpdated = false;
 	}
 	if (_performClear)	{
@@ -749,10 +802,10 @@ void GLScene::_renderPrep()	{
 	}
 	
 	//	if there's a program, use it
-	if (_program > 0)	{
-		glUseProgram(_program);
-		GLERRLOG
-	}
+	if (_program > 0)
+		GLStateCache::UseProgram(_program);
+	else
+		GLStateCache::FlushReleasedProgram();
 	
 	//	reshape as needed (must do this after compiling the program, which caches the ortho uniform location)
 	if (_alwaysNeedsReshape || _needsReshape)	{
@@ -761,8 +814,15 @@ void GLScene::_renderPrep()	{
 	}
 	
 	//	if there's a render prep callback, call it now- pass in flags indicating whether or not the scene has been reshaped (render size changed) and whether or not the program has been recompiled
-	if (_renderPrepCallback != nullptr)
-		_renderPrepCallback(*this, needsReshapeFlag, pgmChangedFlag);
+	if (_renderPrepCallback != nullptr)	{
+		if (_callbacksUseStateCache)
+			_renderPrepCallback(*this, needsReshapeFlag, pgmChangedFlag);
+		else	{
+			GLStateCache::FlushReleases();
+			_renderPrepCallback(*this, needsReshapeFlag, pgmChangedFlag);
+			_context->stateCache().invalidate();
+		}
+	}
 	//cout << "\t" << __PRETTY_FUNCTION__ << "- FINISHED" << endl;
 }
 
@@ -870,18 +930,16 @@ void GLScene::_reshape()	{
 #endif
 		}
 		
-		glViewport(0,0,static_cast<GLsizei>(_orthoSize.width),static_cast<GLsizei>(_orthoSize.height));
-		GLERRLOG
+		GLStateCache::Viewport(0,0,static_cast<GLsizei>(_orthoSize.width),static_cast<GLsizei>(_orthoSize.height));
 	}
 	
 	_needsReshape = false;
 }
 
 void GLScene::_renderCleanup()	{
-	if (_context != nullptr)	{
-		glUseProgram(0);
-		GLERRLOG
-	}
+	//	the program and framebuffer are released- they're unbound when the outermost state cache scope closes, so consecutive renders that use the same program/framebuffer don't rebind them
+	if (_context != nullptr)
+		GLStateCache::ReleaseProgram();
 	//	flush
 	glFlush();
 	GLERRLOG
@@ -898,13 +956,53 @@ void GLScene::_renderCleanup()	{
 		}
 		*/
 		//	unbind the framebuffer
-		glBindFramebuffer(GL_FRAMEBUFFER,0);
-		GLERRLOG
+		GLStateCache::ReleaseFramebuffer();
 	}
 	
 	//	if there's a render cleanup callback, call it now
-	if (_renderCleanupCallback != nullptr)
-		_renderCleanupCallback(*this);
+	if (_renderCleanupCallback != nullptr)	{
+		if (_callbacksUseStateCache)
+			_renderCleanupCallback(*this);
+		else	{
+			GLStateCache::FlushReleases();
+			_renderCleanupCallback(*this);
+			_context->stateCache().invalidate();
+		}
+	}
+}
+void GLScene::_sharedProgramUsedElsewhere()	{
+	//	the projection matrix is a uniform, so it has to be pushed again
+	_needsReshape = true;
+}
+void GLScene::_releaseProgram()	{
+	_programReflection = nullptr;
+	if (_sharedProgram != nullptr)	{
+		//	the cache deletes the program (and its shaders) when the last scene using it releases it
+		GLProgramCache::Release(_sharedProgram);
+		_sharedProgram = nullptr;
+		_program = 0;
+	}
+	if (_program > 0)	{
+		glDeleteProgram(_program);
+		GLERRLOG
+		GLStateCache::NoteDeletedObjects();
+		_program = 0;
+	}
+	if (_vs > 0)	{
+		glDeleteShader(_vs);
+		GLERRLOG
+		_vs = 0;
+	}
+	if (_gs > 0)	{
+		glDeleteShader(_gs);
+		GLERRLOG
+		_gs = 0;
+	}
+	if (_fs > 0)	{
+		glDeleteShader(_fs);
+		GLERRLOG
+		_fs = 0;
+	}
 }
 
 
@@ -0,0 +1,438 @@
+#include "GLStateCache.hpp"
+#include "GLContext.hpp"
+
+#include <sstream>
+
+
+
+
+namespace VVGL
+{
+
+
+using namespace std;
+
+
+
+
+//	the innermost scope that's open on each thread (scopes are linked to the scope that was innermost when they were opened)
+static thread_local GLStateCache::Scope		*_innermostScope = nullptr;
+//	bumped every time GL objects are deleted (by any thread, in any context)- caches check it before they trust the objects they think are bound
+static atomic<uint64_t>		_deletedObjectsCount { 0 };
+
+
+
+
+#pragma mark --------------------- Stats
+
+
+string GLStateCache::Stats::getDescriptionString() const	{
+	ostringstream	returnMe;
+	returnMe << "<GLStateCache::Stats requests:" << requests << " elided:" << elided << " invalidations:" << invalidations << ">";
+	return returnMe.str();
+}
+
+
+
+
+#pragma mark --------------------- Scope
+
+
+GLStateCache::Scope::Scope(const GLContextRef & inCtx) : _ctx(inCtx)	{
+	if (_ctx == nullptr)
+		return;
+	GLStateCache		&cache = _ctx->stateCache();
+	//	we don't know what happened to the context before the outermost scope was opened
+	if (cache._scopeDepth == 0)
+		cache.invalidate();
+	++cache._scopeDepth;
+	_outerScope = _innermostScope;
+	_innermostScope = this;
+}
+GLStateCache::Scope::~Scope()	{
+	if (_ctx == nullptr)
+		return;
+	GLStateCache		&cache = _ctx->stateCache();
+	//	closing the outermost scope restores everything that was released (in the scope's context)
+	if (cache._scopeDepth == 1)	{
+		if (!_ctx->_isCachedAsCurrentContext())
+			_ctx->makeCurrentIfNotCurrent();
+		cache._flushReleases();
+	}
+	if (cache._scopeDepth > 0)
+		--cache._scopeDepth;
+	_innermostScope = _outerScope;
+}
+
+
+
+
+#pragma mark --------------------- instance methods
+
+
+GLStateCache::GLStateCache()	{
+	for (uint32_t i=0; i<MaxTexUnits; ++i)	{
+		for (int j=0; j<TexTarget_Count; ++j)
+			_textures[i][j] = Unknown;
+	}
+}
+void GLStateCache::invalidate()	{
+	_forgetObjects();
+	_activeTexUnit = Unknown;
+	_viewportKnown = false;
+	_clearColorKnown = false;
+	_invalidations.store(_invalidations.load(memory_order_relaxed)+1, memory_order_relaxed);
+}
+GLStateCache::Stats GLStateCache::getStats() const	{
+	Stats		returnMe;
+	returnMe.requests = _requests.load(memory_order_relaxed);
+	returnMe.elided = _elided.load(memory_order_relaxed);
+	returnMe.invalidations = _invalidations.load(memory_order_relaxed);
+	return returnMe;
+}
+GLStateCache::Stats GLStateCache::snapshotAndResetStats()	{
+	Stats		returnMe;
+	returnMe.requests = _requests.exchange(0, memory_order_relaxed);
+	returnMe.elided = _elided.exchange(0, memory_order_relaxed);
+	returnMe.invalidations = _invalidations.exchange(0, memory_order_relaxed);
+	return returnMe;
+}
+
+
+void GLStateCache::_checkForDeletions()	{
+	uint64_t		deletedCount = _deletedObjectsCount.load(memory_order_acquire);
+	if (deletedCount == _deletionCount)
+		return;
+	_deletionCount = deletedCount;
+	_forgetObjects();
+}
+void GLStateCache::_forgetObjects()	{
+	_deletionCount = _deletedObjectsCount.load(memory_order_acquire);
+	_program = Unknown;
+	_vertexArray = Unknown;
+	_readFramebuffer = Unknown;
+	_drawFramebuffer = Unknown;
+	for (uint32_t i=0; i<MaxTexUnits; ++i)	{
+		for (int j=0; j<TexTarget_Count; ++j)
+			_textures[i][j] = Unknown;
+	}
+}
+int GLStateCache::_IndexForTexTarget(const uint32_t & inTarget)	{
+	switch (inTarget)	{
+	case GL_TEXTURE_2D:			return TexTarget_2D;
+#if defined(GL_TEXTURE_RECTANGLE)
+	case GL_TEXTURE_RECTANGLE:	return TexTarget_Rect;
+#endif
+	case GL_TEXTURE_CUBE_MAP:	return TexTarget_Cube;
+	default:
+		break;
+	}
+	return -1;
+}
+void GLStateCache::_flushReleases()	{
+	if (_programReleased)
+		_useProgram(0);
+	if (_vertexArrayReleased)
+		_bindVertexArray(0);
+	if (_framebufferReleased)
+		_bindFramebuffer(GL_FRAMEBUFFER, 0);
+	for (int j=0; j<TexTarget_Count; ++j)	{
+		if (_texturesReleased[j] == 0)
+			continue;
+		uint32_t		target = GL_TEXTURE_2D;
+		switch (j)	{
+		case TexTarget_2D:		target = GL_TEXTURE_2D; break;
+#if defined(GL_TEXTURE_RECTANGLE)
+		case TexTarget_Rect:	target = GL_TEXTURE_RECTANGLE; break;
+#endif
+		case TexTarget_Cube:	target = GL_TEXTURE_CUBE_MAP; break;
+		default:				continue;
+		}
+		for (uint32_t i=0; i<MaxTexUnits; ++i)	{
+			if ((_texturesReleased[j] & (1u << i)) == 0)
+				continue;
+			_activeTexture(GL_TEXTURE0 + i);
+			_bindTexture(target, 0);
+		}
+		_texturesReleased[j] = 0;
+	}
+}
+
+
+void GLStateCache::_useProgram(const uint32_t & n)	{
+	_countRequest();
+	_checkForDeletions();
+	_programReleased = false;
+	if (_program == n)	{
+		_countElided();
+		return;
+	}
+	glUseProgram(n);
+	GLERRLOG
+	_program = n;
+}
+void GLStateCache::_bindVertexArray(const uint32_t & n)	{
+	_countRequest();
+	_checkForDeletions();
+	_vertexArrayReleased = false;
+	if (_vertexArray == n)	{
+		_countElided();
+		return;
+	}
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+	glBindVertexArray(n);
+	GLERRLOG
+	_vertexArray = n;
+#endif
+}
+void GLStateCache::_bindFramebuffer(const uint32_t & inTarget, const uint32_t & n)	{
+	_countRequest();
+	_checkForDeletions();
+	bool			bindsRead = true;
+	bool			bindsDraw = true;
+#if defined(GL_READ_FRAMEBUFFER)
+	if (inTarget == GL_READ_FRAMEBUFFER)
+		bindsDraw = false;
+	else if (inTarget == GL_DRAW_FRAMEBUFFER)
+		bindsRead = false;
+#endif
+	//	a release restores both bindings, so it's only replaced by a binding to GL_FRAMEBUFFER
+	if (bindsRead && bindsDraw)
+		_framebufferReleased = false;
+	if ((!bindsRead || _readFramebuffer==n) && (!bindsDraw || _drawFramebuffer==n))	{
+		_countElided();
+		return;
+	}
+	glBindFramebuffer(inTarget, n);
+	GLERRLOG
+	if (bindsRead)
+		_readFramebuffer = n;
+	if (bindsDraw)
+		_drawFramebuffer = n;
+}
+void GLStateCache::_activeTexture(const uint32_t & inUnit)	{
+	_countRequest();
+	uint32_t		unitIndex = inUnit - GL_TEXTURE0;
+	if (_activeTexUnit == unitIndex)	{
+		_countElided();
+		return;
+	}
+	glActiveTexture(inUnit);
+	GLERRLOG
+	_activeTexUnit = unitIndex;
+}
+void GLStateCache::_bindTexture(const uint32_t & inTarget, const uint32_t & n)	{
+	_countRequest();
+	_checkForDeletions();
+	int				targetIndex = _IndexForTexTarget(inTarget);
+	//	bindings on units/targets we don't track (or on a unit we don't know is active) are always passed to GL
+	if (targetIndex < 0 || _activeTexUnit >= MaxTexUnits)	{
+		glBindTexture(inTarget, n);
+		GLERRLOG
+		return;
+	}
+	_texturesReleased[targetIndex] &= ~(1u << _activeTexUnit);
+	uint32_t		&binding = _textures[_activeTexUnit][targetIndex];
+	if (binding == n)	{
+		_countElided();
+		return;
+	}
+	glBindTexture(inTarget, n);
+	GLERRLOG
+	binding = n;
+}
+void GLStateCache::_releaseTexture(const uint32_t & inTarget)	{
+	int				targetIndex = _IndexForTexTarget(inTarget);
+	if (targetIndex < 0 || _activeTexUnit >= MaxTexUnits)	{
+		_bindTexture(inTarget, 0);
+		return;
+	}
+	_countRequest();
+	_countElided();
+	_texturesReleased[targetIndex] |= (1u << _activeTexUnit);
+}
+void GLStateCache::_setViewport(const int32_t & inX, const int32_t & inY, const int32_t & inWidth, const int32_t & inHeight)	{
+	_countRequest();
+	if (_viewportKnown && _viewport[0]==inX && _viewport[1]==inY && _viewport[2]==inWidth && _viewport[3]==inHeight)	{
+		_countElided();
+		return;
+	}
+	glViewport(inX, inY, inWidth, inHeight);
+	GLERRLOG
+	_viewportKnown = true;
+	_viewport[0] = inX;
+	_viewport[1] = inY;
+	_viewport[2] = inWidth;
+	_viewport[3] = inHeight;
+}
+void GLStateCache::_setClearColor(const GLColor & n)	{
+	_countRequest();
+	if (_clearColorKnown && _clearColor==n)	{
+		_countElided();
+		return;
+	}
+	glClearColor(n.r, n.g, n.b, n.a);
+	GLERRLOG
+	_clearColorKnown = true;
+	_clearColor = n;
+}
+
+
+
+
+#pragma mark --------------------- static state change functions
+
+
+GLStateCache * GLStateCache::_Current()	{
+	Scope			*scope = _innermostScope;
+	if (scope == nullptr)
+		return nullptr;
+	//	usually the innermost scope's context is the current context
+	if (scope->_ctx->_isCachedAsCurrentContext())
+		return &scope->_ctx->stateCache();
+	//	...if it isn't, look for an outer scope on the current context.  scopes on other contexts whose native context may be the
+	//	current one (because another GLContext wraps it, or because we don't know what's current) are about to be changed behind their backs.
+	void			*currentNativeCtx = GLContext::_CachedCurrentNativeContext();
+	for ( ; scope!=nullptr; scope=scope->_outerScope)	{
+		if (scope->_ctx->_isCachedAsCurrentContext())
+			return &scope->_ctx->stateCache();
+		if (currentNativeCtx==nullptr || currentNativeCtx==scope->_ctx->_nativeContextHandle())
+			scope->_ctx->stateCache().invalidate();
+	}
+	return nullptr;
+}
+void GLStateCache::UseProgram(const uint32_t & n)	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)
+		cache->_useProgram(n);
+	else	{
+		glUseProgram(n);
+		GLERRLOG
+	}
+}
+void GLStateCache::ReleaseProgram()	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)	{
+		cache->_countRequest();
+		cache->_countElided();
+		cache->_programReleased = true;
+	}
+	else	{
+		glUseProgram(0);
+		GLERRLOG
+	}
+}
+void GLStateCache::BindVertexArray(const uint32_t & n)	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)
+		cache->_bindVertexArray(n);
+	else	{
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+		glBindVertexArray(n);
+		GLERRLOG
+#endif
+	}
+}
+void GLStateCache::ReleaseVertexArray()	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)	{
+		cache->_countRequest();
+		cache->_countElided();
+		cache->_vertexArrayReleased = true;
+	}
+	else	{
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+		glBindVertexArray(0);
+		GLERRLOG
+#endif
+	}
+}
+void GLStateCache::BindFramebuffer(const uint32_t & inTarget, const uint32_t & n)	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)
+		cache->_bindFramebuffer(inTarget, n);
+	else	{
+		glBindFramebuffer(inTarget, n);
+		GLERRLOG
+	}
+}
+void GLStateCache::ReleaseFramebuffer()	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)	{
+		cache->_countRequest();
+		cache->_countElided();
+		cache->_framebufferReleased = true;
+	}
+	else	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		GLERRLOG
+	}
+}
+void GLStateCache::ActiveTexture(const uint32_t & inUnit)	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)
+		cache->_activeTexture(inUnit);
+	else	{
+		glActiveTexture(inUnit);
+		GLERRLOG
+	}
+}
+void GLStateCache::BindTexture(const uint32_t & inTarget, const uint32_t & n)	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)
+		cache->_bindTexture(inTarget, n);
+	else	{
+		glBindTexture(inTarget, n);
+		GLERRLOG
+	}
+}
+void GLStateCache::ReleaseTexture(const uint32_t & inTarget)	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)
+		cache->_releaseTexture(inTarget);
+	else	{
+		glBindTexture(inTarget, 0);
+		GLERRLOG
+	}
+}
+void GLStateCache::Viewport(const int32_t & inX, const int32_t & inY, const int32_t & inWidth, const int32_t & inHeight)	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)
+		cache->_setViewport(inX, inY, inWidth, inHeight);
+	else	{
+		glViewport(inX, inY, inWidth, inHeight);
+		GLERRLOG
+	}
+}
+void GLStateCache::ClearColor(const GLColor & n)	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)
+		cache->_setClearColor(n);
+	else	{
+		glClearColor(n.r, n.g, n.b, n.a);
+		GLERRLOG
+	}
+}
+void GLStateCache::FlushReleasedProgram()	{
+	GLStateCache		*cache = _Current();
+	if (cache!=nullptr && cache->_programReleased)
+		cache->_useProgram(0);
+}
+void GLStateCache::FlushReleasedFramebuffer()	{
+	GLStateCache		*cache = _Current();
+	if (cache!=nullptr && cache->_framebufferReleased)
+		cache->_bindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+void GLStateCache::FlushReleases()	{
+	GLStateCache		*cache = _Current();
+	if (cache != nullptr)
+		cache->_flushReleases();
+}
+void GLStateCache::NoteDeletedObjects()	{
+	_deletedObjectsCount.fetch_add(1, memory_order_release);
+}
+
+
+
+
+}
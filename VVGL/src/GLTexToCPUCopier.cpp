@@ -1,5 +1,8 @@
 #include "GLTexToCPUCopier.hpp"
 #include <cstring> //memcpy
+#include <cmath>
+#include <algorithm>
+#include "VVGL_PixelConversion.hpp"
 
 
 
@@ -37,6 +40,17 @@ void GLTexToCPUCopier::clearStream()	{
 		_texQueue.pop();
 	while (_fboQueue.size() > 0)
 		_fboQueue.pop();
+	//	fenced downloads that haven't completed yet are abandoned (their callbacks aren't executed), but their fences still have to be deleted
+	if (_fencedQueue.size() > 0)	{
+		if (_queueCtx != nullptr)	{
+			_queueCtx->makeCurrentIfNotCurrent();
+			for (auto & download : _fencedQueue)	{
+				if (download.fence != nullptr)
+					glDeleteSync(download.fence);
+			}
+		}
+		_fencedQueue.clear();
+	}
 }
 void GLTexToCPUCopier::setQueueSize(const int & inNewQueueSize)	{
 	lock_guard<recursive_mutex>		lock(_queueLock);
@@ -52,6 +66,18 @@ void GLTexToCPUCopier::setQueueSize(const int & inNewQueueSize)	{
 	while (static_cast<int>(_texQueue.size()) > _queueSize)
 		_texQueue.pop();
 }
+void GLTexToCPUCopier::setMaxFencedQueueDepth(const int & n)	{
+	lock_guard<recursive_mutex>		lock(_queueLock);
+	_maxFencedQueueDepth = max(n, 1);
+	_fencedQueueDepth = min(_fencedQueueDepth, _maxFencedQueueDepth);
+}
+bool GLTexToCPUCopier::fencesAvailable()	{
+	lock_guard<recursive_mutex>		lock(_queueLock);
+	//	sync objects are core as of GL 3.2
+	if (_queueCtx == nullptr)
+		return false;
+	return (_queueCtx->version==GLVersion_33 || _queueCtx->version==GLVersion_4);
+}
 
 
 void GLTexToCPUCopier::_beginProcessing(const GLBufferRef & /*inCPUBuffer*/, const GLBufferRef & inPBOBuffer, const GLBufferRef & inTexBuffer, const GLBufferRef & inFBOBuffer)	{
@@ -79,8 +105,7 @@ void GLTexToCPUCopier::_beginProcessing(const GLBufferRef & /*inCPUBuffer*/, con
 	
 	
 	//	bind the framebuffer, attach the texture to it
-	glBindFramebuffer(GL_FRAMEBUFFER, inFBOBuffer->name);
-	GLERRLOG
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, inFBOBuffer->name);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, inTexBuffer->desc.target, inTexBuffer->name, 0);
 	GLERRLOG
 	
@@ -137,8 +162,7 @@ void GLTexToCPUCopier::_beginProcessing(const GLBufferRef & /*inCPUBuffer*/, con
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, 0, 0, 0);
 	GLERRLOG
 	*/
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	GLERRLOG
+	GLStateCache::ReleaseFramebuffer();
 }
 void GLTexToCPUCopier::_finishProcessing(const GLBufferRef & inCPUBuffer, const GLBufferRef & inPBOBuffer, const GLBufferRef & inTexBuffer, const GLBufferRef & /*inFBOBuffer*/)	{
 	/*
@@ -171,9 +195,17 @@ void GLTexToCPUCopier::_finishProcessing(const GLBufferRef & inCPUBuffer, const
 			size_t		pboBPR = inPBOBuffer->desc.bytesPerRowForWidth(static_cast<uint32_t>(inPBOBuffer->size.width));
 			uint8_t		*rPtr = static_cast<uint8_t*>(inPBOBuffer->cpuBackingPtr);
 			uint8_t		*wPtr = static_cast<uint8_t*>(inCPUBuffer->cpuBackingPtr);
-	
-			//	if the cpu buffer's bytes per row differs from the PBO's bytes per row, we have to copy one row at a time
-			if (cpuBPR != pboBPR)	{
+			PixelLayout		cpuLayout = PixelLayoutForDescriptor(inCPUBuffer->desc);
+			PixelLayout		pboLayout = PixelLayoutForDescriptor(inPBOBuffer->desc);
+			uint32_t		copyWidth = static_cast<uint32_t>(fmin(inCPUBuffer->size.width, inPBOBuffer->size.width));
+			uint32_t		copyHeight = static_cast<uint32_t>(fmin(inCPUBuffer->size.height, inPBOBuffer->size.height));
+	
+			//	if we know both layouts, convert (or just copy) the pixels straight out of the mapped PBO- large images are split across worker threads
+			if (ConvertPixels(rPtr, pboBPR, pboLayout, wPtr, cpuBPR, cpuLayout, copyWidth, copyHeight))	{
+				//	intentionally blank
+			}
+			//	else if the cpu buffer's bytes per row differs from the PBO's bytes per row, we have to copy one row at a time
+			else if (cpuBPR != pboBPR)	{
 				size_t		copyBytesPerRow = (cpuBPR<pboBPR) ? cpuBPR : pboBPR;
 				for (int i=0; i<inPBOBuffer->size.height; ++i)	{
 					memcpy(wPtr, rPtr, copyBytesPerRow);
@@ -210,6 +242,69 @@ void GLTexToCPUCopier::_finishProcessing(const GLBufferRef & inCPUBuffer, const
 	inPBOBuffer->flipped = inTexBuffer->flipped;
 	inPBOBuffer->contentTimestamp = inTexBuffer->contentTimestamp;
 }
+GLBufferRef GLTexToCPUCopier::_createPBOForTex(const GLBufferRef & inTexBuffer, const bool & createInCurrentContext, const GLBufferPoolRef & inPool)	{
+	if (inTexBuffer == nullptr)
+		return nullptr;
+	switch (inTexBuffer->desc.pixelFormat)	{
+	case GLBuffer::PF_RGBA:
+		return CreateRGBAPBO(GLBuffer::Target_PBOPack, GL_DYNAMIC_READ, inTexBuffer->size, nullptr, createInCurrentContext, inPool);
+	case GLBuffer::PF_BGRA:
+		return CreateBGRAPBO(GLBuffer::Target_PBOPack, GL_DYNAMIC_READ, inTexBuffer->size, nullptr, createInCurrentContext, inPool);
+	case GLBuffer::PF_YCbCr_422:
+		return CreateYCbCrPBO(GLBuffer::Target_PBOPack, GL_DYNAMIC_READ, inTexBuffer->size, nullptr, createInCurrentContext, inPool);
+	default:
+		break;
+	}
+	return nullptr;
+}
+int GLTexToCPUCopier::_finishFencedDownloads(const int & inWaitCount)	{
+	int			returnMe = 0;
+	while (_fencedQueue.size() > 0)	{
+		FencedDownload		&oldest = _fencedQueue.front();
+		//	check the fence without blocking- unless we still have to wait for more downloads to finish, in which case we block until it's signaled
+		bool			complete = false;
+		if (oldest.fence == nullptr)
+			complete = true;
+		else if (returnMe < inWaitCount)	{
+			GLenum			waitResult = GL_TIMEOUT_EXPIRED;
+			while (waitResult == GL_TIMEOUT_EXPIRED)
+				waitResult = glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+			GLERRLOG
+			if (waitResult == GL_WAIT_FAILED)
+				cout << "\tERR: glClientWaitSync() failed, " << __PRETTY_FUNCTION__ << endl;
+			complete = true;
+		}
+		else	{
+			GLenum			waitResult = glClientWaitSync(oldest.fence, 0, 0);
+			GLERRLOG
+			if (waitResult == GL_WAIT_FAILED)
+				cout << "\tERR: glClientWaitSync() failed, " << __PRETTY_FUNCTION__ << endl;
+			complete = (waitResult != GL_TIMEOUT_EXPIRED);
+		}
+		if (!complete)
+			break;
+		
+		//	pull the download out of the queue before we do anything else- the callback may start another download
+		FencedDownload		download = oldest;
+		_fencedQueue.pop_front();
+		if (download.fence != nullptr)
+			glDeleteSync(download.fence);
+		++returnMe;
+		
+		//	update the latency estimate, and size the queue so that there's room for as many downloads as the GPU is behind (plus one)
+		double			latency = (Timestamp() - download.submitTime).getTimeInSeconds();
+		_avgFenceLatency = (_avgFenceLatency <= 0.) ? latency : (_avgFenceLatency * 0.9) + (latency * 0.1);
+		if (_avgSubmitInterval > 0.)	{
+			int				framesBehind = static_cast<int>(ceil(_avgFenceLatency / _avgSubmitInterval));
+			_fencedQueueDepth = min(max(framesBehind + 1, 1), _maxFencedQueueDepth);
+		}
+		
+		_finishProcessing(download.cpu, download.pbo, download.tex, download.fbo);
+		if (download.callback != nullptr)
+			download.callback((download.cpu!=nullptr) ? download.cpu : download.pbo, download.tex);
+	}
+	return returnMe;
+}
 
 
 GLBufferRef GLTexToCPUCopier::downloadTexToCPU(const GLBufferRef & inTexBuffer, const GLBufferRef & inCPUBuffer, const bool & createInCurrentContext)	{
@@ -230,20 +325,7 @@ GLBufferRef GLTexToCPUCopier::downloadTexToCPU(const GLBufferRef & inTexBuffer,
 	//	make an FBO
 	GLBufferRef			tmpFBO = CreateFBO(createInCurrentContext, bp);
 	//	create a PBO for the texture
-	GLBufferRef			inPBOBuffer = nullptr;
-	switch (inTexBuffer->desc.pixelFormat)	{
-	case GLBuffer::PF_RGBA:
-		inPBOBuffer = CreateRGBAPBO(GLBuffer::Target_PBOPack, GL_DYNAMIC_READ, inTexBuffer->size, nullptr, createInCurrentContext, bp);
-		break;
-	case GLBuffer::PF_BGRA:
-		inPBOBuffer = CreateBGRAPBO(GLBuffer::Target_PBOPack, GL_DYNAMIC_READ, inTexBuffer->size, nullptr, createInCurrentContext, bp);
-		break;
-	case GLBuffer::PF_YCbCr_422:
-		inPBOBuffer = CreateYCbCrPBO(GLBuffer::Target_PBOPack, GL_DYNAMIC_READ, inTexBuffer->size, nullptr, createInCurrentContext, bp);
-		break;
-	default:
-		break;
-	}
+	GLBufferRef			inPBOBuffer = _createPBOForTex(inTexBuffer, createInCurrentContext, bp);
 	
 	if (inPBOBuffer==nullptr)
 		return nullptr;
@@ -274,7 +356,6 @@ GLBufferRef GLTexToCPUCopier::streamTexToCPU(const GLBufferRef & inTexBuffer, co
 		return nullptr;
 	}
 	
-	Size		texBufferDims = (inTexBuffer==nullptr) ? Size() : inTexBuffer->size;
 	bool		safeToPush = false;
 	bool		safeToPop = false;
 	//	we're safe to push if the queue isn't too large AND there's a non-null input buffer
@@ -290,19 +371,7 @@ GLBufferRef GLTexToCPUCopier::streamTexToCPU(const GLBufferRef & inTexBuffer, co
 	GLBufferRef		inPBOBuffer = nullptr;
 	if (safeToPush)	{
 		tmpFBO = CreateFBO(createInCurrentContext, bp);
-		switch (inTexBuffer->desc.pixelFormat)	{
-		case GLBuffer::PF_RGBA:
-			inPBOBuffer = CreateRGBAPBO(GLBuffer::Target_PBOPack, GL_DYNAMIC_READ, texBufferDims, nullptr, createInCurrentContext, bp);
-			break;
-		case GLBuffer::PF_BGRA:
-			inPBOBuffer = CreateBGRAPBO(GLBuffer::Target_PBOPack, GL_DYNAMIC_READ, texBufferDims, nullptr, createInCurrentContext, bp);
-			break;
-		case GLBuffer::PF_YCbCr_422:
-			inPBOBuffer = CreateYCbCrPBO(GLBuffer::Target_PBOPack, GL_DYNAMIC_READ, texBufferDims, nullptr, createInCurrentContext, bp);
-			break;
-		default:
-			break;
-		}
+		inPBOBuffer = _createPBOForTex(inTexBuffer, createInCurrentContext, bp);
 		
 		//	if we couldn't create the buffers we need then we're not safe to push, and if we're not safe to push then we're not safe to pop.
 		if (inPBOBuffer==nullptr)	{
@@ -339,6 +408,79 @@ GLBufferRef GLTexToCPUCopier::streamTexToCPU(const GLBufferRef & inTexBuffer, co
 	
 	return nullptr;
 }
+bool GLTexToCPUCopier::fencedStreamTexToCPU(const GLBufferRef & inTexBuffer, const GLTexToCPUCopierCallback & inCallback, const GLBufferRef & inCPUBuffer, const bool & createInCurrentContext)	{
+	if (inTexBuffer == nullptr)
+		return false;
+	
+	lock_guard<recursive_mutex>		lock(_queueLock);
+	
+	GLBufferPoolRef		bp = (_privatePool!=nullptr) ? _privatePool : GetGlobalBufferPool();
+	//	make the queue context current if appropriate- otherwise we are to assume that a GL context is current in this thread
+	if (!createInCurrentContext)
+		_queueCtx->makeCurrentIfNotCurrent();
+	
+	GLBufferRef		tmpFBO = CreateFBO(createInCurrentContext, bp);
+	GLBufferRef		tmpPBO = _createPBOForTex(inTexBuffer, createInCurrentContext, bp);
+	if (tmpFBO==nullptr || tmpPBO==nullptr)	{
+		cout << "\tERR: couldnt make PBO, " << __PRETTY_FUNCTION__ << endl;
+		return false;
+	}
+	
+	//	if we can't use fences, download the texture immediately
+	if (!fencesAvailable())	{
+		_beginProcessing(inCPUBuffer, tmpPBO, inTexBuffer, tmpFBO);
+		_finishProcessing(inCPUBuffer, tmpPBO, inTexBuffer, tmpFBO);
+		if (inCallback != nullptr)
+			inCallback((inCPUBuffer!=nullptr) ? inCPUBuffer : tmpPBO, inTexBuffer);
+		return true;
+	}
+	
+	//	track how often downloads are started, so we know how many frames of latency the GPU's measured latency corresponds to
+	Timestamp		now;
+	if (_hasSubmitted)	{
+		double			interval = (now - _lastSubmitTime).getTimeInSeconds();
+		_avgSubmitInterval = (_avgSubmitInterval <= 0.) ? interval : (_avgSubmitInterval * 0.9) + (interval * 0.1);
+	}
+	_lastSubmitTime = now;
+	_hasSubmitted = true;
+	
+	//	start the download, and put a fence behind it (_beginProcessing() flushes after the readback, so flush again to make sure the fence is submitted too)
+	FencedDownload		download;
+	download.cpu = inCPUBuffer;
+	download.pbo = tmpPBO;
+	download.tex = inTexBuffer;
+	download.fbo = tmpFBO;
+	download.callback = inCallback;
+	_beginProcessing(inCPUBuffer, tmpPBO, inTexBuffer, tmpFBO);
+	download.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	GLERRLOG
+	glFlush();
+	download.submitTime = Timestamp();
+	_fencedQueue.push_back(download);
+	
+	//	finish any downloads that have completed- if there are more downloads in flight than the queue allows, wait for the oldest ones
+	int				overflow = static_cast<int>(_fencedQueue.size()) - _fencedQueueDepth;
+	_finishFencedDownloads(max(overflow, 0));
+	return true;
+}
+int GLTexToCPUCopier::pollFencedStream(const bool & createInCurrentContext)	{
+	lock_guard<recursive_mutex>		lock(_queueLock);
+	if (_fencedQueue.size() == 0)
+		return 0;
+	if (!createInCurrentContext)
+		_queueCtx->makeCurrentIfNotCurrent();
+	return _finishFencedDownloads(0);
+}
+void GLTexToCPUCopier::finishFencedStream(const bool & createInCurrentContext)	{
+	lock_guard<recursive_mutex>		lock(_queueLock);
+	if (_fencedQueue.size() == 0)
+		return;
+	if (!createInCurrentContext)
+		_queueCtx->makeCurrentIfNotCurrent();
+	//	callbacks may start more downloads, so keep going until the queue is empty
+	while (_fencedQueue.size() > 0)
+		_finishFencedDownloads(static_cast<int>(_fencedQueue.size()));
+}
 
 
 
@@ -2,6 +2,8 @@
 
 #include <vector>
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 
 #include "GLContext.hpp"
 
@@ -17,6 +19,48 @@ using namespace std;
 
 
 
+#if defined(VVGL_TARGETENV_GL3PLUS)
+//	returns true if textures with the passed descriptor can be copied/blitted/cleared without drawing (uncompressed, single-sample 2D/RECT color textures)
+static bool FastPathCanUse(const GLBuffer::Descriptor & inDesc)	{
+	if (inDesc.type != GLBuffer::Type_Tex || inDesc.msAmount > 0)
+		return false;
+	switch (inDesc.target)	{
+	case GLBuffer::Target_2D:
+#if defined(VVGL_SDK_MAC) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN)
+	case GLBuffer::Target_Rect:
+#endif
+		break;
+	default:
+		return false;
+	}
+	//	YCbCr/depth textures aren't color-renderable
+	switch (static_cast<uint32_t>(inDesc.pixelFormat))	{
+	case GL_RED:
+	case GL_RGB:
+	case GL_RGBA:
+	case GL_BGRA:
+		break;
+	default:
+		return false;
+	}
+	//	compressed textures can't be attached to an FBO (and can only be copied to other compressed textures)
+	switch (static_cast<uint32_t>(inDesc.internalFormat))	{
+	case GL_RED:
+	case GL_RGB:
+	case GL_RGBA:
+	case GL_RGBA8:
+	case GL_RGBA16F:
+	case GL_RGBA32F:
+		return true;
+	default:
+		return false;
+	}
+}
+#endif	//	VVGL_TARGETENV_GL3PLUS
+
+
+
+
 /*	========================================	*/
 #pragma mark --------------------- constructor/destructor
 
@@ -45,6 +89,8 @@ GLTexToTexCopier::~GLTexToTexCopier()	{
 #elif defined(VVGL_TARGETENV_GLES)
 	_vbo = nullptr;
 #endif
+	_readFBO = nullptr;
+	_drawFBO = nullptr;
 }
 void GLTexToTexCopier::generalInit()	{
 	//cout << __PRETTY_FUNCTION__ << endl;
@@ -144,14 +190,26 @@ void main()	{\r\n\
 	
 	setRenderPrepCallback([&](const GLScene & /*n*/, const bool /*inReshaped*/, const bool & inPgmChanged) {
 		if (inPgmChanged)	{
-			_inputXYZLoc.cacheTheLoc(_program);
-			_inputSTLoc.cacheTheLoc(_program);
-			_inputImageLoc.cacheTheLoc(_program);
-			_inputImageRectLoc.cacheTheLoc(_program);
-			_isRectTexLoc.cacheTheLoc(_program);
+			GLProgramReflectionRef		reflection = programReflection();
+			if (reflection != nullptr)	{
+				_inputXYZLoc.cacheTheLoc(*reflection);
+				_inputSTLoc.cacheTheLoc(*reflection);
+				_inputImageLoc.cacheTheLoc(*reflection);
+				_inputImageRectLoc.cacheTheLoc(*reflection);
+				_isRectTexLoc.cacheTheLoc(*reflection);
+			}
+			else	{
+				_inputXYZLoc.purgeCache();
+				_inputSTLoc.purgeCache();
+				_inputImageLoc.purgeCache();
+				_inputImageRectLoc.purgeCache();
+				_isRectTexLoc.purgeCache();
+			}
 			_vboContents = Quad<VertXYZST>();
 		}
 	});
+	//	the prep callback doesn't change any bindings, so the scene doesn't have to invalidate the state cache after running it
+	_callbacksUseStateCache = true;
 }
 
 
@@ -200,6 +258,14 @@ SizingMode GLTexToTexCopier::copySizingMode()	{
 	lock_guard<recursive_mutex>		lock(_renderLock);
 	return _copySizingMode;
 }
+void GLTexToTexCopier::setFastPathsEnabled(const bool & n)	{
+	lock_guard<recursive_mutex>		lock(_renderLock);
+	_fastPathsEnabled = n;
+}
+bool GLTexToTexCopier::fastPathsEnabled()	{
+	lock_guard<recursive_mutex>		lock(_renderLock);
+	return _fastPathsEnabled;
+}
 
 
 /*	========================================	*/
@@ -232,6 +298,13 @@ GLBufferRef GLTexToTexCopier::copyToNewBuffer(const GLBufferRef & n)	{
 		return nullptr;
 	}
 	_context->makeCurrentIfNotCurrent();
+	GLStateCache::Scope		tmpScope(_context);
+	
+	//	try to copy/blit the texture before falling back to drawing it
+	if (_fastCopy(n, color, Rect(0,0,_orthoSize.width,_orthoSize.height)))	{
+		_renderTarget = RenderTarget();
+		return color;
+	}
 	
 	//	prep for render
 	_renderPrep();
@@ -278,6 +351,13 @@ bool GLTexToTexCopier::copyFromTo(const GLBufferRef & a, const GLBufferRef & b)
 	_context->makeCurrentIfNotCurrent();
 	//_context->makeCurrent();
 	//_context->makeCurrentIfNull();
+	GLStateCache::Scope		tmpScope(_context);
+	
+	//	try to copy/blit the texture before falling back to drawing it
+	if (_fastCopy(a, b, Rect(0,0,a->srcRect.size.width,a->srcRect.size.height)))	{
+		_renderTarget = RenderTarget();
+		return true;
+	}
 	
 	//	prep for render
 	_renderPrep();
@@ -321,13 +401,21 @@ void GLTexToTexCopier::sizeVariantCopy(const GLBufferRef & a, const GLBufferRef
 	_context->makeCurrentIfNotCurrent();
 	//_context->makeCurrent();
 	//_context->makeCurrentIfNull();
+	GLStateCache::Scope		tmpScope(_context);
+	
+	Rect					geometryRect = ResizeRect(a->srcRect, Rect(0,0,_orthoSize.width,_orthoSize.height), _copySizingMode);
+	
+	//	try to copy/blit the texture before falling back to drawing it
+	if (_fastCopy(a, b, geometryRect))	{
+		_renderTarget = RenderTarget();
+		return;
+	}
 	
 	//	prep for render
 	_renderPrep();
 	
 	//	assemble a quad object that describes what we're going to draw
 	Quad<VertXYZST>			targetQuad;
-	Rect					geometryRect = ResizeRect(a->srcRect, Rect(0,0,_orthoSize.width,_orthoSize.height), _copySizingMode);
 	targetQuad.populateGeo(geometryRect);
 	targetQuad.populateTex(a->glReadySrcRect(), a->flipped);
 	
@@ -362,6 +450,13 @@ void GLTexToTexCopier::ignoreSizeCopy(const GLBufferRef & a, const GLBufferRef &
 	_context->makeCurrentIfNotCurrent();
 	//_context->makeCurrent();
 	//_context->makeCurrentIfNull();
+	GLStateCache::Scope		tmpScope(_context);
+	
+	//	try to copy/blit the texture before falling back to drawing it
+	if (_fastCopy(a, b, Rect(0,0,a->srcRect.size.width,a->srcRect.size.height)))	{
+		_renderTarget = RenderTarget();
+		return;
+	}
 	
 	//	prep for render
 	_renderPrep();
@@ -388,6 +483,19 @@ void GLTexToTexCopier::copyBlackFrameTo(const GLBufferRef & n)	{
 	if (n == nullptr)
 		return;
 	
+	//	try to fill the texture directly before falling back to a render pass
+	{
+		lock_guard<recursive_mutex>		lock(_renderLock);
+		if (_context == nullptr)	{
+			cout << "\terr: bailing, ctx null, " << __PRETTY_FUNCTION__ << endl;
+			return;
+		}
+		_context->makeCurrentIfNotCurrent();
+		GLStateCache::Scope		tmpScope(_context);
+		if (_fastClear(n, GLColor(0., 0., 0., 0.)))
+			return;
+	}
+	
 	GLBufferPoolRef		bp = (_privatePool!=nullptr) ? _privatePool : GetGlobalBufferPool();
 	setOrthoSize(n->size);
 	
@@ -403,6 +511,19 @@ void GLTexToTexCopier::copyOpaqueBlackFrameTo(const GLBufferRef & n)	{
 	if (n == nullptr)
 		return;
 	
+	//	try to fill the texture directly before falling back to a render pass
+	{
+		lock_guard<recursive_mutex>		lock(_renderLock);
+		if (_context == nullptr)	{
+			cout << "\terr: bailing, ctx null, " << __PRETTY_FUNCTION__ << endl;
+			return;
+		}
+		_context->makeCurrentIfNotCurrent();
+		GLStateCache::Scope		tmpScope(_context);
+		if (_fastClear(n, GLColor(0., 0., 0., 1.)))
+			return;
+	}
+	
 	GLBufferPoolRef		bp = (_privatePool!=nullptr) ? _privatePool : GetGlobalBufferPool();
 	setOrthoSize(n->size);
 	
@@ -418,6 +539,19 @@ void GLTexToTexCopier::copyRedFrameTo(const GLBufferRef & n)	{
 	if (n == nullptr)
 		return;
 	
+	//	try to fill the texture directly before falling back to a render pass
+	{
+		lock_guard<recursive_mutex>		lock(_renderLock);
+		if (_context == nullptr)	{
+			cout << "\terr: bailing, ctx null, " << __PRETTY_FUNCTION__ << endl;
+			return;
+		}
+		_context->makeCurrentIfNotCurrent();
+		GLStateCache::Scope		tmpScope(_context);
+		if (_fastClear(n, GLColor(1., 0., 0., 1.)))
+			return;
+	}
+	
 	GLBufferPoolRef		bp = (_privatePool!=nullptr) ? _privatePool : GetGlobalBufferPool();
 	setOrthoSize(n->size);
 	
@@ -440,10 +574,8 @@ void GLTexToTexCopier::_drawBuffer(const GLBufferRef & inBufferRef, const Quad<V
 		if (inVertexStruct != _vboContents)	{
 			//cout << "\tvbo contents updated, repopulating\n";
 			//	bind the VAO
-			if (_vao != nullptr)	{
-				glBindVertexArray(_vao->name);
-				GLERRLOG
-			}
+			if (_vao != nullptr)
+				GLStateCache::BindVertexArray(_vao->name);
 			//	make a VBO, populate it with vertex data
 			uint32_t		tmpVBO = -1;
 			glGenBuffers(1, &tmpVBO);
@@ -464,8 +596,7 @@ void GLTexToTexCopier::_drawBuffer(const GLBufferRef & inBufferRef, const Quad<V
 				GLERRLOG
 			}
 			//	un-bind the VAO, we're done assembling it
-			glBindVertexArray(0);
-			GLERRLOG
+			GLStateCache::BindVertexArray(0);
 			//	delete the VBO
 			glDeleteBuffers(1, &tmpVBO);
 			GLERRLOG
@@ -476,15 +607,11 @@ void GLTexToTexCopier::_drawBuffer(const GLBufferRef & inBufferRef, const Quad<V
 		//	at this point we've got a VAO and it's guaranteed to have the correct geometry + texture coords- we just have to draw it
 	
 		//	bind the VAO
-		if (_vao != nullptr)	{
-			glBindVertexArray(_vao->name);
-			GLERRLOG
-		}
+		if (_vao != nullptr)
+			GLStateCache::BindVertexArray(_vao->name);
 		//	pass the 2D texture to the program (if there is a 2D texture)
-		glActiveTexture(GL_TEXTURE0);
-		GLERRLOG
-		glBindTexture(GL_TEXTURE_2D, (inBufferRef!=nullptr && inBufferRef->desc.target==GLBuffer::Target_2D) ? inBufferRef->name : 0);
-		GLERRLOG
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, (inBufferRef!=nullptr && inBufferRef->desc.target==GLBuffer::Target_2D) ? inBufferRef->name : 0);
 		//glBindTexture(GLBuffer::Target_2D, 0);
 		//GLERRLOG
 		if (_inputImageLoc.loc >= 0)	{
@@ -493,12 +620,10 @@ void GLTexToTexCopier::_drawBuffer(const GLBufferRef & inBufferRef, const Quad<V
 		}
 #if defined(VVGL_SDK_MAC) || defined(VVGL_SDK_WIN)
 		//	pass the RECT texture to the program (if there is a RECT texture)
-		glActiveTexture(GL_TEXTURE1);
-		GLERRLOG
+		GLStateCache::ActiveTexture(GL_TEXTURE1);
 		//glBindTexture(GL_TEXTURE_2D, 0);
 		//GLERRLOG
-		glBindTexture(GLBuffer::Target_Rect, (inBufferRef!=nullptr && inBufferRef->desc.target==GLBuffer::Target_Rect) ? inBufferRef->name : 0);
-		GLERRLOG
+		GLStateCache::BindTexture(GLBuffer::Target_Rect, (inBufferRef!=nullptr && inBufferRef->desc.target==GLBuffer::Target_Rect) ? inBufferRef->name : 0);
 		if (_inputImageRectLoc.loc >= 0)	{
 			glUniform1i(_inputImageRectLoc.loc, 1);
 			GLERRLOG
@@ -534,9 +659,8 @@ void GLTexToTexCopier::_drawBuffer(const GLBufferRef & inBufferRef, const Quad<V
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 		GLERRLOG
 	
-		//	unbind the VAO
-		glBindVertexArray(0);
-		GLERRLOG
+		//	unbind the VAO (deferred until the state cache scope closes)
+		GLStateCache::ReleaseVertexArray();
 #endif	//	VVGL_TARGETENV_GL3PLUS || VVGL_TARGETENV_GLES3
 	}
 	else if (myVers==GLVersion_ES)	{
@@ -574,10 +698,8 @@ void GLTexToTexCopier::_drawBuffer(const GLBufferRef & inBufferRef, const Quad<V
 		//	pass the 2D texture to the program (if there is a 2D texture)
 		//glEnable(GL_TEXTURE_2D);
 		//GLERRLOG
-		glActiveTexture(GL_TEXTURE0);
-		GLERRLOG
-		glBindTexture(GL_TEXTURE_2D, (inBufferRef!=nullptr && inBufferRef->desc.target==GLBuffer::Target_2D) ? inBufferRef->name : 0);
-		GLERRLOG
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
+		GLStateCache::BindTexture(GL_TEXTURE_2D, (inBufferRef!=nullptr && inBufferRef->desc.target==GLBuffer::Target_2D) ? inBufferRef->name : 0);
 		//glBindTexture(GLBuffer::Target_2D, 0);
 		//GLERRLOG
 		if (_inputImageLoc.loc >= 0)	{
@@ -627,8 +749,7 @@ void GLTexToTexCopier::_drawBuffer(const GLBufferRef & inBufferRef, const Quad<V
 	}
 	else if (myVers==GLVersion_2)	{
 #if defined(VVGL_TARGETENV_GL2)
-		glActiveTexture(GL_TEXTURE0);
-		GLERRLOG
+		GLStateCache::ActiveTexture(GL_TEXTURE0);
 		glEnable(inBufferRef->desc.target);
 		GLERRLOG
 		/*
@@ -656,12 +777,10 @@ void GLTexToTexCopier::_drawBuffer(const GLBufferRef & inBufferRef, const Quad<V
 		GLERRLOG
 		glTexCoordPointer(2, GL_FLOAT, (int)inVertexStruct.stride(), &inVertexStruct.bl.tex.s);
 		GLERRLOG
-		glBindTexture(inBufferRef->desc.target, inBufferRef->name);
-		GLERRLOG
+		GLStateCache::BindTexture(inBufferRef->desc.target, inBufferRef->name);
 		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 		GLERRLOG
-		glBindTexture(inBufferRef->desc.target, 0);
-		GLERRLOG
+		GLStateCache::ReleaseTexture(inBufferRef->desc.target);
 		glDisable(inBufferRef->desc.target);
 		GLERRLOG
 	
@@ -672,6 +791,159 @@ void GLTexToTexCopier::_drawBuffer(const GLBufferRef & inBufferRef, const Quad<V
 }
 
 
+/*	========================================	*/
+#pragma mark --------------------- fast paths
+
+
+bool GLTexToTexCopier::_fastCopy(const GLBufferRef & a, const GLBufferRef & b, const Rect & inDstRect)	{
+	if (!_fastPathsEnabled || a==nullptr || b==nullptr || a->name==b->name)
+		return false;
+	GLVersion			myVers = glVersion();
+	if (myVers!=GLVersion_33 && myVers!=GLVersion_4)
+		return false;
+#if defined(VVGL_TARGETENV_GL3PLUS)
+	if (!FastPathCanUse(a->desc) || !FastPathCanUse(b->desc))
+		return false;
+	GLint			srcX = static_cast<GLint>(round(a->srcRect.origin.x));
+	GLint			srcY = static_cast<GLint>(round(a->srcRect.origin.y));
+	GLint			srcW = static_cast<GLint>(round(a->srcRect.size.width));
+	GLint			srcH = static_cast<GLint>(round(a->srcRect.size.height));
+	GLint			dstX = static_cast<GLint>(round(inDstRect.origin.x));
+	GLint			dstY = static_cast<GLint>(round(inDstRect.origin.y));
+	GLint			dstW = static_cast<GLint>(round(inDstRect.size.width));
+	GLint			dstH = static_cast<GLint>(round(inDstRect.size.height));
+	GLint			texW = static_cast<GLint>(round(b->size.width));
+	GLint			texH = static_cast<GLint>(round(b->size.height));
+	if (srcW<=0 || srcH<=0 || dstW<=0 || dstH<=0 || texW<=0 || texH<=0)
+		return false;
+	//	the draw path clears the whole texture before it draws- if the copy doesn't cover the whole texture, we have to clear it, too
+	bool			clearFirst = (_performClear && (dstX>0 || dstY>0 || dstX+dstW<texW || dstY+dstH<texH));
+	
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+	//	same size, same format, not flipped: copy the texels directly (no FBOs, no sampling)
+	if (glCopyImageSubData != nullptr
+	&& srcW==dstW && srcH==dstH
+	&& !a->flipped
+	&& dstX>=0 && dstY>=0
+	&& a->desc.internalFormat==b->desc.internalFormat
+	&& a->desc.pixelType==b->desc.pixelType)	{
+		//	the copy is clipped to the destination texture (the draw path would have cropped it)
+		GLint			copyW = min(srcW, texW-dstX);
+		GLint			copyH = min(srcH, texH-dstY);
+		if (copyW>0 && copyH>0 && srcX>=0 && srcY>=0)	{
+			if (clearFirst && !_fastClear(b, _clearColor))
+				return false;
+			glCopyImageSubData(a->name, a->desc.target, 0, srcX, srcY, 0,
+				b->name, b->desc.target, 0, dstX, dstY, 0,
+				copyW, copyH, 1);
+			GLERRLOG
+			glFlush();
+			GLERRLOG
+			return true;
+		}
+	}
+#endif
+	
+	//	everything else is blitted: attach the textures to a pair of FBOs that belong to my context
+	GLBufferPoolRef		bp = (_privatePool!=nullptr) ? _privatePool : GetGlobalBufferPool();
+	if (_readFBO == nullptr)
+		_readFBO = CreateFBO(true, bp);
+	if (_drawFBO == nullptr)
+		_drawFBO = CreateFBO(true, bp);
+	if (_readFBO == nullptr || _drawFBO == nullptr)
+		return false;
+	
+	GLStateCache::BindFramebuffer(GL_READ_FRAMEBUFFER, _readFBO->name);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, a->desc.target, a->name, 0);
+	GLERRLOG
+	GLStateCache::BindFramebuffer(GL_DRAW_FRAMEBUFFER, _drawFBO->name);
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, b->desc.target, b->name, 0);
+	GLERRLOG
+	
+	bool			returnMe = false;
+	if (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER)==GL_FRAMEBUFFER_COMPLETE && glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER)==GL_FRAMEBUFFER_COMPLETE)	{
+		if (clearFirst)	{
+			GLStateCache::ClearColor(_clearColor);
+			glClear(GL_COLOR_BUFFER_BIT);
+			GLERRLOG
+		}
+		//	the draw path flips the texture vertically if it's flipped- blitting from the top row to the bottom row does the same
+		glBlitFramebuffer(srcX, (a->flipped) ? srcY+srcH : srcY, srcX+srcW, (a->flipped) ? srcY : srcY+srcH,
+			dstX, dstY, dstX+dstW, dstY+dstH,
+			GL_COLOR_BUFFER_BIT,
+			(srcW==dstW && srcH==dstH) ? GL_NEAREST : GL_LINEAR);
+		GLERRLOG
+		returnMe = true;
+	}
+	
+	//	detach the textures (so the FBOs don't keep them alive in the GL) and unbind
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, a->desc.target, 0, 0);
+	GLERRLOG
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, b->desc.target, 0, 0);
+	GLERRLOG
+	GLStateCache::ReleaseFramebuffer();
+	if (returnMe)	{
+		glFlush();
+		GLERRLOG
+	}
+	return returnMe;
+#else
+	return false;
+#endif	//	VVGL_TARGETENV_GL3PLUS
+}
+bool GLTexToTexCopier::_fastClear(const GLBufferRef & n, const GLColor & inColor)	{
+	if (!_fastPathsEnabled || n==nullptr)
+		return false;
+	GLVersion			myVers = glVersion();
+	if (myVers!=GLVersion_33 && myVers!=GLVersion_4)
+		return false;
+#if defined(VVGL_TARGETENV_GL3PLUS)
+	if (!FastPathCanUse(n->desc))
+		return false;
+#if defined(VVGL_SDK_GLFW) || defined(VVGL_SDK_QT) || defined(VVGL_SDK_WIN) || defined(VVGL_SDK_EGL)
+	//	clear the texture directly (no FBO)- the float color is converted to the texture's internal format
+	if (glClearTexImage != nullptr)	{
+		const float		color[] = { inColor.r, inColor.g, inColor.b, inColor.a };
+		glClearTexImage(n->name, 0, GL_RGBA, GL_FLOAT, color);
+		GLERRLOG
+		glFlush();
+		GLERRLOG
+		return true;
+	}
+#endif
+	
+	//	attach the texture to an FBO that belongs to my context and clear it (no program, no reshape)
+	GLBufferPoolRef		bp = (_privatePool!=nullptr) ? _privatePool : GetGlobalBufferPool();
+	if (_drawFBO == nullptr)
+		_drawFBO = CreateFBO(true, bp);
+	if (_drawFBO == nullptr)
+		return false;
+	
+	GLStateCache::BindFramebuffer(GL_FRAMEBUFFER, _drawFBO->name);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, n->desc.target, n->name, 0);
+	GLERRLOG
+	bool			returnMe = false;
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)	{
+		GLStateCache::ClearColor(inColor);
+		glClear(GL_COLOR_BUFFER_BIT);
+		GLERRLOG
+		returnMe = true;
+	}
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, n->desc.target, 0, 0);
+	GLERRLOG
+	GLStateCache::ReleaseFramebuffer();
+	if (returnMe)	{
+		glFlush();
+		GLERRLOG
+	}
+	return returnMe;
+#else
+	return false;
+#endif	//	VVGL_TARGETENV_GL3PLUS
+}
+
+
+
 
 
 }
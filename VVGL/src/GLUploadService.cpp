@@ -0,0 +1,366 @@
+#include "GLUploadService.hpp"
+
+#include <iostream>
+
+
+
+
+//	none of this stuff should be available if we're running ES
+#if !defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
+
+
+
+
+namespace VVGL
+{
+
+
+using namespace std;
+
+
+
+
+/*	========================================	*/
+#pragma mark --------------------- GLUploadFence
+
+
+GLUploadFence::~GLUploadFence()	{
+	//	we can't delete the sync object here (there may not be a context current on this thread), so hand it to the upload thread
+	if (_sync == nullptr || _graveyard == nullptr)
+		return;
+	lock_guard<mutex>		lock(_graveyard->lock);
+	//	if the upload thread has exited there's nobody left to delete the sync object (and no context we know is current), so it's leaked
+	if (_graveyard->closed)
+		return;
+	_graveyard->syncs.push_back(_sync);
+}
+void GLUploadFence::waitGPU()	{
+	if (_sync == nullptr || _signaled)
+		return;
+	glWaitSync(_sync, 0, GL_TIMEOUT_IGNORED);
+	GLERRLOG
+}
+bool GLUploadFence::waitCPU(const uint64_t & inTimeoutNanos)	{
+	if (_sync == nullptr || _signaled)
+		return true;
+	GLenum			waitResult = glClientWaitSync(_sync, GL_SYNC_FLUSH_COMMANDS_BIT, inTimeoutNanos);
+	GLERRLOG
+	if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED)
+		_signaled = true;
+	return _signaled;
+}
+bool GLUploadFence::isSignaled()	{
+	if (_sync == nullptr || _signaled)
+		return true;
+	GLenum			waitResult = glClientWaitSync(_sync, 0, 0);
+	GLERRLOG
+	if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED)
+		_signaled = true;
+	return _signaled;
+}
+
+
+
+
+/*	========================================	*/
+#pragma mark --------------------- constructor/destructor
+
+
+GLUploadService::GLUploadService(const GLBufferPoolRef & inPool, const GLContextRef & inCtx) : _pool(inPool), _ctx(inCtx)	{
+	if (_pool == nullptr || _pool->context() == nullptr)	{
+		cout << "ERR: no pool/context in " << __PRETTY_FUNCTION__ << endl;
+		return;
+	}
+
+	//	the upload thread's context has to be current on the upload thread, and only the upload thread.  creating a
+	//	context usually makes it current on the thread that created it, so the upload thread creates its own context.
+	//	a QOpenGLContext is the exception: it can only be made current on the thread it belongs to, and only the thread
+	//	that owns it can move it- so the upload thread tells us which QThread it is, we create the context and move it
+	//	to that thread, and then we tell the upload thread to proceed.  the startup vars are in a shared_ptr because
+	//	the upload thread may still be unlocking them after the constructor returns.
+	struct Startup	{
+		mutex				lock;
+		condition_variable	condition;
+		bool				ready = false;
+#if defined(VVGL_SDK_QT)
+		QThread				*uploadThread = nullptr;
+#endif
+	};
+	shared_ptr<Startup>		startup = make_shared<Startup>();
+
+	_thread = thread([this,startup]()	{
+#if defined(VVGL_SDK_QT)
+		{
+			unique_lock<mutex>		lock(startup->lock);
+			startup->uploadThread = QThread::currentThread();
+			startup->condition.notify_all();
+			startup->condition.wait(lock, [&]() { return startup->ready; });
+		}
+#else
+		if (_ctx == nullptr)
+			_ctx = _pool->context()->newContextSharingMe();
+		if (_ctx != nullptr)	{
+			_copier = CreateGLCPUToTexCopierRefUsing(_ctx);
+			_copier->setPrivatePool(_pool);
+		}
+		{
+			lock_guard<mutex>		lock(startup->lock);
+			startup->ready = true;
+		}
+		startup->condition.notify_all();
+#endif
+		_threadLoop();
+	});
+
+	unique_lock<mutex>		lock(startup->lock);
+#if defined(VVGL_SDK_QT)
+	startup->condition.wait(lock, [&]() { return startup->uploadThread != nullptr; });
+	if (_ctx == nullptr)
+		_ctx = _pool->context()->newContextSharingMe();
+	if (_ctx != nullptr)	{
+		_ctxHomeThread = _ctx->contextThread();
+		_ctx->moveToThread(startup->uploadThread);
+		_copier = CreateGLCPUToTexCopierRefUsing(_ctx);
+		_copier->setPrivatePool(_pool);
+	}
+	startup->ready = true;
+	lock.unlock();
+	startup->condition.notify_all();
+#else
+	startup->condition.wait(lock, [&]() { return startup->ready; });
+#endif
+}
+GLUploadService::~GLUploadService()	{
+	//	the jobs we discard are freed after we unlock
+	map<int,UploadJob>		discardedJobs;
+	{
+		lock_guard<mutex>		lock(_lock);
+		_quit = true;
+		_jobOrder.clear();
+		swap(discardedJobs, _jobs);
+	}
+	_condition.notify_all();
+	//	the upload thread frees the latest uploads (and deletes the sync objects of their fences) before it exits
+	if (_thread.joinable())
+		_thread.join();
+}
+
+
+
+
+/*	========================================	*/
+#pragma mark --------------------- public methods
+
+
+bool GLUploadService::submit(const int & inSourceIndex, const GLBufferRef & inCPUBuffer, const GLUploadServiceCallback & inCallback, const GLBufferRef & inTexBuffer)	{
+	if (inCPUBuffer == nullptr)
+		return false;
+
+	UploadJob			newJob;
+	newJob.sourceIndex = inSourceIndex;
+	newJob.cpu = inCPUBuffer;
+	newJob.tex = inTexBuffer;
+	newJob.callback = inCallback;
+
+	//	the buffer we replace (if any) is freed after we unlock
+	UploadJob			droppedJob;
+	{
+		lock_guard<mutex>		lock(_lock);
+		if (_quit || !_thread.joinable())
+			return false;
+		auto				it = _jobs.find(inSourceIndex);
+		//	if this source already has a job waiting, replace it (but keep its place in line)
+		if (it != _jobs.end())	{
+			droppedJob = move(it->second);
+			it->second = move(newJob);
+			++_dropCount;
+		}
+		else	{
+			_jobs[inSourceIndex] = move(newJob);
+			_jobOrder.push_back(inSourceIndex);
+		}
+	}
+	_condition.notify_all();
+	return true;
+}
+GLUploadedTex GLUploadService::latestUpload(const int & inSourceIndex)	{
+	lock_guard<mutex>		lock(_lock);
+	auto				it = _latestUploads.find(inSourceIndex);
+	if (it == _latestUploads.end())	{
+		GLUploadedTex		returnMe;
+		returnMe.sourceIndex = inSourceIndex;
+		return returnMe;
+	}
+	return it->second;
+}
+void GLUploadService::clearSource(const int & inSourceIndex)	{
+	//	the buffers we remove are freed after we unlock
+	UploadJob			droppedJob;
+	GLUploadedTex		droppedUpload;
+	{
+		lock_guard<mutex>		lock(_lock);
+		auto				jobIt = _jobs.find(inSourceIndex);
+		if (jobIt != _jobs.end())	{
+			droppedJob = move(jobIt->second);
+			_jobs.erase(jobIt);
+			for (auto orderIt=_jobOrder.begin(); orderIt!=_jobOrder.end(); ++orderIt)	{
+				if (*orderIt == inSourceIndex)	{
+					_jobOrder.erase(orderIt);
+					break;
+				}
+			}
+		}
+		auto				uploadIt = _latestUploads.find(inSourceIndex);
+		if (uploadIt != _latestUploads.end())	{
+			droppedUpload = move(uploadIt->second);
+			_latestUploads.erase(uploadIt);
+		}
+	}
+	_condition.notify_all();
+}
+void GLUploadService::waitUntilIdle()	{
+	unique_lock<mutex>		lock(_lock);
+	_condition.wait(lock, [&]() { return _quit || (_jobOrder.size()==0 && !_busy); });
+}
+uint64_t GLUploadService::uploadCount()	{
+	lock_guard<mutex>		lock(_lock);
+	return _uploadCount;
+}
+uint64_t GLUploadService::dropCount()	{
+	lock_guard<mutex>		lock(_lock);
+	return _dropCount;
+}
+size_t GLUploadService::pendingCount()	{
+	lock_guard<mutex>		lock(_lock);
+	return _jobOrder.size();
+}
+
+
+
+
+/*	========================================	*/
+#pragma mark --------------------- upload thread
+
+
+void GLUploadService::_threadLoop()	{
+	if (_ctx == nullptr || _copier == nullptr)	{
+		cout << "ERR: couldn't create context in " << __PRETTY_FUNCTION__ << endl;
+		{
+			lock_guard<mutex>		lock(_lock);
+			_quit = true;
+		}
+		_condition.notify_all();
+		return;
+	}
+	_ctx->makeCurrent();
+
+	while (true)	{
+		UploadJob			job;
+		{
+			unique_lock<mutex>		lock(_lock);
+			_condition.wait(lock, [&]() { return _quit || _jobOrder.size()>0; });
+			if (_quit)
+				break;
+			int					sourceIndex = _jobOrder.front();
+			_jobOrder.pop_front();
+			auto				it = _jobs.find(sourceIndex);
+			if (it == _jobs.end())
+				continue;
+			job = move(it->second);
+			_jobs.erase(it);
+			_busy = true;
+		}
+
+		_emptyGraveyard();
+
+		GLUploadedTex		upload = _upload(job);
+
+		//	the previous upload for this source is freed after we unlock
+		GLUploadedTex		previousUpload;
+		if (upload.tex != nullptr)	{
+			lock_guard<mutex>		lock(_lock);
+			auto				it = _latestUploads.find(job.sourceIndex);
+			if (it != _latestUploads.end())	{
+				previousUpload = move(it->second);
+				it->second = upload;
+			}
+			else
+				_latestUploads[job.sourceIndex] = upload;
+			++_uploadCount;
+		}
+
+		if (job.callback != nullptr && upload.tex != nullptr)
+			job.callback(upload);
+
+		{
+			lock_guard<mutex>		lock(_lock);
+			_busy = false;
+		}
+		_condition.notify_all();
+	}
+
+	//	free the copier (and its GL resources) while the context is still current on this thread
+	_copier = nullptr;
+	//	free the latest uploads here too, so the sync objects of any fences nobody else is holding are deleted
+	map<int,GLUploadedTex>		discardedUploads;
+	{
+		lock_guard<mutex>		lock(_lock);
+		swap(discardedUploads, _latestUploads);
+	}
+	discardedUploads.clear();
+	_emptyGraveyard(true);
+
+#if defined(VVGL_SDK_QT)
+	//	hand the context back to the thread it was created on, so it can be freed there
+	if (_ctxHomeThread != nullptr)
+		_ctx->moveToThread(_ctxHomeThread);
+#endif
+}
+GLUploadedTex GLUploadService::_upload(const UploadJob & inJob)	{
+	GLUploadedTex		returnMe;
+	returnMe.sourceIndex = inJob.sourceIndex;
+	returnMe.cpu = inJob.cpu;
+	if (_copier == nullptr)
+		return returnMe;
+
+	//	the copier makes its context current, and creates the texture in it (it shares the pool's context)
+	if (inJob.tex == nullptr)
+		returnMe.tex = _copier->uploadCPUToTex(inJob.cpu, true);
+	else
+		returnMe.tex = _copier->uploadCPUToTex(inJob.cpu, inJob.tex, true);
+	if (returnMe.tex == nullptr)
+		return returnMe;
+
+	//	place a fence behind the upload and flush it so other contexts can wait on it
+	GLsync				sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	GLERRLOG
+	glFlush();
+	GLERRLOG
+	if (sync != nullptr)
+		returnMe.fence = make_shared<GLUploadFence>(sync, _graveyard);
+
+	return returnMe;
+}
+void GLUploadService::_emptyGraveyard(const bool & inClose)	{
+	vector<GLsync>		tmpSyncs;
+	{
+		lock_guard<mutex>		lock(_graveyard->lock);
+		swap(tmpSyncs, _graveyard->syncs);
+		if (inClose)
+			_graveyard->closed = true;
+	}
+	for (const GLsync & tmpSync : tmpSyncs)	{
+		glDeleteSync(tmpSync);
+		GLERRLOG
+	}
+}
+
+
+
+
+}
+
+
+
+
+#endif	//	!defined(VVGL_TARGETENV_GLES) && !defined(VVGL_TARGETENV_GLES3)
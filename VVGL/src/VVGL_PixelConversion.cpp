@@ -0,0 +1,808 @@
+#include "VVGL_PixelConversion.hpp"
+
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define VVGL_PIXCONV_X86
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#define VVGL_PIXCONV_NEON
+	#include <arm_neon.h>
+#endif
+
+//	gcc/clang need to be told which functions may use instructions the rest of the lib isn't compiled for.  msvc doesn't.
+#if defined(VVGL_PIXCONV_X86) && (defined(__GNUC__) || defined(__clang__))
+	#define VVGL_PIXCONV_TARGET(x) __attribute__((target(x)))
+#else
+	#define VVGL_PIXCONV_TARGET(x)
+#endif
+
+
+
+
+namespace VVGL
+{
+
+
+using namespace std;
+
+
+
+
+#pragma mark --------------------- scalar kernels
+
+
+namespace	{
+
+
+//	the fixed-point (6-bit) BT.601 video-range coefficients used by every UYVY kernel, so the SIMD and scalar paths produce identical results
+const int		kUYVY_Y = 75;	//	1.164
+const int		kUYVY_RV = 102;	//	1.596
+const int		kUYVY_GU = 25;	//	0.391
+const int		kUYVY_GV = 52;	//	0.813
+const int		kUYVY_BU = 129;	//	2.018
+
+const float		kOneOver255 = 1.0f / 255.0f;
+
+
+void Swizzle8_Scalar(const uint8_t * inSrc, uint8_t * outDst, size_t inPixelCount)	{
+	for (size_t i=0; i<inPixelCount; ++i)	{
+		uint8_t			r = inSrc[0];
+		uint8_t			g = inSrc[1];
+		uint8_t			b = inSrc[2];
+		uint8_t			a = inSrc[3];
+		outDst[0] = b;
+		outDst[1] = g;
+		outDst[2] = r;
+		outDst[3] = a;
+		inSrc += 4;
+		outDst += 4;
+	}
+}
+void Swizzle32F_Scalar(const float * inSrc, float * outDst, size_t inPixelCount)	{
+	for (size_t i=0; i<inPixelCount; ++i)	{
+		float			r = inSrc[0];
+		float			g = inSrc[1];
+		float			b = inSrc[2];
+		float			a = inSrc[3];
+		outDst[0] = b;
+		outDst[1] = g;
+		outDst[2] = r;
+		outDst[3] = a;
+		inSrc += 4;
+		outDst += 4;
+	}
+}
+void U8ToFloat_Scalar(const uint8_t * inSrc, float * outDst, size_t inCount)	{
+	for (size_t i=0; i<inCount; ++i)
+		outDst[i] = float(inSrc[i]) * kOneOver255;
+}
+void FloatToU8_Scalar(const float * inSrc, uint8_t * outDst, size_t inCount)	{
+	for (size_t i=0; i<inCount; ++i)	{
+		//	written so NaNs become 0 (like the SIMD kernels)
+		float			val = (inSrc[i] > 0.f) ? inSrc[i] : 0.f;
+		val = (val < 1.f) ? val : 1.f;
+		outDst[i] = static_cast<uint8_t>(val * 255.f + 0.5f);
+	}
+}
+inline uint16_t FloatToHalf(const float & inVal)	{
+	uint32_t		bits;
+	memcpy(&bits, &inVal, sizeof(bits));
+	uint32_t		sign = (bits >> 16) & 0x8000;
+	uint32_t		absBits = bits & 0x7FFFFFFF;
+	//	inf and NaN (NaNs stay quiet NaNs)
+	if (absBits >= 0x7F800000)
+		return static_cast<uint16_t>(sign | 0x7C00 | ((absBits > 0x7F800000) ? (0x200 | ((absBits >> 13) & 0x3FF)) : 0));
+	//	too large for a half
+	if (absBits >= 0x47800000)
+		return static_cast<uint16_t>(sign | 0x7C00);
+	//	half subnormals (and values that round to zero)
+	if (absBits < 0x38800000)	{
+		if (absBits <= 0x33000000)
+			return static_cast<uint16_t>(sign);
+		uint32_t		exponent = absBits >> 23;
+		uint32_t		mantissa = (absBits & 0x7FFFFF) | 0x800000;
+		uint32_t		shift = 126 - exponent;
+		uint32_t		returnMe = mantissa >> shift;
+		uint32_t		remainder = mantissa & ((1u << shift) - 1);
+		uint32_t		halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (returnMe & 1)))
+			++returnMe;
+		return static_cast<uint16_t>(sign | returnMe);
+	}
+	//	normal values- rebias the exponent and round the mantissa to nearest even (a carry out of the mantissa rounds up to the next exponent, or inf)
+	uint32_t		returnMe = (absBits - 0x38000000) >> 13;
+	uint32_t		remainder = absBits & 0x1FFF;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (returnMe & 1)))
+		++returnMe;
+	return static_cast<uint16_t>(sign | returnMe);
+}
+void FloatToHalf_Scalar(const float * inSrc, uint16_t * outDst, size_t inCount)	{
+	for (size_t i=0; i<inCount; ++i)
+		outDst[i] = FloatToHalf(inSrc[i]);
+}
+inline uint8_t ClampToU8(const int & inVal)	{
+	return static_cast<uint8_t>((inVal < 0) ? 0 : ((inVal > 255) ? 255 : inVal));
+}
+void UYVYToRGBA8_Scalar(const uint8_t * inSrc, uint8_t * outDst, size_t inPixelCount)	{
+	for (size_t i=0; i<inPixelCount; i+=2)	{
+		int				d = int(inSrc[0]) - 128;
+		int				e = int(inSrc[2]) - 128;
+		int				rOffset = (kUYVY_RV * e);
+		int				gOffset = -(kUYVY_GU * d) - (kUYVY_GV * e);
+		int				bOffset = (kUYVY_BU * d);
+		//	if the pixel count is odd, the last pixel is converted with the chroma of its (unused) pair
+		int				pixelsInPair = (i+1<inPixelCount) ? 2 : 1;
+		for (int j=0; j<pixelsInPair; ++j)	{
+			int				yc = kUYVY_Y * (int(inSrc[1 + j*2]) - 16) + 32;
+			outDst[0] = ClampToU8((yc + rOffset) >> 6);
+			outDst[1] = ClampToU8((yc + gOffset) >> 6);
+			outDst[2] = ClampToU8((yc + bOffset) >> 6);
+			outDst[3] = 255;
+			outDst += 4;
+		}
+		inSrc += 4;
+	}
+}
+
+
+}	//	namespace
+
+
+
+
+#pragma mark --------------------- x86 kernels
+
+
+#if defined(VVGL_PIXCONV_X86)
+namespace	{
+
+
+VVGL_PIXCONV_TARGET("sse2")
+void Swizzle8_SSE2(const uint8_t * inSrc, uint8_t * outDst, size_t inPixelCount)	{
+	const __m128i		agMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+	const __m128i		rbMask = _mm_set1_epi32(0x00FF00FF);
+	size_t				i = 0;
+	for (; i+4<=inPixelCount; i+=4)	{
+		__m128i				px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inSrc + i*4));
+		__m128i				ag = _mm_and_si128(px, agMask);
+		__m128i				rb = _mm_and_si128(px, rbMask);
+		rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outDst + i*4), _mm_or_si128(ag, rb));
+	}
+	Swizzle8_Scalar(inSrc + i*4, outDst + i*4, inPixelCount - i);
+}
+VVGL_PIXCONV_TARGET("ssse3")
+void Swizzle8_SSSE3(const uint8_t * inSrc, uint8_t * outDst, size_t inPixelCount)	{
+	const __m128i		shuffle = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+	size_t				i = 0;
+	for (; i+4<=inPixelCount; i+=4)	{
+		__m128i				px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inSrc + i*4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outDst + i*4), _mm_shuffle_epi8(px, shuffle));
+	}
+	Swizzle8_Scalar(inSrc + i*4, outDst + i*4, inPixelCount - i);
+}
+VVGL_PIXCONV_TARGET("avx2")
+void Swizzle8_AVX2(const uint8_t * inSrc, uint8_t * outDst, size_t inPixelCount)	{
+	const __m256i		shuffle = _mm256_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15, 2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+	size_t				i = 0;
+	for (; i+8<=inPixelCount; i+=8)	{
+		__m256i				px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inSrc + i*4));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(outDst + i*4), _mm256_shuffle_epi8(px, shuffle));
+	}
+	Swizzle8_Scalar(inSrc + i*4, outDst + i*4, inPixelCount - i);
+}
+VVGL_PIXCONV_TARGET("sse2")
+void Swizzle32F_SSE2(const float * inSrc, float * outDst, size_t inPixelCount)	{
+	for (size_t i=0; i<inPixelCount; ++i)	{
+		__m128				px = _mm_loadu_ps(inSrc + i*4);
+		_mm_storeu_ps(outDst + i*4, _mm_shuffle_ps(px, px, _MM_SHUFFLE(3,0,1,2)));
+	}
+}
+VVGL_PIXCONV_TARGET("sse2")
+void U8ToFloat_SSE2(const uint8_t * inSrc, float * outDst, size_t inCount)	{
+	const __m128i		zero = _mm_setzero_si128();
+	const __m128		scale = _mm_set1_ps(kOneOver255);
+	size_t				i = 0;
+	for (; i+16<=inCount; i+=16)	{
+		__m128i				px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inSrc + i));
+		__m128i				lo = _mm_unpacklo_epi8(px, zero);
+		__m128i				hi = _mm_unpackhi_epi8(px, zero);
+		_mm_storeu_ps(outDst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+		_mm_storeu_ps(outDst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+		_mm_storeu_ps(outDst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+		_mm_storeu_ps(outDst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+	}
+	U8ToFloat_Scalar(inSrc + i, outDst + i, inCount - i);
+}
+VVGL_PIXCONV_TARGET("avx2")
+void U8ToFloat_AVX2(const uint8_t * inSrc, float * outDst, size_t inCount)	{
+	const __m256		scale = _mm256_set1_ps(kOneOver255);
+	size_t				i = 0;
+	for (; i+32<=inCount; i+=32)	{
+		for (size_t j=0; j<32; j+=8)	{
+			__m256i				px = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(inSrc + i + j)));
+			_mm256_storeu_ps(outDst + i + j, _mm256_mul_ps(_mm256_cvtepi32_ps(px), scale));
+		}
+	}
+	U8ToFloat_Scalar(inSrc + i, outDst + i, inCount - i);
+}
+VVGL_PIXCONV_TARGET("sse2")
+inline __m128i FloatToI32_SSE2(const float * inSrc)	{
+	//	max(x, 0) returns 0 for NaNs
+	__m128				val = _mm_max_ps(_mm_loadu_ps(inSrc), _mm_setzero_ps());
+	val = _mm_min_ps(val, _mm_set1_ps(1.f));
+	val = _mm_add_ps(_mm_mul_ps(val, _mm_set1_ps(255.f)), _mm_set1_ps(0.5f));
+	return _mm_cvttps_epi32(val);
+}
+VVGL_PIXCONV_TARGET("sse2")
+void FloatToU8_SSE2(const float * inSrc, uint8_t * outDst, size_t inCount)	{
+	size_t				i = 0;
+	for (; i+16<=inCount; i+=16)	{
+		__m128i				a = _mm_packs_epi32(FloatToI32_SSE2(inSrc + i), FloatToI32_SSE2(inSrc + i + 4));
+		__m128i				b = _mm_packs_epi32(FloatToI32_SSE2(inSrc + i + 8), FloatToI32_SSE2(inSrc + i + 12));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outDst + i), _mm_packus_epi16(a, b));
+	}
+	FloatToU8_Scalar(inSrc + i, outDst + i, inCount - i);
+}
+VVGL_PIXCONV_TARGET("avx2")
+inline __m256i FloatToI32_AVX2(const float * inSrc)	{
+	__m256				val = _mm256_max_ps(_mm256_loadu_ps(inSrc), _mm256_setzero_ps());
+	val = _mm256_min_ps(val, _mm256_set1_ps(1.f));
+	val = _mm256_add_ps(_mm256_mul_ps(val, _mm256_set1_ps(255.f)), _mm256_set1_ps(0.5f));
+	return _mm256_cvttps_epi32(val);
+}
+VVGL_PIXCONV_TARGET("avx2")
+void FloatToU8_AVX2(const float * inSrc, uint8_t * outDst, size_t inCount)	{
+	//	the packs work within 128-bit lanes, so the result has to be permuted back into order
+	const __m256i		order = _mm256_setr_epi32(0,4,1,5,2,6,3,7);
+	size_t				i = 0;
+	for (; i+32<=inCount; i+=32)	{
+		__m256i				a = _mm256_packs_epi32(FloatToI32_AVX2(inSrc + i), FloatToI32_AVX2(inSrc + i + 8));
+		__m256i				b = _mm256_packs_epi32(FloatToI32_AVX2(inSrc + i + 16), FloatToI32_AVX2(inSrc + i + 24));
+		__m256i				packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(a, b), order);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(outDst + i), packed);
+	}
+	FloatToU8_Scalar(inSrc + i, outDst + i, inCount - i);
+}
+VVGL_PIXCONV_TARGET("avx,f16c")
+void FloatToHalf_F16C(const float * inSrc, uint16_t * outDst, size_t inCount)	{
+	size_t				i = 0;
+	for (; i+8<=inCount; i+=8)	{
+		__m256				val = _mm256_loadu_ps(inSrc + i);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outDst + i), _mm256_cvtps_ph(val, 0));
+	}
+	FloatToHalf_Scalar(inSrc + i, outDst + i, inCount - i);
+}
+VVGL_PIXCONV_TARGET("sse2")
+void UYVYToRGBA8_SSE2(const uint8_t * inSrc, uint8_t * outDst, size_t inPixelCount)	{
+	const __m128i		lowByteMask = _mm_set1_epi16(0x00FF);
+	const __m128i		lowWordMask = _mm_set1_epi32(0x0000FFFF);
+	const __m128i		yOffset = _mm_set1_epi16(16);
+	const __m128i		cOffset = _mm_set1_epi16(128);
+	const __m128i		rounding = _mm_set1_epi16(32);
+	const __m128i		yCoeff = _mm_set1_epi16(kUYVY_Y);
+	const __m128i		rvCoeff = _mm_set1_epi16(kUYVY_RV);
+	const __m128i		guCoeff = _mm_set1_epi16(kUYVY_GU);
+	const __m128i		gvCoeff = _mm_set1_epi16(kUYVY_GV);
+	const __m128i		buCoeff = _mm_set1_epi16(kUYVY_BU);
+	const __m128i		alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+	size_t				i = 0;
+	//	8 pixels (16 bytes of UYVY) per pass
+	for (; i+8<=inPixelCount; i+=8)	{
+		__m128i				px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inSrc + i*2));
+		__m128i				y = _mm_srli_epi16(px, 8);
+		__m128i				uv = _mm_and_si128(px, lowByteMask);
+		//	every U/V is shared by two adjacent pixels- duplicate them into both pixels' 16-bit slots
+		__m128i				u = _mm_and_si128(uv, lowWordMask);
+		u = _mm_or_si128(u, _mm_slli_epi32(u, 16));
+		__m128i				v = _mm_srli_epi32(uv, 16);
+		v = _mm_or_si128(v, _mm_slli_epi32(v, 16));
+
+		__m128i				yc = _mm_adds_epi16(_mm_mullo_epi16(_mm_sub_epi16(y, yOffset), yCoeff), rounding);
+		__m128i				d = _mm_sub_epi16(u, cOffset);
+		__m128i				e = _mm_sub_epi16(v, cOffset);
+		__m128i				r = _mm_srai_epi16(_mm_adds_epi16(yc, _mm_mullo_epi16(e, rvCoeff)), 6);
+		__m128i				g = _mm_srai_epi16(_mm_subs_epi16(_mm_subs_epi16(yc, _mm_mullo_epi16(d, guCoeff)), _mm_mullo_epi16(e, gvCoeff)), 6);
+		__m128i				b = _mm_srai_epi16(_mm_adds_epi16(yc, _mm_mullo_epi16(d, buCoeff)), 6);
+
+		__m128i				rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g));
+		__m128i				ba = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), alpha);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outDst + i*4), _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(outDst + i*4 + 16), _mm_unpackhi_epi16(rg, ba));
+	}
+	UYVYToRGBA8_Scalar(inSrc + i*2, outDst + i*4, inPixelCount - i);
+}
+
+
+struct CPUFeatures	{
+	bool		sse2 = false;
+	bool		ssse3 = false;
+	bool		avx2 = false;
+	bool		f16c = false;
+};
+CPUFeatures DetectCPUFeatures()	{
+	CPUFeatures		returnMe;
+#if defined(_MSC_VER)
+	int				info[4] = { 0, 0, 0, 0 };
+	__cpuid(info, 0);
+	int				maxLeaf = info[0];
+	__cpuid(info, 1);
+	bool			osxsave = (info[2] & (1 << 27)) != 0;
+	bool			avx = (info[2] & (1 << 28)) != 0;
+	bool			osSavesYMM = osxsave && ((_xgetbv(0) & 0x6) == 0x6);
+	returnMe.sse2 = (info[3] & (1 << 26)) != 0;
+	returnMe.ssse3 = (info[2] & (1 << 9)) != 0;
+	returnMe.f16c = avx && osSavesYMM && ((info[2] & (1 << 29)) != 0);
+	if (maxLeaf >= 7)	{
+		__cpuidex(info, 7, 0);
+		returnMe.avx2 = osSavesYMM && ((info[1] & (1 << 5)) != 0);
+	}
+#else
+	__builtin_cpu_init();
+	returnMe.sse2 = __builtin_cpu_supports("sse2");
+	returnMe.ssse3 = __builtin_cpu_supports("ssse3");
+	returnMe.avx2 = __builtin_cpu_supports("avx2");
+	//	the avx check includes the OS's support for saving the ymm registers, f16c has to be checked manually
+	unsigned int	eax = 0, ebx = 0, ecx = 0, edx = 0;
+	if (__builtin_cpu_supports("avx") && __get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		returnMe.f16c = (ecx & (1 << 29)) != 0;
+#endif
+	return returnMe;
+}
+
+
+}	//	namespace
+#endif	//	VVGL_PIXCONV_X86
+
+
+
+
+#pragma mark --------------------- NEON kernels
+
+
+#if defined(VVGL_PIXCONV_NEON)
+namespace	{
+
+
+void Swizzle8_NEON(const uint8_t * inSrc, uint8_t * outDst, size_t inPixelCount)	{
+	size_t				i = 0;
+	for (; i+16<=inPixelCount; i+=16)	{
+		uint8x16x4_t		px = vld4q_u8(inSrc + i*4);
+		uint8x16_t			tmp = px.val[0];
+		px.val[0] = px.val[2];
+		px.val[2] = tmp;
+		vst4q_u8(outDst + i*4, px);
+	}
+	Swizzle8_Scalar(inSrc + i*4, outDst + i*4, inPixelCount - i);
+}
+void Swizzle32F_NEON(const float * inSrc, float * outDst, size_t inPixelCount)	{
+	size_t				i = 0;
+	for (; i+4<=inPixelCount; i+=4)	{
+		float32x4x4_t		px = vld4q_f32(inSrc + i*4);
+		float32x4_t			tmp = px.val[0];
+		px.val[0] = px.val[2];
+		px.val[2] = tmp;
+		vst4q_f32(outDst + i*4, px);
+	}
+	Swizzle32F_Scalar(inSrc + i*4, outDst + i*4, inPixelCount - i);
+}
+void U8ToFloat_NEON(const uint8_t * inSrc, float * outDst, size_t inCount)	{
+	size_t				i = 0;
+	for (; i+16<=inCount; i+=16)	{
+		uint8x16_t			px = vld1q_u8(inSrc + i);
+		uint16x8_t			lo = vmovl_u8(vget_low_u8(px));
+		uint16x8_t			hi = vmovl_u8(vget_high_u8(px));
+		vst1q_f32(outDst + i, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), kOneOver255));
+		vst1q_f32(outDst + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), kOneOver255));
+		vst1q_f32(outDst + i + 8, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), kOneOver255));
+		vst1q_f32(outDst + i + 12, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), kOneOver255));
+	}
+	U8ToFloat_Scalar(inSrc + i, outDst + i, inCount - i);
+}
+inline uint16x4_t FloatToU16_NEON(const float * inSrc)	{
+	float32x4_t			val = vld1q_f32(inSrc);
+	//	NEON's max() propagates NaNs- select against the comparison instead so NaNs become 0
+	val = vbslq_f32(vcgtq_f32(val, vdupq_n_f32(0.f)), val, vdupq_n_f32(0.f));
+	val = vminq_f32(val, vdupq_n_f32(1.f));
+	val = vaddq_f32(vmulq_n_f32(val, 255.f), vdupq_n_f32(0.5f));
+	return vmovn_u32(vcvtq_u32_f32(val));
+}
+void FloatToU8_NEON(const float * inSrc, uint8_t * outDst, size_t inCount)	{
+	size_t				i = 0;
+	for (; i+8<=inCount; i+=8)	{
+		uint16x8_t			val = vcombine_u16(FloatToU16_NEON(inSrc + i), FloatToU16_NEON(inSrc + i + 4));
+		vst1_u8(outDst + i, vmovn_u16(val));
+	}
+	FloatToU8_Scalar(inSrc + i, outDst + i, inCount - i);
+}
+#if defined(__aarch64__)
+void FloatToHalf_NEON(const float * inSrc, uint16_t * outDst, size_t inCount)	{
+	size_t				i = 0;
+	for (; i+4<=inCount; i+=4)
+		vst1_u16(outDst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(inSrc + i))));
+	FloatToHalf_Scalar(inSrc + i, outDst + i, inCount - i);
+}
+#endif
+void UYVYToRGBA8_NEON(const uint8_t * inSrc, uint8_t * outDst, size_t inPixelCount)	{
+	const int16x8_t		rounding = vdupq_n_s16(32);
+	size_t				i = 0;
+	//	16 pixels (32 bytes of UYVY) per pass
+	for (; i+16<=inPixelCount; i+=16)	{
+		uint8x8x4_t			px = vld4_u8(inSrc + i*2);	//	val[0] is U, val[1] is Y0, val[2] is V, val[3] is Y1
+		int16x8_t			d = vreinterpretq_s16_u16(vsubl_u8(px.val[0], vdup_n_u8(128)));
+		int16x8_t			e = vreinterpretq_s16_u16(vsubl_u8(px.val[2], vdup_n_u8(128)));
+		int16x8_t			rOffset = vmulq_n_s16(e, kUYVY_RV);
+		int16x8_t			guOffset = vmulq_n_s16(d, kUYVY_GU);
+		int16x8_t			gvOffset = vmulq_n_s16(e, kUYVY_GV);
+		int16x8_t			bOffset = vmulq_n_s16(d, kUYVY_BU);
+		uint8x8_t			r[2];
+		uint8x8_t			g[2];
+		uint8x8_t			b[2];
+		for (int j=0; j<2; ++j)	{
+			int16x8_t			y = vreinterpretq_s16_u16(vsubl_u8(px.val[1 + j*2], vdup_n_u8(16)));
+			int16x8_t			yc = vqaddq_s16(vmulq_n_s16(y, kUYVY_Y), rounding);
+			r[j] = vqmovun_s16(vshrq_n_s16(vqaddq_s16(yc, rOffset), 6));
+			g[j] = vqmovun_s16(vshrq_n_s16(vqsubq_s16(vqsubq_s16(yc, guOffset), gvOffset), 6));
+			b[j] = vqmovun_s16(vshrq_n_s16(vqaddq_s16(yc, bOffset), 6));
+		}
+		//	interleave the even (Y0) and odd (Y1) pixels
+		uint8x8x2_t			rr = vzip_u8(r[0], r[1]);
+		uint8x8x2_t			gg = vzip_u8(g[0], g[1]);
+		uint8x8x2_t			bb = vzip_u8(b[0], b[1]);
+		for (int j=0; j<2; ++j)	{
+			uint8x8x4_t			rgba;
+			rgba.val[0] = rr.val[j];
+			rgba.val[1] = gg.val[j];
+			rgba.val[2] = bb.val[j];
+			rgba.val[3] = vdup_n_u8(255);
+			vst4_u8(outDst + i*4 + j*32, rgba);
+		}
+	}
+	UYVYToRGBA8_Scalar(inSrc + i*2, outDst + i*4, inPixelCount - i);
+}
+
+
+}	//	namespace
+#endif	//	VVGL_PIXCONV_NEON
+
+
+
+
+#pragma mark --------------------- dispatch
+
+
+namespace	{
+
+
+struct ConversionKernels	{
+	void (*swizzle8)(const uint8_t *, uint8_t *, size_t) = Swizzle8_Scalar;
+	void (*swizzle32F)(const float *, float *, size_t) = Swizzle32F_Scalar;
+	void (*u8ToFloat)(const uint8_t *, float *, size_t) = U8ToFloat_Scalar;
+	void (*floatToU8)(const float *, uint8_t *, size_t) = FloatToU8_Scalar;
+	void (*floatToHalf)(const float *, uint16_t *, size_t) = FloatToHalf_Scalar;
+	void (*uyvyToRGBA8)(const uint8_t *, uint8_t *, size_t) = UYVYToRGBA8_Scalar;
+	const char		*isa = "scalar";
+};
+
+
+ConversionKernels MakeSIMDKernels()	{
+	ConversionKernels		returnMe;
+#if defined(VVGL_PIXCONV_X86)
+	CPUFeatures			features = DetectCPUFeatures();
+	if (features.sse2)	{
+		returnMe.swizzle8 = Swizzle8_SSE2;
+		returnMe.swizzle32F = Swizzle32F_SSE2;
+		returnMe.u8ToFloat = U8ToFloat_SSE2;
+		returnMe.floatToU8 = FloatToU8_SSE2;
+		returnMe.uyvyToRGBA8 = UYVYToRGBA8_SSE2;
+		returnMe.isa = "SSE2";
+	}
+	if (features.ssse3)	{
+		returnMe.swizzle8 = Swizzle8_SSSE3;
+		returnMe.isa = "SSSE3";
+	}
+	if (features.avx2)	{
+		returnMe.swizzle8 = Swizzle8_AVX2;
+		returnMe.u8ToFloat = U8ToFloat_AVX2;
+		returnMe.floatToU8 = FloatToU8_AVX2;
+		returnMe.isa = "AVX2";
+	}
+	if (features.f16c)
+		returnMe.floatToHalf = FloatToHalf_F16C;
+#elif defined(VVGL_PIXCONV_NEON)
+	returnMe.swizzle8 = Swizzle8_NEON;
+	returnMe.swizzle32F = Swizzle32F_NEON;
+	returnMe.u8ToFloat = U8ToFloat_NEON;
+	returnMe.floatToU8 = FloatToU8_NEON;
+#if defined(__aarch64__)
+	returnMe.floatToHalf = FloatToHalf_NEON;
+#endif
+	returnMe.uyvyToRGBA8 = UYVYToRGBA8_NEON;
+	returnMe.isa = "NEON";
+#endif
+	return returnMe;
+}
+
+
+atomic<bool>		_simdEnabled { true };
+
+const ConversionKernels & Kernels()	{
+	static const ConversionKernels		simdKernels = MakeSIMDKernels();
+	static const ConversionKernels		scalarKernels;
+	return (_simdEnabled) ? simdKernels : scalarKernels;
+}
+
+
+
+
+#pragma mark --------------------- worker threads
+
+
+//	a small pool of threads that convert bands of rows for ConvertPixels().  deliberately leaked (its threads wait for work for the life of the process).
+class ConversionThreadPool	{
+	private:
+		mutex						_lock;
+		condition_variable			_workCondition;
+		deque<function<void()>>		_work;
+		size_t						_threadCount = 0;
+	public:
+		static ConversionThreadPool & Get()	{
+			static ConversionThreadPool		*pool = new ConversionThreadPool();
+			return *pool;
+		}
+		//	executes inJobs[0] on the calling thread and the rest on the pool's threads, returns when they've all finished
+		void run(vector<function<void()>> & inJobs)	{
+			if (inJobs.size() == 0)
+				return;
+			mutex					doneLock;
+			condition_variable		doneCondition;
+			size_t					remaining = inJobs.size() - 1;
+			{
+				lock_guard<mutex>		lock(_lock);
+				//	make sure there's a thread for every job we're handing off
+				while (_threadCount < inJobs.size() - 1)	{
+					thread([this](){ workLoop(); }).detach();
+					++_threadCount;
+				}
+				for (size_t i=1; i<inJobs.size(); ++i)	{
+					function<void()>		&job = inJobs[i];
+					_work.emplace_back([&job,&doneLock,&doneCondition,&remaining]()	{
+						job();
+						lock_guard<mutex>		doneGuard(doneLock);
+						if (--remaining == 0)
+							doneCondition.notify_one();
+					});
+				}
+			}
+			_workCondition.notify_all();
+			inJobs[0]();
+			unique_lock<mutex>		doneGuard(doneLock);
+			doneCondition.wait(doneGuard, [&remaining](){ return remaining == 0; });
+		}
+	private:
+		void workLoop()	{
+			while (true)	{
+				function<void()>		job = nullptr;
+				{
+					unique_lock<mutex>		lock(_lock);
+					_workCondition.wait(lock, [this](){ return _work.size() > 0; });
+					job = move(_work.front());
+					_work.pop_front();
+				}
+				job();
+			}
+		}
+};
+
+
+//	images smaller than this are converted on the calling thread
+const size_t			kParallelConversionBytes = 1024 * 1024;
+//	no band of rows handed to a worker thread is shorter than this
+const uint32_t			kMinRowsPerBand = 32;
+atomic<unsigned int>	_conversionThreadCount { min(max(thread::hardware_concurrency(), 1u), 8u) };
+
+
+}	//	namespace
+
+
+
+
+#pragma mark --------------------- public API
+
+
+PixelLayout PixelLayoutForDescriptor(const GLBuffer::Descriptor & inDesc)	{
+	switch (inDesc.pixelFormat)	{
+	case GLBuffer::PF_RGBA:
+	case GLBuffer::PF_BGRA:
+		{
+			bool			isRGBA = (inDesc.pixelFormat == GLBuffer::PF_RGBA);
+			switch (inDesc.pixelType)	{
+			case GLBuffer::PT_UByte:
+#if !defined(VVGL_SDK_IOS) && !defined(VVGL_SDK_RPI)
+			case GLBuffer::PT_UInt_8888_Rev:
+#endif
+				return (isRGBA) ? PixelLayout_RGBA8 : PixelLayout_BGRA8;
+			case GLBuffer::PT_Float:
+				return (isRGBA) ? PixelLayout_RGBA32F : PixelLayout_BGRA32F;
+#if !defined(VVGL_SDK_RPI)
+			case GLBuffer::PT_HalfFloat:
+				return (isRGBA) ? PixelLayout_RGBA16F : PixelLayout_Unknown;
+#endif
+			default:
+				break;
+			}
+		}
+		break;
+#if !defined(VVGL_SDK_IOS)
+	case GLBuffer::PF_YCbCr_422:
+		return PixelLayout_UYVY;
+#endif
+	default:
+		break;
+	}
+	return PixelLayout_Unknown;
+}
+size_t BytesPerPixelForLayout(const PixelLayout & inLayout)	{
+	switch (inLayout)	{
+	case PixelLayout_Unknown:	return 0;
+	case PixelLayout_RGBA8:
+	case PixelLayout_BGRA8:		return 4;
+	case PixelLayout_RGBA32F:
+	case PixelLayout_BGRA32F:	return 16;
+	case PixelLayout_RGBA16F:	return 8;
+	case PixelLayout_UYVY:		return 2;
+	}
+	return 0;
+}
+
+
+namespace	{
+
+//	converts one row of 'inWidth' pixels
+using RowConverter = function<void(const uint8_t * inSrc, uint8_t * outDst, size_t inWidth)>;
+
+inline bool Is8BitLayout(const PixelLayout & n) { return (n==PixelLayout_RGBA8 || n==PixelLayout_BGRA8); }
+inline bool Is32FLayout(const PixelLayout & n) { return (n==PixelLayout_RGBA32F || n==PixelLayout_BGRA32F); }
+inline bool IsRGBAOrder(const PixelLayout & n) { return (n==PixelLayout_RGBA8 || n==PixelLayout_RGBA32F || n==PixelLayout_RGBA16F); }
+
+RowConverter RowConverterForLayouts(const PixelLayout & inSrc, const PixelLayout & inDst)	{
+	if (inSrc==PixelLayout_Unknown || inDst==PixelLayout_Unknown)
+		return nullptr;
+	const ConversionKernels		&k = Kernels();
+
+	if (inSrc == inDst)	{
+		size_t			bpp = BytesPerPixelForLayout(inSrc);
+		return [bpp](const uint8_t * s, uint8_t * d, size_t w)	{ memcpy(d, s, w * bpp); };
+	}
+
+	bool			swapOrder = (IsRGBAOrder(inSrc) != IsRGBAOrder(inDst));
+	if (Is8BitLayout(inSrc) && Is8BitLayout(inDst))
+		return [k](const uint8_t * s, uint8_t * d, size_t w)	{ k.swizzle8(s, d, w); };
+	if (Is32FLayout(inSrc) && Is32FLayout(inDst))	{
+		return [k](const uint8_t * s, uint8_t * d, size_t w)	{
+			k.swizzle32F(reinterpret_cast<const float*>(s), reinterpret_cast<float*>(d), w);
+		};
+	}
+	if (Is8BitLayout(inSrc) && Is32FLayout(inDst))	{
+		return [k,swapOrder](const uint8_t * s, uint8_t * d, size_t w)	{
+			float			*df = reinterpret_cast<float*>(d);
+			k.u8ToFloat(s, df, w * 4);
+			if (swapOrder)
+				k.swizzle32F(df, df, w);
+		};
+	}
+	if (Is32FLayout(inSrc) && Is8BitLayout(inDst))	{
+		return [k,swapOrder](const uint8_t * s, uint8_t * d, size_t w)	{
+			k.floatToU8(reinterpret_cast<const float*>(s), d, w * 4);
+			if (swapOrder)
+				k.swizzle8(d, d, w);
+		};
+	}
+	if (inSrc==PixelLayout_RGBA32F && inDst==PixelLayout_RGBA16F)	{
+		return [k](const uint8_t * s, uint8_t * d, size_t w)	{
+			k.floatToHalf(reinterpret_cast<const float*>(s), reinterpret_cast<uint16_t*>(d), w * 4);
+		};
+	}
+	if (inSrc==PixelLayout_UYVY && Is8BitLayout(inDst))	{
+		//	the UYVY kernels write RGBA, so only BGRA destinations are swizzled
+		bool			toBGRA = !IsRGBAOrder(inDst);
+		return [k,toBGRA](const uint8_t * s, uint8_t * d, size_t w)	{
+			k.uyvyToRGBA8(s, d, w);
+			if (toBGRA)
+				k.swizzle8(d, d, w);
+		};
+	}
+	return nullptr;
+}
+
+}	//	namespace
+
+
+bool CanConvertPixels(const PixelLayout & inSrcLayout, const PixelLayout & inDstLayout)	{
+	return (RowConverterForLayouts(inSrcLayout, inDstLayout) != nullptr);
+}
+bool ConvertPixels(const void * inSrc, const size_t & inSrcBytesPerRow, const PixelLayout & inSrcLayout, void * outDst, const size_t & inDstBytesPerRow, const PixelLayout & inDstLayout, const uint32_t & inWidth, const uint32_t & inHeight)	{
+	if (inSrc==nullptr || outDst==nullptr)
+		return false;
+	RowConverter		rowConverter = RowConverterForLayouts(inSrcLayout, inDstLayout);
+	if (rowConverter == nullptr)
+		return false;
+	if (inWidth==0 || inHeight==0)
+		return true;
+
+	const uint8_t		*srcBase = static_cast<const uint8_t*>(inSrc);
+	uint8_t				*dstBase = static_cast<uint8_t*>(outDst);
+	auto				convertRows = [&](uint32_t inFirstRow, uint32_t inEndRow)	{
+		for (uint32_t row=inFirstRow; row<inEndRow; ++row)
+			rowConverter(srcBase + row*inSrcBytesPerRow, dstBase + row*inDstBytesPerRow, inWidth);
+	};
+
+	//	small images (or a thread count of 1) are converted on this thread
+	size_t				totalBytes = size_t(inWidth) * size_t(inHeight) * max(BytesPerPixelForLayout(inSrcLayout), BytesPerPixelForLayout(inDstLayout));
+	uint32_t			bandCount = min(static_cast<uint32_t>(_conversionThreadCount), inHeight / kMinRowsPerBand);
+	if (totalBytes < kParallelConversionBytes || bandCount < 2)	{
+		convertRows(0, inHeight);
+		return true;
+	}
+
+	//	split the image into bands of rows and convert them in parallel
+	vector<function<void()>>		jobs;
+	jobs.reserve(bandCount);
+	uint32_t			rowsPerBand = (inHeight + bandCount - 1) / bandCount;
+	for (uint32_t firstRow=0; firstRow<inHeight; firstRow+=rowsPerBand)	{
+		uint32_t			endRow = min(firstRow + rowsPerBand, inHeight);
+		jobs.emplace_back([&convertRows,firstRow,endRow]()	{ convertRows(firstRow, endRow); });
+	}
+	ConversionThreadPool::Get().run(jobs);
+	return true;
+}
+
+
+void SwizzleRGBA8(const uint8_t * inSrc, uint8_t * outDst, const size_t & inPixelCount)	{
+	Kernels().swizzle8(inSrc, outDst, inPixelCount);
+}
+void SwizzleRGBA32F(const float * inSrc, float * outDst, const size_t & inPixelCount)	{
+	Kernels().swizzle32F(inSrc, outDst, inPixelCount);
+}
+void Convert8ToFloat(const uint8_t * inSrc, float * outDst, const size_t & inCount)	{
+	Kernels().u8ToFloat(inSrc, outDst, inCount);
+}
+void ConvertFloatTo8(const float * inSrc, uint8_t * outDst, const size_t & inCount)	{
+	Kernels().floatToU8(inSrc, outDst, inCount);
+}
+void ConvertFloatToHalf(const float * inSrc, uint16_t * outDst, const size_t & inCount)	{
+	Kernels().floatToHalf(inSrc, outDst, inCount);
+}
+void ConvertUYVYToRGBA8(const uint8_t * inSrc, uint8_t * outDst, const size_t & inPixelCount)	{
+	Kernels().uyvyToRGBA8(inSrc, outDst, inPixelCount);
+}
+
+
+const char * PixelConversionISA()	{
+	return Kernels().isa;
+}
+void SetPixelConversionSIMDEnabled(const bool & n)	{
+	_simdEnabled = n;
+}
+void SetPixelConversionThreadCount(const unsigned int & n)	{
+	_conversionThreadCount = max(n, 1u);
+}
+
+
+
+
+}
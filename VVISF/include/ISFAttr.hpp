@@ -38,6 +38,9 @@ class VVISF_EXPORT ISFAttr	{
 		bool				_isTransEndImage = false;	//	if true, this is an image-type input and is named "endImage"
 		bool				_isTransProgressFloat = false;	//	if true, this is a float-type input and is named "progress"
 		int32_t				_uniformLocation[4] = { -1, -1, -1, -1 };	//	the location of this attribute in the compiled GLSL program. cached here because lookup times are costly when performed every frame.  there are 4 because images require four uniforms (one of the texture name, one for the size, one for the img rect, and one for the flippedness)
+		std::string			_uniformNames[4];	//	the names of the uniforms at '_uniformLocation' (empty if the attribute doesn't have that uniform)- made when the attribute is created, so looking up the locations doesn't format any strings
+		uint64_t			_valGeneration = 1;	//	incremented every time the current value is set
+		uint64_t			_pushedValGeneration = 0;	//	the generation of the value that was last pushed to the uniform at '_uniformLocation[0]', or 0 if no value was pushed since the location was set
 		
 		double				_evalVariable = 1.0;	//	attribute values are available in expression evaluation- to support this, each attribute needs to maintain a double which it populates with its current value
 	public:
@@ -75,10 +78,12 @@ class VVISF_EXPORT ISFAttr	{
 		inline std::string & label() const { return const_cast<std::string&>(_label); }
 		//!	Returns the attribute's value type.
 		inline ISFValType & type() const { return const_cast<ISFValType&>(_type); }
-		//!	Returns the attribute's current value.
+		//!	Returns the attribute's current value.  If you change the value through the returned reference, its generation isn't incremented (and ISFScene may not push it to the GL program)- use setCurrentVal() instead.
 		inline ISFVal & currentVal() { return _currentVal; }
 		//!	Sets the attribute's current value.
-		inline void setCurrentVal(const ISFVal & n) { _currentVal=n; }
+		inline void setCurrentVal(const ISFVal & n) { _currentVal=n; ++_valGeneration; }
+		//!	Returns the generation of the attribute's current value, which is incremented every time the value is set- if it hasn't changed, neither has the value.
+		inline uint64_t valGeneration() const { return _valGeneration; }
 		//	updates this attribute's eval variable with the double val of "_currentVal", and returns a ptr to the eval variable
 		double * updateAndGetEvalVariable();
 		//!	Returns a true if this attribute's value is expressed with an image buffer
@@ -86,7 +91,7 @@ class VVISF_EXPORT ISFAttr	{
 		//!	Returns the receiver's image buffer
 		inline VVGL::GLBufferRef getCurrentImageBuffer() { if (!shouldHaveImageBuffer()) return nullptr; return _currentVal.imageBuffer(); }
 		//!	Sets the receiver's current value with the passed image buffer
-		inline void setCurrentImageBuffer(const VVGL::GLBufferRef & n) { /*cout<<__PRETTY_FUNCTION__<<"..."<<*this<<", "<<*n<<endl;*/if (shouldHaveImageBuffer()) _currentVal = ISFImageVal(n); else std::cout << "\terr: tried to set current image buffer in non-image attr (" << _name << ")\n"; /*cout<<"\tcurrentVal is now "<<_currentVal<<endl;*/ }
+		inline void setCurrentImageBuffer(const VVGL::GLBufferRef & n) { /*cout<<__PRETTY_FUNCTION__<<"..."<<*this<<", "<<*n<<endl;*/if (shouldHaveImageBuffer()) { _currentVal = ISFImageVal(n); ++_valGeneration; } else std::cout << "\terr: tried to set current image buffer in non-image attr (" << _name << ")\n"; /*cout<<"\tcurrentVal is now "<<_currentVal<<endl;*/ }
 		//!	Gets the attribute's min val
 		inline ISFVal & minVal() { return _minVal; }
 		//!	Gets the attribute's max val
@@ -112,9 +117,14 @@ class VVISF_EXPORT ISFAttr	{
 		inline bool isTransProgressFloat() { return _isTransProgressFloat; }
 		inline void setIsTransProgressFloat(const bool & n) { _isTransProgressFloat=n; }
 		
-		inline void clearUniformLocations() { for (int i=0; i<4; ++i) _uniformLocation[i]=0; }
-		inline void setUniformLocation(const int & inIndex, const int32_t & inNewVal) { if (inIndex<0 || inIndex>3) return; _uniformLocation[inIndex] = inNewVal; }
+		inline void clearUniformLocations() { for (int i=0; i<4; ++i) _uniformLocation[i]=0; _pushedValGeneration=0; }
+		inline void setUniformLocation(const int & inIndex, const int32_t & inNewVal) { if (inIndex<0 || inIndex>3) return; _uniformLocation[inIndex] = inNewVal; if (inIndex==0) _pushedValGeneration=0; }
 		inline int32_t getUniformLocation(const int & inIndex) { if (inIndex<0 || inIndex>3) return 0; return _uniformLocation[inIndex]; }
+		//	looks up the locations of all of this attribute's uniforms in the passed description of a program
+		void cacheUniformLocations(const VVGL::GLProgramReflection & inReflection);
+		//	the generation of the value that was last pushed to the uniform at location 0- ISFScene uses this to skip pushing values that haven't changed
+		inline uint64_t pushedValGeneration() const { return _pushedValGeneration; }
+		inline void setPushedValGeneration(const uint64_t & n) { _pushedValGeneration=n; }
 		//inline bool isNullVal() { return (_type==ISFValType_None); }
 		
 		VVISF_EXPORT friend std::ostream & operator<<(std::ostream & os, const ISFAttr & n);
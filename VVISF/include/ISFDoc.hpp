@@ -193,7 +193,7 @@ class VVISF_EXPORT ISFDoc	{
 		\param outFragSrc A non-null pre-allocated std::std::string variable which will be populated with the fragment shader source code generated for this ISF file.
 		\param outVertSrc A non-null pre-allocated std::std::string variable which will be populated with the vertex shader source code generated for this ISF file.
 		\param inGLVers The version of OpenGL that the generated source code must be compatible with.
-		\param inVarsAsUBO Defaults to false.  If true, variable declarations for non-image INPUTS will be assembled in a uniform block.  This option was added because a downstream utility requires it.
+		\param inVarsAsUBO Defaults to false.  If true, variable declarations for non-image INPUTS will be assembled in a uniform block.  This option was added because a downstream utility requires it, and is used by ISFScene when its inputsInUniformBuffer flag is set.
 		*/
 		bool generateShaderSource(std::string * outFragSrc, std::string * outVertSrc, VVGL::GLVersion & inGLVers, const bool & inVarsAsUBO=false);
 		//	this method must be called before rendering (passes/etc may have expressions that require the render dims to be evaluated)
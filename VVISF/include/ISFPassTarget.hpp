@@ -93,6 +93,7 @@ class VVISF_EXPORT ISFPassTarget	{
 		VVGL::Size targetSize() { return { _targetWidth, _targetHeight }; }
 		
 		void cacheUniformLocations(const int & inPgmToCheck) { for (int i=0; i<4; ++i) _cachedUnis[i]->cacheTheLoc(inPgmToCheck); }
+		void cacheUniformLocations(const VVGL::GLProgramReflection & inReflection) { for (int i=0; i<4; ++i) _cachedUnis[i]->cacheTheLoc(inReflection); }
 		int32_t getUniformLocation(const int & inIndex) const { return (inIndex<0||inIndex>3) ? -1 : _cachedUnis[inIndex]->loc; }
 		void clearUniformLocations() { for (int i=0; i<4; ++i) _cachedUnis[i]->purgeCache(); }
 	
@@ -24,6 +24,18 @@ Notes on use:
 - You should avoid calling setVertexShaderString() or setFragmentShaderString() directly on instances of ISFScene- instead, let the class populate its own shaders.
 */
 class VVISF_EXPORT ISFScene : public VVGL::GLScene	{
+	public:
+		//!	Counts of the values ISFScene sent to its GL program's uniforms with glUniform*(), and of the values it skipped because the uniform already had them.  Returned by lastFrameUniformStats().
+		struct UniformStats	{
+			//!	The number of uniforms that were sent (including samplers and the uniforms describing images, which are always sent).
+			uint64_t		sent = 0;
+			//!	The number of uniforms that weren't sent because their values hadn't changed.
+			uint64_t		skipped = 0;
+			
+			std::string getDescriptionString() const;
+			friend std::ostream & operator<<(std::ostream & os, const UniformStats & n) { os << n.getDescriptionString(); return os; }
+		};
+		
 	private:
 		bool			_throwExceptions = false;	//	NO by default
 
@@ -60,6 +72,19 @@ class VVISF_EXPORT ISFScene : public VVGL::GLScene	{
 		//	these vars describe some non-default/non-standard options for more unusual situations
 		bool				_alwaysRenderToFloat = false;	//	false by default- if true, all interim buffers generated by the ISF will be float32 per component.  set this before loading the doc.
 		bool				_persistentToIOSurface = false;	//	false by default- if true, persistent buffers generated by the ISF will be backed by IOSurfaces (so they can be re-used if the underlying GL context changes to one in a different sharegroup).  set this before loading the doc.
+		bool				_immutablePassTargets = true;	//	true by default- if true, the buffers generated for the ISF's passes are created with immutable texture storage (where the GL context supports it).
+		bool				_inputsInUniformBuffer = false;	//	false by default- if true, the shaders are generated with their non-image uniforms in a uniform block, which is backed by a uniform buffer (where the GL context supports it).
+
+		//	access to these vars should be restricted by the '_renderLock' var inherited from GLScene
+		bool						_programUsesUniformBlock = false;	//	true if the compiled program has the uniform block
+		size_t						_uniformBlockSize = 0;	//	the size of the uniform block (as reported by GL) in the compiled program
+		VVGL::GLBufferRef			_uniformBuffer = nullptr;	//	the buffer backing the uniform block
+		size_t						_uniformBufferSize = 0;	//	the size of '_uniformBuffer' in bytes
+		bool						_uniformBufferBound = false;	//	set to false at the start of every frame- the buffer is bound to the block's binding point by the first pass
+		std::vector<uint8_t>		_uniformBlockMirror;	//	a copy of the uniform block's contents (std140 layout), used to find the bytes that changed
+		std::vector<std::pair<size_t,size_t>>	_uniformBlockDirty;	//	the ranges of bytes in '_uniformBlockMirror' that changed since they were last uploaded, as [start, end), in ascending order
+		UniformStats				_uniformStats;	//	counts the uniforms sent/skipped by the frame being rendered
+		UniformStats				_lastFrameUniformStats;	//	the counts for the last frame that was rendered
 
 	public:
 		//!	Creates a new OpenGL context that shares the global buffer pool's context
@@ -101,7 +126,15 @@ class VVISF_EXPORT ISFScene : public VVGL::GLScene	{
 		void setPersistentToIOSurface(const bool & n) { _persistentToIOSurface=n; }
 		//!	Gets the receiver's _persistentToIOSurface flag.
 		bool persistentToIOSurface() { return _persistentToIOSurface; }
-		
+		//!	Sets the receiver's _immutablePassTargets flag- if true, the textures that passes render into are created with immutable storage (glTexStorage2D) where the GL context supports it, which lets the driver skip validation when they're attached to an FBO.  Defaults to true.
+		void setImmutablePassTargets(const bool & n) { _immutablePassTargets=n; }
+		//!	Gets the receiver's _immutablePassTargets flag.
+		bool immutablePassTargets() { return _immutablePassTargets; }
+		//!	Sets the receiver's _inputsInUniformBuffer flag- if true, the shaders are generated with the values of the INPUTS (and the other non-image uniforms) in a uniform block.  The block is backed by a buffer that's updated once per frame with only the bytes that changed, instead of calling glUniform*() for every input in every pass.  Only used where the GL context supports uniform buffers (GL 3.3+/ES 3), and recompiles the shaders when it's changed.  Defaults to false.
+		void setInputsInUniformBuffer(const bool & n);
+		//!	Gets the receiver's _inputsInUniformBuffer flag.
+		bool inputsInUniformBuffer() { return _inputsInUniformBuffer; }
+
 		///@}
 		
 		
@@ -159,6 +192,12 @@ class VVISF_EXPORT ISFScene : public VVGL::GLScene	{
 		*/
 		virtual VVGL::GLBufferRef createAndRenderABuffer(const VVGL::Size & inSize, const double & inRenderTime, std::map<int32_t,VVGL::GLBufferRef> * outPassDict=nullptr, const VVGL::GLBufferPoolRef & inPoolRef=nullptr);
 #pragma clang diagnostic pop
+		/*!
+		\brief Creates the textures the loaded ISF file needs to render at the passed size ahead of time, so the first frame rendered at that size doesn't stall while they're created.  Call this after loading a file or changing the render size, before the first visible frame.
+		\param inRenderSize The size at which the scene will be rendering.
+		\param inPoolRef The buffer pool the textures should be reserved in (defaults to the scene's private pool, or the global buffer pool).
+		*/
+		void prewarmBuffers(const VVGL::Size & inRenderSize, const VVGL::GLBufferPoolRef & inPoolRef=nullptr);
 		///@}
 		
 		
@@ -180,6 +219,8 @@ class VVISF_EXPORT ISFScene : public VVGL::GLScene	{
 		void setBaseTime(const VVGL::Timestamp & inNewBaseTime=VVGL::Timestamp()) { _baseTime = inNewBaseTime; }
 		//!	Returns the base time at which this scene started rendering its ISF.  Render times are calculated using this.
 		VVGL::Timestamp baseTime() { return _baseTime; }
+		//!	Returns the number of uniforms the scene sent to its GL program and the number it skipped (because their values hadn't changed) while rendering the last frame- all of its passes.
+		UniformStats lastFrameUniformStats();
 
 		//virtual void renderToBuffer(const VVGL::GLBufferRef & inTargetBuffer, const VVGL::Size & inRenderSize=VVGL::Size(640.,480.), const double & inRenderTime=timestamper.nowTime().getTimeInSeconds(), std::map<string,VVGL::GLBufferRef> * outPassDict=nullptr);
 		
@@ -218,9 +259,16 @@ class VVISF_EXPORT ISFScene : public VVGL::GLScene	{
 		inline VVGL::GLBufferRef vbo() const { return _vbo; }
 		inline void setVBO(const VVGL::GLBufferRef & n) { _vbo = n; }
 		void _setUpRenderCallback();
+		//	returns true if the shaders should be generated with a uniform block
+		bool _shouldUseUniformBlock();
+		//	copies the passed bytes into the uniform block mirror at the passed offset (after aligning it), marking them dirty if they changed.  'inBytes' may be null to skip the member.  advances the offset past the member.
+		void _writeUniformBlockMember(size_t & ioOffset, const void * inBytes, const size_t & inSize, const size_t & inAlign);
+		//	populates the uniform block mirror with the current values (in the order the doc declares them), uploads the bytes that changed, and binds the buffer
+		void _updateUniformBlock(const ISFDocRef & inDoc);
 		virtual void _renderPrep();
 		virtual void _initialize();
 		virtual void _renderCleanup();
+		virtual void _sharedProgramUsedElsewhere();
 		virtual void _render(const VVGL::GLBufferRef & inTargetBuffer, const VVGL::Size & inSize, const double & inTime, std::map<int32_t,VVGL::GLBufferRef> * outPassDict);
 
 };
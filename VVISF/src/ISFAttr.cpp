@@ -1,4 +1,5 @@
 #include "ISFAttr.hpp"
+#include "VVGL.hpp"
 
 
 
@@ -38,11 +39,36 @@ const vector<int32_t> * inVals) : _name(inName), _description(inDesc), _label(in
 	_identityVal = inIdenVal;
 	_labelArray = (inLabels==nullptr) ? vector<string>() : vector<string>(*inLabels);
 	_valArray = (inVals==nullptr) ? vector<int32_t>() : vector<int32_t>(*inVals);
+	
+	//	the names of the uniforms ISFDoc declares for this attribute
+	_uniformNames[0] = _name;
+	switch (_type)	{
+	case ISFValType_Cube:
+		_uniformNames[2] = string("_") + _name + string("_imgSize");
+		break;
+	case ISFValType_Image:
+	case ISFValType_Audio:
+	case ISFValType_AudioFFT:
+		_uniformNames[1] = string("_") + _name + string("_imgRect");
+		_uniformNames[2] = string("_") + _name + string("_imgSize");
+		_uniformNames[3] = string("_") + _name + string("_flip");
+		break;
+	default:
+		break;
+	}
 }
 ISFAttr::~ISFAttr()	{
 }
 
 
+void ISFAttr::cacheUniformLocations(const GLProgramReflection & inReflection)	{
+	for (int i=0; i<4; ++i)
+		_uniformLocation[i] = (_uniformNames[i].size() < 1) ? -1 : inReflection.uniformLocation(_uniformNames[i]);
+	//	the program is new, so none of our values have been pushed to it
+	_pushedValGeneration = 0;
+}
+
+
 double * ISFAttr::updateAndGetEvalVariable()	{
 	switch (_type)	{
 	case ISFValType_None:
@@ -86,6 +86,7 @@ void ISFPassTarget::setTargetSize(const VVGL::Size & inSize, const bool & inResi
 	GLTexToTexCopierRef		copier = nullptr;
 	bool					shouldBeFloat = false;
 	bool					shouldBeIOSurface = false;
+	bool					shouldBeImmutable = false;
 	if (_parentDoc != nullptr)	{
 		ISFScene		*parentScene = _parentDoc->parentScene();
 		if (parentScene != nullptr)	{
@@ -93,6 +94,7 @@ void ISFPassTarget::setTargetSize(const VVGL::Size & inSize, const bool & inResi
 			copier = parentScene->privateCopier();
 			shouldBeFloat = parentScene->alwaysRenderToFloat();
 			shouldBeIOSurface = parentScene->persistentToIOSurface();
+			shouldBeImmutable = parentScene->immutablePassTargets();
 		}
 	}
 	//	if that didn't work, use the globals...
@@ -128,6 +130,9 @@ void ISFPassTarget::setTargetSize(const VVGL::Size & inSize, const bool & inResi
 				_buffer = (shouldBeFloat) ? CreateRGBAFloatTexIOSurface(inSize, true, bp) : CreateRGBATexIOSurface(inSize, true, bp);
 			else
 #endif
+			if (shouldBeImmutable)
+				_buffer = (shouldBeFloat) ? CreateRGBAFloatTexImmutable(inSize, true, bp) : CreateRGBATexImmutable(inSize, true, bp);
+			else
 				_buffer = (shouldBeFloat) ? CreateRGBAFloatTex(inSize, true, bp) : CreateRGBATex(inSize, true, bp);
 			
 			//	only copy a black frame to the buffer if it's a persistent buffer (the implication is that as a persistent buffer the content of this frame will matter immediately and it will screw things up if it's anything but a black frame)
@@ -151,6 +156,9 @@ void ISFPassTarget::setTargetSize(const VVGL::Size & inSize, const bool & inResi
 					newBuffer = (shouldBeFloat) ? CreateRGBAFloatTexIOSurface(inSize, true, bp) : CreateRGBATexIOSurface(inSize, true, bp);
 				else
 #endif
+				if (shouldBeImmutable)
+					newBuffer = (shouldBeFloat) ? CreateRGBAFloatTexImmutable(inSize, true, bp) : CreateRGBATexImmutable(inSize, true, bp);
+				else
 					newBuffer = (shouldBeFloat) ? CreateRGBAFloatTex(inSize, true, bp) : CreateRGBATex(inSize, true, bp);
 				
 				copier->sizeVariantCopy(_buffer, newBuffer);
@@ -168,6 +176,9 @@ void ISFPassTarget::setTargetSize(const VVGL::Size & inSize, const bool & inResi
 						_buffer = (shouldBeFloat) ? CreateRGBAFloatTexIOSurface(inSize, true, bp) : CreateRGBATexIOSurface(inSize, true, bp);
 					else
 #endif
+					if (shouldBeImmutable)
+						_buffer = (shouldBeFloat) ? CreateRGBAFloatTexImmutable(inSize, true, bp) : CreateRGBATexImmutable(inSize, true, bp);
+					else
 						_buffer = (shouldBeFloat) ? CreateRGBAFloatTex(inSize, true, bp) : CreateRGBATex(inSize, true, bp);
 				}
 				//	else i'm not supposed to create a new buffer
@@ -241,6 +252,7 @@ void ISFPassTarget::setFloatFlag(const bool & n)	{
 		GLTexToTexCopierRef		copier = nullptr;
 		bool					shouldBeFloat = false;
 		bool					shouldBeIOSurface = false;
+		bool					shouldBeImmutable = false;
 		if (_parentDoc != nullptr)	{
 			ISFScene		*parentScene = _parentDoc->parentScene();
 			if (parentScene != nullptr)	{
@@ -248,6 +260,7 @@ void ISFPassTarget::setFloatFlag(const bool & n)	{
 				copier = parentScene->privateCopier();
 				shouldBeFloat = parentScene->alwaysRenderToFloat();
 				shouldBeIOSurface = parentScene->persistentToIOSurface();
+				shouldBeImmutable = parentScene->immutablePassTargets();
 			}
 		}
 		//	if that didn't work, use the globals...
@@ -281,6 +294,9 @@ void ISFPassTarget::setFloatFlag(const bool & n)	{
 			newBuffer = (shouldBeFloat) ? CreateRGBAFloatTexIOSurface(targetSize(), true, bp) : CreateRGBATexIOSurface(targetSize(), true, bp);
 		else
 #endif
+		if (shouldBeImmutable)
+			newBuffer = (shouldBeFloat) ? CreateRGBAFloatTexImmutable(targetSize(), true, bp) : CreateRGBATexImmutable(targetSize(), true, bp);
+		else
 			newBuffer = (shouldBeFloat) ? CreateRGBAFloatTex(targetSize(), true, bp) : CreateRGBATex(targetSize(), true, bp);
 		
 		if (newBuffer != nullptr)	{
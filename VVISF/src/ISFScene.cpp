@@ -2,6 +2,8 @@
 #include "ISFDoc.hpp"
 #include "ISFPassTarget.hpp"
 
+#include <sstream>
+
 
 
 
@@ -13,6 +15,39 @@ using namespace VVGL;
 using namespace std;
 
 
+//	the uniform buffer binding point that the uniform block (if the shaders are generated with one) is assigned to
+#define UNIFORM_BLOCK_BINDING 0
+//	when a changed value is within this many bytes of the last range of changed bytes, the range is extended instead of starting a new one (uploading a few unchanged bytes is cheaper than another call)
+#define UNIFORM_BLOCK_MERGE_GAP 64
+
+
+//	adds the passed range of bytes [inStart, inEnd) to the passed ranges of dirty bytes, extending the last range if it's close enough
+static void AddUniformBlockDirtyRange(vector<pair<size_t,size_t>> & ioRanges, const size_t & inStart, const size_t & inEnd)	{
+	if (inEnd <= inStart)
+		return;
+	if (ioRanges.size() > 0 && inStart <= ioRanges.back().second + UNIFORM_BLOCK_MERGE_GAP)	{
+		pair<size_t,size_t>		&lastRange = ioRanges.back();
+		lastRange.first = min(lastRange.first, inStart);
+		lastRange.second = max(lastRange.second, inEnd);
+	}
+	else
+		ioRanges.push_back(make_pair(inStart, inEnd));
+}
+//	populates the passed array of four floats with the values passed to shaders as DATE (year, month, day, seconds since midnight)
+static void GetDateVals(float * outVals)	{
+	time_t		now = time(0);
+	tm			*localTime = localtime(&now);
+	double		timeInSeconds = 0.;
+	timeInSeconds += localTime->tm_sec;
+	timeInSeconds += localTime->tm_min * 60.;
+	timeInSeconds += localTime->tm_hour * 60. * 60.;
+	outVals[0] = float(localTime->tm_year+1900.);
+	outVals[1] = float(localTime->tm_mon+1);
+	outVals[2] = float(localTime->tm_mday);
+	outVals[3] = float(timeInSeconds);
+}
+
+
 /*	========================================	*/
 #pragma mark --------------------- constructor/destructor
 
@@ -47,6 +82,14 @@ ISFScene::~ISFScene()	{
 	_vao = nullptr;
 #endif
 	_vbo = nullptr;
+	_uniformBuffer = nullptr;
+}
+
+
+string ISFScene::UniformStats::getDescriptionString() const	{
+	ostringstream	returnMe;
+	returnMe << "<ISFScene::UniformStats sent:" << sent << " skipped:" << skipped << ">";
+	return returnMe.str();
 }
 
 
@@ -146,6 +189,25 @@ void ISFScene::useDoc(ISFDocRef & inDoc)	{
 }
 
 
+void ISFScene::setInputsInUniformBuffer(const bool & n)	{
+	lock_guard<recursive_mutex> rlock(_renderLock);
+	if (n == _inputsInUniformBuffer)
+		return;
+	_inputsInUniformBuffer = n;
+	//	the shaders have to be regenerated (and recompiled) the next time we render
+	if (_compiledInputTypeString!=nullptr)	{
+		delete _compiledInputTypeString;
+		_compiledInputTypeString=nullptr;
+	}
+}
+
+
+ISFScene::UniformStats ISFScene::lastFrameUniformStats()	{
+	lock_guard<recursive_mutex> rlock(_renderLock);
+	return _lastFrameUniformStats;
+}
+
+
 void ISFScene::setBufferForInputNamed(const GLBufferRef & inBuffer, const string & inName)	{
 	ISFDocRef			tmpDoc = doc();
 	if (tmpDoc == nullptr)
@@ -393,6 +455,98 @@ GLBufferRef ISFScene::createAndRenderABuffer(const VVGL::Size & inSize, const do
 	return returnMe;
 	*/
 }
+void ISFScene::prewarmBuffers(const VVGL::Size & inRenderSize, const GLBufferPoolRef & inPoolRef)	{
+	ISFDocRef			tmpDoc = doc();
+	if (tmpDoc == nullptr)
+		return;
+	
+	GLBufferPoolRef		bp = nullptr;
+	if (inPoolRef != nullptr)
+		bp = inPoolRef;
+	else
+		bp = (_privatePool != nullptr) ? _privatePool : GetGlobalBufferPool();
+	if (bp==nullptr)	{
+		cout << "\tERR: bailing, pool null, " << __PRETTY_FUNCTION__ << endl;
+		return;
+	}
+	
+#if defined(VVGL_SDK_MAC)
+	//	IOSurface-backed textures can't be reserved
+	if (_persistentToIOSurface)
+		return;
+#endif
+	
+	//	the number of free textures of each size/format the first frame will need
+	struct Reservation	{
+		VVGL::Size		size;
+		bool			floatFlag;
+		bool			immutableFlag;
+		size_t			count;
+	};
+	vector<Reservation>		reservations;
+	auto					addReservation = [&](const VVGL::Size & inSize, const bool & inFloatFlag, const bool & inImmutableFlag)	{
+		for (auto & reservation : reservations)	{
+			if (reservation.size==inSize && reservation.floatFlag==inFloatFlag && reservation.immutableFlag==inImmutableFlag)	{
+				++reservation.count;
+				return;
+			}
+		}
+		reservations.push_back({ inSize, inFloatFlag, inImmutableFlag, 1 });
+	};
+	
+	{
+		lock_guard<recursive_mutex> lock(_renderLock);
+		
+		//	evaluating the buffer dimensions sizes the persistent and temp pass targets for this render size, and creates their buffers (persistent buffers are also cleared), so the first frame doesn't have to
+		_context->makeCurrentIfNotCurrent();
+		tmpDoc->evalBufferDimensionsWithRenderSize(inRenderSize);
+		
+		//	every pass but the last renders into a new texture (the last pass renders into the caller's buffer, which createAndRenderABuffer() creates at the render size)
+		vector<string>			passes = tmpDoc->renderPasses();
+		ISFPassTargetRef		lastPass = nullptr;
+		size_t					passIndex = 1;
+		for (const auto & pass : passes)	{
+			ISFPassTargetRef		targetBuffer = nullptr;
+			if (pass.size()>0)	{
+				targetBuffer = tmpDoc->persistentPassTargetForKey(pass);
+				if (targetBuffer == nullptr)
+					targetBuffer = tmpDoc->tempPassTargetForKey(pass);
+			}
+			if (passIndex >= passes.size())	{
+				lastPass = targetBuffer;
+				break;
+			}
+			VVGL::Size			targetBufferSize = (targetBuffer==nullptr) ? inRenderSize : targetBuffer->targetSize();
+			addReservation(targetBufferSize, _alwaysRenderToFloat || (targetBuffer!=nullptr && targetBuffer->floatFlag()), _immutablePassTargets);
+			++passIndex;
+		}
+		//	the output buffer isn't a pass target, so it's always created with mutable storage
+		addReservation(inRenderSize, _alwaysRenderToFloat || (lastPass!=nullptr && lastPass->floatFlag()), false);
+		
+		//	temp buffers are cleared at the end of every frame and re-created when the next frame evaluates its buffer dimensions- return them to the pool, and make sure the pool has enough free textures for them
+		for (const auto & tempTarget : tmpDoc->tempPassTargets())	{
+			if (tempTarget->buffer() == nullptr)
+				continue;
+			addReservation(tempTarget->targetSize(), _alwaysRenderToFloat, _immutablePassTargets);
+			tempTarget->clearBuffer();
+		}
+	}
+	
+	for (const auto & reservation : reservations)	{
+		if (reservation.immutableFlag)	{
+			if (reservation.floatFlag)
+				ReserveRGBAFloatTexImmutable(reservation.size, reservation.count, bp);
+			else
+				ReserveRGBATexImmutable(reservation.size, reservation.count, bp);
+		}
+		else	{
+			if (reservation.floatFlag)
+				ReserveRGBAFloatTex(reservation.size, reservation.count, bp);
+			else
+				ReserveRGBATex(reservation.size, reservation.count, bp);
+		}
+	}
+}
 void ISFScene::renderToBuffer(const GLBufferRef & inTargetBuffer, const VVGL::Size & inRenderSize, const double & inRenderTime, map<int32_t,GLBufferRef> * outPassDict)	{
 	_render(inTargetBuffer, inRenderSize, inRenderTime, outPassDict);
 }
@@ -537,8 +691,7 @@ void ISFScene::_setUpRenderCallback()	{
 			GLBufferRef		myVAO = vao();
 			if (myVAO == nullptr)
 				return;
-			glBindVertexArray(myVAO->name);
-			GLERRLOG
+			GLStateCache::BindVertexArray(myVAO->name);
 		
 			//	if the target quad doesn't match the contents of the vbo in the vao
 			if (targetQuad != _vboContents)	{
@@ -559,28 +712,27 @@ void ISFScene::_setUpRenderCallback()	{
 				}
 			
 				//	un-bind the VAO, we're done configuring it
-				glBindVertexArray(0);
-				GLERRLOG
+				GLStateCache::BindVertexArray(0);
 				//	delete the VBO we just made (the VAO will retain it)
 				glDeleteBuffers(1, &tmpVBO);
 				GLERRLOG
 				//	update my local copy of the vbo contents
 				_vboContents = targetQuad;
 				//	re-enable the VAO!
-				glBindVertexArray(myVAO->name);
-				GLERRLOG
+				GLStateCache::BindVertexArray(myVAO->name);
 			}
 		
 			//	...draw!
 			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 			GLERRLOG
 		
-			//	un-bind the VAO
-			glBindVertexArray(0);
-			GLERRLOG
+			//	un-bind the VAO (deferred until the state cache scope closes, so every pass doesn't rebind it)
+			GLStateCache::ReleaseVertexArray();
 		}
 	});
 #endif
+	//	the render callback changes bindings through GLStateCache, so the scene doesn't have to invalidate the cache after running it
+	_callbacksUseStateCache = true;
 	
 	
 	
@@ -655,7 +807,7 @@ void ISFScene::_renderPrep()	{
 		string		tmpFrag;
 		string		tmpVert;
 		GLVersion	tmpVersion = (_context==nullptr) ? GLVersion_2 : _context->version;
-		_doc->generateShaderSource(&tmpFrag, &tmpVert, tmpVersion);
+		_doc->generateShaderSource(&tmpFrag, &tmpVert, tmpVersion, _shouldUseUniformBlock());
 		setVertexShaderString(tmpVert);
 		setFragmentShaderString(tmpFrag);
 	}
@@ -704,55 +856,39 @@ void ISFScene::_renderPrep()	{
 		//cout << "\terr: no program, " << __PRETTY_FUNCTION__ << endl;
 		return;
 	}
+	//	the locations of the program's uniforms are looked up in the description of the program that was made when it was linked
+	GLProgramReflectionRef		reflection = programReflection();
+	if (reflection == nullptr)
+		return;
 	
 	//	set up some vars and some blocks that we're going to use to cache the locations of uniforms in the attributes of the ISFDoc instance, and eventually push those vals to GL
 	GLint				samplerLoc = 0;
 	GLint				textureCount = 0;
 	GLBufferRef		tmpBuffer = nullptr;
 	VVGL::Rect				tmpRect;
-	char				tmpCString[64];
-	memset(tmpCString, 0, 64);
 	
-	//	this block retrieves and stores the uniform location from the passed attribute for simple val-based attributes
-	auto		setAttrUniformsSimpleValBlock = [&](const ISFAttrRef & inAttr)	{
-		const char *	tmpAttrName = inAttr->name().c_str();
-		samplerLoc = (_program<=0) ? -1 : glGetUniformLocation(_program, tmpAttrName);
-		GLERRLOG
-		inAttr->setUniformLocation(0, samplerLoc);
+	//	this block returns true if the current value of the passed attribute has to be pushed to the program (it changed since it was last pushed), and counts the uniform as sent or skipped
+	auto		attrValNeedsPushBlock = [&](const ISFAttrRef & inAttr)	{
+		uint64_t		valGeneration = inAttr->valGeneration();
+		if (inAttr->pushedValGeneration() == valGeneration)	{
+			++_uniformStats.skipped;
+			return false;
+		}
+		inAttr->setPushedValGeneration(valGeneration);
+		++_uniformStats.sent;
+		return true;
 	};
-	//	this block retrieves and stores the uniform locations from the passed attribute for cube-based attributes
-	auto		setAttrUniformsCubeBlock = [&](const ISFAttrRef & inAttr)	{
-		const char *		tmpAttrName = inAttr->name().c_str();
-		samplerLoc = (_program<=0) ? -1 : glGetUniformLocation(_program, tmpAttrName);
-		GLERRLOG
-		inAttr->setUniformLocation(0, samplerLoc);
-		
-		sprintf(tmpCString,"_%s_imgSize",tmpAttrName);
-		samplerLoc = (_program<=0) ? -1 : glGetUniformLocation(_program, tmpCString);
-		GLERRLOG
-		inAttr->setUniformLocation(2, samplerLoc);
+	//	this block counts a standard uniform as sent or skipped
+	auto		countStandardUniBlock = [&](const bool & inSent)	{
+		if (inSent)
+			++_uniformStats.sent;
+		else
+			++_uniformStats.skipped;
 	};
-	//	this block retrieves and stores the uniform locations from the passed attribute for all other image-based attributes
-	auto		setAttrUniformsImageBlock = [&](const ISFAttrRef & inAttr)	{
-		const char *		tmpAttrName = inAttr->name().c_str();
-		samplerLoc = (_program<=0) ? -1 : glGetUniformLocation(_program, tmpAttrName);
-		GLERRLOG
-		inAttr->setUniformLocation(0, samplerLoc);
-		
-		sprintf(tmpCString,"_%s_imgRect",tmpAttrName);
-		samplerLoc = (_program<=0) ? -1 : glGetUniformLocation(_program, tmpCString);
-		GLERRLOG
-		inAttr->setUniformLocation(1, samplerLoc);
-		
-		sprintf(tmpCString,"_%s_imgSize",tmpAttrName);
-		samplerLoc = (_program<=0) ? -1 : glGetUniformLocation(_program, tmpCString);
-		GLERRLOG
-		inAttr->setUniformLocation(2, samplerLoc);
-		
-		sprintf(tmpCString,"_%s_flip",tmpAttrName);
-		samplerLoc = (_program<=0) ? -1 : glGetUniformLocation(_program, tmpCString);
-		GLERRLOG
-		inAttr->setUniformLocation(3, samplerLoc);
+	
+	//	this block looks up and stores the uniform locations of the passed attribute (the names of its uniforms were made when it was created)
+	auto		setAttrUniformsBlock = [&](const ISFAttrRef & inAttr)	{
+		inAttr->cacheUniformLocations(*reflection);
 	};
 	//	this block gets a buffer for a cube texture from the passed attrib and pushes it to the gl program
 	auto		pushAttrUniformsCubeBlock = [&](const ISFAttrRef & inAttr)	{
@@ -760,19 +896,18 @@ void ISFScene::_renderPrep()	{
 		//if (tmpBuffer != nullptr && inAttr->getUniformLocation(0)>=0)	{
 			//	pass the actual texture to the program
 			if (tmpBuffer != nullptr)	{
-				glActiveTexture(GL_TEXTURE0 + textureCount);
-				GLERRLOG
+				GLStateCache::ActiveTexture(GL_TEXTURE0 + textureCount);
 				if (_context->version <= GLVersion_2)	{
 					glEnable(tmpBuffer->desc.target);
 					GLERRLOG
 				}
-				glBindTexture(tmpBuffer->desc.target, tmpBuffer->name);
-				GLERRLOG
+				GLStateCache::BindTexture(tmpBuffer->desc.target, tmpBuffer->name);
 			}
 			samplerLoc = inAttr->getUniformLocation(0);
 			if (samplerLoc >= 0)	{
 				glUniform1i(samplerLoc, textureCount);
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 			++textureCount;
 			//	pass the size to the program
@@ -781,6 +916,7 @@ void ISFScene::_renderPrep()	{
 			if (samplerLoc >= 0)	{
 				glUniform2f(samplerLoc, float(tmpRect.size.width), float(tmpRect.size.height));
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 		//}
 	};
@@ -790,19 +926,18 @@ void ISFScene::_renderPrep()	{
 		//if (tmpBuffer != nullptr && inAttr->getUniformLocation(0)>=0)	{
 			//	pass the actual texture to the program
 			if (tmpBuffer != nullptr)	{
-				glActiveTexture(GL_TEXTURE0 + textureCount);
-				GLERRLOG
+				GLStateCache::ActiveTexture(GL_TEXTURE0 + textureCount);
 				if (_context->version <= GLVersion_2)	{
 					glEnable(tmpBuffer->desc.target);
 					GLERRLOG
 				}
-				glBindTexture(tmpBuffer->desc.target, tmpBuffer->name);
-				GLERRLOG
+				GLStateCache::BindTexture(tmpBuffer->desc.target, tmpBuffer->name);
 			}
 			samplerLoc = inAttr->getUniformLocation(0);
 			if (samplerLoc >= 0)	{
 				glUniform1i(samplerLoc,textureCount);
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 			++textureCount;
 			//	pass the img rect to the program
@@ -811,6 +946,7 @@ void ISFScene::_renderPrep()	{
 			if (samplerLoc >= 0)	{
 				glUniform4f(samplerLoc, float(tmpRect.origin.x), float(tmpRect.origin.y), float(tmpRect.size.width), float(tmpRect.size.height));
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 			//	pass the size to the program
 			tmpRect = (tmpBuffer==nullptr) ? VVGL::Rect(0,0,1,1) : tmpBuffer->srcRect;
@@ -818,12 +954,14 @@ void ISFScene::_renderPrep()	{
 			if (samplerLoc >= 0)	{
 				glUniform2f(samplerLoc, float(tmpRect.size.width), float(tmpRect.size.height));
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 			//	pass the flippedness to the program
 			samplerLoc = inAttr->getUniformLocation(3);
 			if (samplerLoc >= 0)	{
 				glUniform1i(samplerLoc,((tmpBuffer!=nullptr && tmpBuffer->flipped)?1:0));
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 		//}
 	};
@@ -866,7 +1004,7 @@ void ISFScene::_renderPrep()	{
 		//GLERRLOG
 		//inTarget->setUniformLocation(3, samplerLoc);
 		
-		inTarget->cacheUniformLocations(_program);
+		inTarget->cacheUniformLocations(*reflection);
 	};
 	/*
 	auto		pushTargetUniformsCubeBlock = [&](const ISFPassTargetRef & inTarget)	{
@@ -902,19 +1040,18 @@ void ISFScene::_renderPrep()	{
 		tmpBuffer = inTarget->buffer();
 		if (tmpBuffer != nullptr)	{
 			//	pass the actual texture to the program
-			glActiveTexture(GL_TEXTURE0 + textureCount);
-			GLERRLOG
+			GLStateCache::ActiveTexture(GL_TEXTURE0 + textureCount);
 			if (_context->version <= GLVersion_2)	{
 				glEnable(tmpBuffer->desc.target);
 				GLERRLOG
 			}
-			glBindTexture(tmpBuffer->desc.target, tmpBuffer->name);
-			GLERRLOG
+			GLStateCache::BindTexture(tmpBuffer->desc.target, tmpBuffer->name);
 			
 			samplerLoc = inTarget->getUniformLocation(0);
 			if (samplerLoc >= 0)	{
 				glUniform1i(samplerLoc,textureCount);
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 			++textureCount;
 			//	pass the img rect to the program
@@ -923,6 +1060,7 @@ void ISFScene::_renderPrep()	{
 			if (samplerLoc >= 0)	{
 				glUniform4f(samplerLoc, float(tmpRect.origin.x), float(tmpRect.origin.y), float(tmpRect.size.width), float(tmpRect.size.height));
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 			//	pass the size to the program
 			tmpRect = tmpBuffer->srcRect;
@@ -930,12 +1068,14 @@ void ISFScene::_renderPrep()	{
 			if (samplerLoc >= 0)	{
 				glUniform2f(samplerLoc, float(tmpRect.size.width), float(tmpRect.size.height));
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 			//	pass the flippedness to the program
 			samplerLoc = inTarget->getUniformLocation(3);
 			if (samplerLoc >= 0)	{
 				glUniform1i(samplerLoc,((tmpBuffer->flipped)?1:0));
 				GLERRLOG
+				++_uniformStats.sent;
 			}
 		}
 	};
@@ -957,12 +1097,12 @@ void ISFScene::_renderPrep()	{
 		case ISFValType_Event:
 			{
 			if (findNewUniforms)
-				setAttrUniformsSimpleValBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			samplerLoc = attribRef->getUniformLocation(0);
 			
 			//GLint			tmpInt = currentVal.getBoolVal();
 			//cout << "\tuploading event val as " << tmpInt << endl;
-			if (samplerLoc >= 0)	{
+			if (samplerLoc >= 0 && attrValNeedsPushBlock(attribRef))	{
 				glUniform1i(samplerLoc, currentVal.getBoolVal());
 				GLERRLOG
 			}
@@ -979,9 +1119,9 @@ void ISFScene::_renderPrep()	{
 			//cout << "\tprocessing bool-type attr: " << *attribRef << endl;
 			//attribRef->lengthyDescription();
 			if (findNewUniforms)
-				setAttrUniformsSimpleValBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			samplerLoc = attribRef->getUniformLocation(0);
-			if (samplerLoc >= 0)	{
+			if (samplerLoc >= 0 && attrValNeedsPushBlock(attribRef))	{
 				glUniform1i(samplerLoc, currentVal.getBoolVal());
 				GLERRLOG
 			}
@@ -989,9 +1129,9 @@ void ISFScene::_renderPrep()	{
 			}
 		case ISFValType_Long:
 			if (findNewUniforms)
-				setAttrUniformsSimpleValBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			samplerLoc = attribRef->getUniformLocation(0);
-			if (samplerLoc >= 0)	{
+			if (samplerLoc >= 0 && attrValNeedsPushBlock(attribRef))	{
 				glUniform1i(samplerLoc, (int32_t)(currentVal.getDoubleVal()));
 				GLERRLOG
 			}
@@ -999,18 +1139,18 @@ void ISFScene::_renderPrep()	{
 		case ISFValType_Float:
 			//cout << "\tprocessing float-type input named " << attribRef->name() << ", val is " << currentVal.getDoubleVal() << endl;
 			if (findNewUniforms)
-				setAttrUniformsSimpleValBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			samplerLoc = attribRef->getUniformLocation(0);
-			if (samplerLoc >= 0)	{
+			if (samplerLoc >= 0 && attrValNeedsPushBlock(attribRef))	{
 				glUniform1f(samplerLoc, (float)(currentVal.getDoubleVal()));
 				GLERRLOG
 			}
 			break;
 		case ISFValType_Point2D:
 			if (findNewUniforms)
-				setAttrUniformsSimpleValBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			samplerLoc = attribRef->getUniformLocation(0);
-			if (samplerLoc >= 0)	{
+			if (samplerLoc >= 0 && attrValNeedsPushBlock(attribRef))	{
 				//glUniform2f(samplerLoc, currentVal.val.pointVal[0], currentVal.val.pointVal[1]);
 				//GLERRLOG
 				double		*pointVals = currentVal.getPointValPtr();
@@ -1026,9 +1166,9 @@ void ISFScene::_renderPrep()	{
 			break;
 		case ISFValType_Color:
 			if (findNewUniforms)
-				setAttrUniformsSimpleValBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			samplerLoc = attribRef->getUniformLocation(0);
-			if (samplerLoc >= 0)	{
+			if (samplerLoc >= 0 && attrValNeedsPushBlock(attribRef))	{
 				//glUniform4f(samplerLoc, currentVal.val.colorVal[0], currentVal.val.colorVal[1], currentVal.val.colorVal[2], currentVal.val.colorVal[3]);
 				//GLERRLOG
 				double		*colorVals = currentVal.getColorValPtr();
@@ -1044,7 +1184,7 @@ void ISFScene::_renderPrep()	{
 			break;
 		case ISFValType_Cube:
 			if (findNewUniforms)
-				setAttrUniformsCubeBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			pushAttrUniformsCubeBlock(attribRef);
 			break;
 		case ISFValType_Image:
@@ -1056,7 +1196,7 @@ void ISFScene::_renderPrep()	{
 			//cout << ", buffer is " << tmpBuffer;
 			//if (tmpBuffer==nullptr) cout << "/null" << endl; else cout << "/" << *tmpBuffer << endl;
 			if (findNewUniforms)
-				setAttrUniformsImageBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			pushAttrUniformsImageBlock(attribRef);
 			break;
 			}
@@ -1073,12 +1213,12 @@ void ISFScene::_renderPrep()	{
 		
 		if (attribRef->type() == ISFValType_Cube)	{
 			if (findNewUniforms)
-				setAttrUniformsCubeBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			pushAttrUniformsCubeBlock(attribRef);
 		}
 		else if (attribRef->shouldHaveImageBuffer())	{
 			if (findNewUniforms)
-				setAttrUniformsImageBlock(attribRef);
+				setAttrUniformsBlock(attribRef);
 			pushAttrUniformsImageBlock(attribRef);
 		}
 	}
@@ -1107,47 +1247,241 @@ void ISFScene::_renderPrep()	{
 	
 	//	if we're finding new uniforms then we also have to update the uniform locations of some standard inputs
 	if (findNewUniforms)	{
-		_vertexAttrib.cacheTheLoc(_program);
-		_renderSizeUni.cacheTheLoc(_program);
-		_passIndexUni.cacheTheLoc(_program);
-		_timeUni.cacheTheLoc(_program);
-		_timeDeltaUni.cacheTheLoc(_program);
-		_dateUni.cacheTheLoc(_program);
-		_renderFrameIndexUni.cacheTheLoc(_program);
+		_vertexAttrib.cacheTheLoc(*reflection);
+		_renderSizeUni.cacheTheLoc(*reflection);
+		_passIndexUni.cacheTheLoc(*reflection);
+		_timeUni.cacheTheLoc(*reflection);
+		_timeDeltaUni.cacheTheLoc(*reflection);
+		_dateUni.cacheTheLoc(*reflection);
+		_renderFrameIndexUni.cacheTheLoc(*reflection);
+		
+		//	if the program has a uniform block, assign it to its binding point and find out how big it is.  the layout of the block may have changed, so the mirror starts over.
+		_programUsesUniformBlock = false;
+		_uniformBlockSize = 0;
+		_uniformBlockMirror.clear();
+		_uniformBlockDirty.clear();
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+		if (_shouldUseUniformBlock())	{
+			GLuint			blockIndex = glGetUniformBlockIndex(_program, "VVISF_UNIFORMS");
+			GLERRLOG
+			if (blockIndex != GL_INVALID_INDEX)	{
+				GLint			blockSize = 0;
+				glGetActiveUniformBlockiv(_program, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+				GLERRLOG
+				glUniformBlockBinding(_program, blockIndex, UNIFORM_BLOCK_BINDING);
+				GLERRLOG
+				_programUsesUniformBlock = true;
+				_uniformBlockSize = (blockSize<0) ? 0 : size_t(blockSize);
+			}
+		}
+#endif
 	}
-	//	push the standard inputs to the program
-	if (_renderSizeUni.loc >= 0)	{
-		glUniform2f(_renderSizeUni.loc, float(_orthoSize.width), float(_orthoSize.height));
-		GLERRLOG
+	//	push the standard inputs to the program (the cached uniforms skip values that they already sent)
+	if (_renderSizeUni.loc >= 0)
+		countStandardUniBlock(_renderSizeUni.set2f(float(_orthoSize.width), float(_orthoSize.height)));
+	if (_passIndexUni.loc >= 0)
+		countStandardUniBlock(_passIndexUni.set1i(int32_t(_passIndex)-1));
+	if (_timeUni.loc >= 0)
+		countStandardUniBlock(_timeUni.set1f((float)_renderTime));
+	if (_timeDeltaUni.loc >= 0)
+		countStandardUniBlock(_timeDeltaUni.set1f((float)_renderTimeDelta));
+	if (_dateUni.loc >= 0)	{
+		float		dateVals[4];
+		GetDateVals(dateVals);
+		countStandardUniBlock(_dateUni.set4f(dateVals[0], dateVals[1], dateVals[2], dateVals[3]));
 	}
-	if (_passIndexUni.loc >= 0)	{
-		glUniform1i(_passIndexUni.loc, _passIndex-1);
-		GLERRLOG
+	if (_renderFrameIndexUni.loc >= 0)
+		countStandardUniBlock(_renderFrameIndexUni.set1i(int32_t(_renderFrameIndex)));
+	
+	//	if the program has a uniform block, the values of the inputs and the standard uniforms are in it (the members of a block don't have uniform locations, so none of them were pushed above)
+	if (_programUsesUniformBlock)
+		_updateUniformBlock(_doc);
+	
+	//cout << "\t" << __PRETTY_FUNCTION__ << "- FINISHED" << endl;
+}
+bool ISFScene::_shouldUseUniformBlock()	{
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+	if (!_inputsInUniformBuffer || _context == nullptr)
+		return false;
+	switch (_context->version)	{
+	case GLVersion_ES3:
+	case GLVersion_33:
+	case GLVersion_4:
+		return true;
+	default:
+		return false;
 	}
-	if (_timeUni.loc >= 0)	{
-		glUniform1f(_timeUni.loc, (float)_renderTime);
-		GLERRLOG
+#else
+	return false;
+#endif
+}
+void ISFScene::_writeUniformBlockMember(size_t & ioOffset, const void * inBytes, const size_t & inSize, const size_t & inAlign)	{
+	//	std140 aligns every member to its own size (vec3s aside, which we don't use)
+	ioOffset = (ioOffset + inAlign - 1) / inAlign * inAlign;
+	size_t		memberEnd = ioOffset + inSize;
+	//	if the mirror isn't big enough (the layout changed), grow it- the new bytes haven't been uploaded yet
+	if (_uniformBlockMirror.size() < memberEnd)	{
+		AddUniformBlockDirtyRange(_uniformBlockDirty, _uniformBlockMirror.size(), memberEnd);
+		_uniformBlockMirror.resize(memberEnd, 0);
 	}
-	if (_timeDeltaUni.loc >= 0)	{
-		glUniform1f(_timeDeltaUni.loc, (float)_renderTimeDelta);
-		GLERRLOG
+	//	only values that changed are marked dirty
+	if (inBytes != nullptr)	{
+		uint8_t		*dst = &_uniformBlockMirror[ioOffset];
+		if (memcmp(dst, inBytes, inSize) != 0)	{
+			memcpy(dst, inBytes, inSize);
+			AddUniformBlockDirtyRange(_uniformBlockDirty, ioOffset, memberEnd);
+		}
 	}
-	if (_dateUni.loc >= 0)	{
-		time_t		now = time(0);
-		tm			*localTime = localtime(&now);
-		double		timeInSeconds = 0.;
-		timeInSeconds += localTime->tm_sec;
-		timeInSeconds += localTime->tm_min * 60.;
-		timeInSeconds += localTime->tm_hour * 60. * 60.;
-		glUniform4f(_dateUni.loc, float(localTime->tm_year+1900.), float(localTime->tm_mon+1), float(localTime->tm_mday), float(timeInSeconds));
+	ioOffset = memberEnd;
+}
+void ISFScene::_updateUniformBlock(const ISFDocRef & inDoc)	{
+#if defined(VVGL_TARGETENV_GL3PLUS) || defined(VVGL_TARGETENV_GLES3)
+	if (inDoc == nullptr || _context == nullptr)
+		return;
+	
+	//	these blocks write the members of the uniform block, using their std140 sizes and alignments.  bools are 4 bytes in std140.
+	size_t			offset = 0;
+	auto			writeInt = [&](const int32_t & n)	{ _writeUniformBlockMember(offset, &n, 4, 4); };
+	auto			writeBool = [&](const bool & n)	{ int32_t tmpInt = (n) ? 1 : 0; _writeUniformBlockMember(offset, &tmpInt, 4, 4); };
+	auto			writeFloat = [&](const float & n)	{ _writeUniformBlockMember(offset, &n, 4, 4); };
+	auto			writeVec2 = [&](const float * n)	{ _writeUniformBlockMember(offset, n, 8, 8); };
+	auto			writeVec4 = [&](const float * n)	{ _writeUniformBlockMember(offset, n, 16, 16); };
+	//	this block writes the img rect, size, and flippedness of the passed buffer (null buffers are written as a 1x1 unflipped image)
+	auto			writeImageBlock = [&](const GLBufferRef & inBuffer)	{
+		VVGL::Rect		tmpRect = (inBuffer==nullptr) ? VVGL::Rect(0,0,1,1) : inBuffer->glReadySrcRect();
+		float			rectVals[4] = { float(tmpRect.origin.x), float(tmpRect.origin.y), float(tmpRect.size.width), float(tmpRect.size.height) };
+		writeVec4(rectVals);
+		tmpRect = (inBuffer==nullptr) ? VVGL::Rect(0,0,1,1) : inBuffer->srcRect;
+		float			sizeVals[2] = { float(tmpRect.size.width), float(tmpRect.size.height) };
+		writeVec2(sizeVals);
+		writeBool(inBuffer!=nullptr && inBuffer->flipped);
+	};
+	//	this block writes the members for the passed attribute- it has to match the declarations ISFDoc makes for it
+	auto			writeAttrBlock = [&](const ISFAttrRef & inAttr)	{
+		ISFVal &		currentVal = inAttr->currentVal();
+		switch (inAttr->type())	{
+		case ISFValType_None:
+			break;
+		case ISFValType_Event:
+		case ISFValType_Bool:
+			writeBool(currentVal.getBoolVal());
+			break;
+		case ISFValType_Long:
+			writeInt((int32_t)(currentVal.getDoubleVal()));
+			break;
+		case ISFValType_Float:
+			writeFloat((float)(currentVal.getDoubleVal()));
+			break;
+		case ISFValType_Point2D:
+			{
+				double			*pointVals = currentVal.getPointValPtr();
+				float			tmpVals[2] = { 0., 0. };
+				if (pointVals != nullptr)	{
+					tmpVals[0] = float(pointVals[0]);
+					tmpVals[1] = float(pointVals[1]);
+				}
+				writeVec2(tmpVals);
+			}
+			break;
+		case ISFValType_Color:
+			{
+				double			*colorVals = currentVal.getColorValPtr();
+				float			tmpVals[4] = { 0., 0., 0., 0. };
+				if (colorVals != nullptr)	{
+					for (int i=0; i<4; ++i)
+						tmpVals[i] = float(colorVals[i]);
+				}
+				writeVec4(tmpVals);
+			}
+			break;
+		case ISFValType_Cube:
+			{
+				GLBufferRef		tmpBuffer = inAttr->getCurrentImageBuffer();
+				VVGL::Rect		tmpRect = (tmpBuffer==nullptr) ? VVGL::Rect(0,0,1,1) : tmpBuffer->srcRect;
+				float			sizeVals[2] = { float(tmpRect.size.width), float(tmpRect.size.height) };
+				writeVec2(sizeVals);
+			}
+			break;
+		case ISFValType_Image:
+		case ISFValType_Audio:
+		case ISFValType_AudioFFT:
+			writeImageBlock(inAttr->getCurrentImageBuffer());
+			break;
+		}
+	};
+	
+	//	the standard uniforms
+	writeInt(int32_t(_passIndex)-1);
+	float			tmpVals[4] = { float(_orthoSize.width), float(_orthoSize.height), 0., 0. };
+	writeVec2(tmpVals);
+	writeFloat((float)_renderTime);
+	writeFloat((float)_renderTimeDelta);
+	GetDateVals(tmpVals);
+	writeVec4(tmpVals);
+	writeInt(int32_t(_renderFrameIndex));
+	//	the inputs and imported images
+	for (const auto & attribRef : inDoc->inputs())	{
+		if (attribRef != nullptr)
+			writeAttrBlock(attribRef);
+	}
+	for (const auto & attribRef : inDoc->imageImports())	{
+		if (attribRef != nullptr)
+			writeAttrBlock(attribRef);
+	}
+	//	the persistent and temp buffers- targets that don't have a buffer yet keep the values they had (just like they do when the values are pushed as uniforms)
+	auto			writeTargetBlock = [&](const ISFPassTargetRef & inTarget)	{
+		GLBufferRef		tmpBuffer = (inTarget==nullptr) ? nullptr : inTarget->buffer();
+		if (tmpBuffer != nullptr)
+			writeImageBlock(tmpBuffer);
+		else	{
+			_writeUniformBlockMember(offset, nullptr, 16, 16);
+			_writeUniformBlockMember(offset, nullptr, 8, 8);
+			_writeUniformBlockMember(offset, nullptr, 4, 4);
+		}
+	};
+	for (const auto & targetRef : inDoc->persistentPassTargets())
+		writeTargetBlock(targetRef);
+	for (const auto & targetRef : inDoc->tempPassTargets())
+		writeTargetBlock(targetRef);
+	
+	//	the block is padded out to a multiple of a vec4- GL may report a larger size, in which case we use that
+	size_t			blockSize = max(_uniformBlockSize, (offset + 15) / 16 * 16);
+	if (_uniformBlockMirror.size() < blockSize)	{
+		AddUniformBlockDirtyRange(_uniformBlockDirty, _uniformBlockMirror.size(), blockSize);
+		_uniformBlockMirror.resize(blockSize, 0);
+	}
+	
+	//	make the buffer if we don't have one (or it's too small).  GL buffer objects aren't typed, so the buffer is created the same way as a VBO.
+	if (_uniformBuffer == nullptr || _uniformBufferSize < blockSize)	{
+		GLBufferPoolRef		bp = (_privatePool!=nullptr) ? _privatePool : GetGlobalBufferPool();
+		_uniformBuffer = CreateVBO(nullptr, blockSize, GL_DYNAMIC_DRAW, true, bp);
+		_uniformBufferSize = (_uniformBuffer==nullptr) ? 0 : blockSize;
+		_uniformBufferBound = false;
+		//	the new buffer's contents are undefined, so all of it has to be uploaded
+		_uniformBlockDirty.clear();
+		AddUniformBlockDirtyRange(_uniformBlockDirty, 0, blockSize);
+	}
+	if (_uniformBuffer == nullptr)
+		return;
+	
+	//	the buffer is bound once per frame (the first pass binds it, the other passes use it)
+	if (!_uniformBufferBound)	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, UNIFORM_BLOCK_BINDING, _uniformBuffer->name);
 		GLERRLOG
+		_uniformBufferBound = true;
 	}
-	if (_renderFrameIndexUni.loc >= 0)	{
-		glUniform1i(_renderFrameIndexUni.loc, _renderFrameIndex);
+	//	upload the bytes that changed.  after the first pass of a frame, this is usually just PASSINDEX.
+	for (const auto & range : _uniformBlockDirty)	{
+		size_t			rangeEnd = min(range.second, _uniformBufferSize);
+		if (rangeEnd <= range.first)
+			continue;
+		glBufferSubData(GL_UNIFORM_BUFFER, GLintptr(range.first), GLsizeiptr(rangeEnd - range.first), &_uniformBlockMirror[range.first]);
 		GLERRLOG
 	}
-	
-	//cout << "\t" << __PRETTY_FUNCTION__ << "- FINISHED" << endl;
+	_uniformBlockDirty.clear();
+#else
+	(void)inDoc;
+#endif
 }
 void ISFScene::_initialize()	{
 	if (_deleted)
@@ -1177,6 +1511,27 @@ void ISFScene::_renderCleanup()	{
 	//	return;
 	//}
 }
+void ISFScene::_sharedProgramUsedElsewhere()	{
+	GLScene::_sharedProgramUsedElsewhere();
+	
+	//	another scene pushed its values to the program, so none of ours can be skipped the next time they're pushed
+	if (_doc != nullptr)	{
+		for (const auto & attribRef : _doc->inputs())	{
+			if (attribRef != nullptr)
+				attribRef->setPushedValGeneration(0);
+		}
+		for (const auto & attribRef : _doc->imageImports())	{
+			if (attribRef != nullptr)
+				attribRef->setPushedValGeneration(0);
+		}
+	}
+	_renderSizeUni.forgetSentVal();
+	_passIndexUni.forgetSentVal();
+	_timeUni.forgetSentVal();
+	_timeDeltaUni.forgetSentVal();
+	_dateUni.forgetSentVal();
+	_renderFrameIndexUni.forgetSentVal();
+}
 void ISFScene::_render(const GLBufferRef & inTargetBuffer, const VVGL::Size & inSize, const double & inTime, map<int32_t,GLBufferRef> * outPassDict)	{
 	//cout << __FUNCTION__ << ", self is " << doc()->name() << ", time is " << inTime << endl;
 	//cout << "\tinSize is " << inSize << ", inTargetBuffer is " << *inTargetBuffer << endl;
@@ -1217,6 +1572,8 @@ void ISFScene::_render(const GLBufferRef & inTargetBuffer, const VVGL::Size & in
 		GLBufferRef				tmpFBO = CreateFBO(false, bp);
 		
 		_context->makeCurrentIfNotCurrent();
+		//	the passes share a state cache scope, so the bindings they have in common (FBO, VAO, program if it's the same) are only made once
+		GLStateCache::Scope		tmpScope(_context);
 		
 		//	tell the doc to evaluate its buffers with the passed render size
 		tmpDoc->evalBufferDimensionsWithRenderSize(_renderSize);
@@ -1238,6 +1595,8 @@ void ISFScene::_render(const GLBufferRef & inTargetBuffer, const VVGL::Size & in
 		//	run through the array of passes, rendering each of them
 		vector<string>			passes = tmpDoc->renderPasses();
 		_passIndex = 1;
+		//	if the shaders use a uniform block, its buffer is bound by the first pass of every frame
+		_uniformBufferBound = false;
 		for (const auto & pass : passes)	{
 			//cout << "\trendering pass " << _passIndex << endl;
 			//	get the name of the target buffer for this pass (if there is a name)
@@ -1281,6 +1640,9 @@ void ISFScene::_render(const GLBufferRef & inTargetBuffer, const VVGL::Size & in
 					tmpRenderTarget.color = (shouldBeFloat || (targetBuffer!=nullptr && targetBuffer->floatFlag())) ? CreateRGBAFloatTexIOSurface(targetBufferSize, true, bp) : CreateRGBATexIOSurface(targetBufferSize, true, bp);
 				else
 #endif
+				if (_immutablePassTargets)
+					tmpRenderTarget.color = (shouldBeFloat || (targetBuffer!=nullptr && targetBuffer->floatFlag())) ? CreateRGBAFloatTexImmutable(targetBufferSize, true, bp) : CreateRGBATexImmutable(targetBufferSize, true, bp);
+				else
 					tmpRenderTarget.color = (shouldBeFloat || (targetBuffer!=nullptr && targetBuffer->floatFlag())) ? CreateRGBAFloatTex(targetBufferSize, true, bp) : CreateRGBATex(targetBufferSize, true, bp);
 				
 				//_context->makeCurrentIfNotCurrent();
@@ -1291,7 +1653,12 @@ void ISFScene::_render(const GLBufferRef & inTargetBuffer, const VVGL::Size & in
 			
 			//_context->makeCurrentIfNotCurrent();
 			
-			render(tmpRenderTarget);
+			//	while debug output is enabled, each pass is rendered in a debug group (so the messages GL reports can be traced back to the pass)
+			{
+				_context->makeCurrentIfNotCurrent();
+				GLDebugLog::Group		passGroup((GLDebugLog::Enabled()) ? FmtString("ISF \"%s\" pass %d%s%s", tmpDoc->name().c_str(), _passIndex-1, (pass.size()>0) ? " -> " : "", pass.c_str()) : string());
+				render(tmpRenderTarget);
+			}
 			
 			//	if there's an out pass dict, add the frame i just rendered into to it at the appropriate key
 			if (outPassDict!=nullptr && tmpRenderTarget.color!=nullptr)	{
@@ -1329,6 +1696,10 @@ void ISFScene::_render(const GLBufferRef & inTargetBuffer, const VVGL::Size & in
 		//	increment the rendered frame index!
 		++_renderFrameIndex;
 		
+		//	the uniform counts for this frame are done
+		_lastFrameUniformStats = _uniformStats;
+		_uniformStats = UniformStats();
+		
 		//	if there's a pass dict...
 		if (outPassDict != nullptr)	{
 			//	add the buffer i rendered into (this is the "output" buffer, and is stored at key "-1")
@@ -0,0 +1,81 @@
+#include <QGuiApplication>
+#include <VVGL.hpp>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+
+using namespace std;
+using namespace VVGL;
+
+
+#if defined(Q_OS_WIN)
+extern "C"
+{
+	__declspec(dllexport) uint32_t NvOptimusEnablement = 0x00000001;
+	__declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
+}
+#endif
+
+
+
+
+//	fills the pool with 'inCount' idle CPU buffers, every one of which has a different size/format (so none of them can be recycled for one another)
+void PopulatePool(const GLBufferPoolRef & inPool, const int & inCount)	{
+	vector<GLBufferRef>		tmpBuffers;
+	tmpBuffers.reserve(inCount);
+	for (int i=0; i<inCount; ++i)	{
+		Size			tmpSize(1 + (i/2)%64, 1 + (i/2)/64);
+		if (i % 2 == 0)
+			tmpBuffers.push_back(CreateRGBACPUBuffer(tmpSize, inPool));
+		else
+			tmpBuffers.push_back(CreateRGBAFloatCPUBuffer(tmpSize, inPool));
+	}
+	//	...the buffers are returned to the pool when 'tmpBuffers' goes out of scope
+}
+
+
+int main(int argc, char *argv[])
+{
+	QGuiApplication		a(argc, argv);
+	
+	//	make the shared context and the global buffer pool
+	GLContextRef		sharedContext = CreateNewGLContextRef(nullptr, nullptr, CreateDefaultSurfaceFormat());
+	if (sharedContext == nullptr)	{
+		cout << "ERR: shared context NULL" << endl;
+		return 1;
+	}
+	GLBufferPoolRef		bp = CreateGlobalBufferPool(sharedContext);
+	
+	const int			fetchCount = 200000;
+	const int			occupancies[] = { 16, 64, 256, 1024, 4096 };
+	
+	cout << "renderer is " << sharedContext->getRenderer() << endl;
+	cout << "idle buffers\tns per fetch\thit rate" << endl;
+	for (const int & occupancy : occupancies)	{
+		bp->purge();
+		PopulatePool(bp, occupancy);
+		
+		//	the buffer we fetch is one of the last buffers that went into the pool- the worst case for a linear scan
+		Size				fetchSize(1 + ((occupancy-1)/2)%64, 1 + ((occupancy-1)/2)/64);
+		bp->snapshotAndResetStats();
+		Timestamp			startTime;
+		for (int i=0; i<fetchCount; ++i)	{
+			//	the buffer is returned to the pool as soon as it goes out of scope
+			GLBufferRef			tmpBuffer = CreateRGBACPUBuffer(fetchSize, bp);
+		}
+		Timestamp			endTime;
+		
+		double				nsPerFetch = (endTime - startTime).getTimeInSeconds() * 1000000000. / double(fetchCount);
+		GLBufferPool::Stats		stats = bp->snapshotAndResetStats();
+		double				hitRate = double(stats.fetchHits) / double(max(stats.fetchHits + stats.fetchMisses, uint64_t(1)));
+		cout << occupancy << "\t\t" << FmtString("%0.1f", nsPerFetch) << "\t\t" << FmtString("%0.3f", hitRate) << endl;
+	}
+	
+	bp->purge();
+	cout << bp->stats() << endl;
+	SetGlobalBufferPool();
+	
+	return 0;
+}
@@ -193,11 +193,13 @@ HEADERS += \
 
 
 # platform-specific classes
-unix {
+unix:!mac {
     SOURCES += VideoSource/InterAppVideoSource_Lin.cpp \
-        VideoOutput/InterAppOutput_Lin.cpp
+        VideoOutput/InterAppOutput_Lin.cpp \
+        misc_classes/InterAppShm_Lin.cpp
     HEADERS += VideoSource/InterAppVideoSource_Lin.h \
-        VideoOutput/InterAppOutput_Lin.h
+        VideoOutput/InterAppOutput_Lin.h \
+        misc_classes/InterAppShm_Lin.h
 }
 mac {
 	SOURCES += ../../common/SyphonVVBufferPoolAdditions.mm \
@@ -303,7 +305,7 @@ win32 {
 } else:mac {
 	LIBS += -framework Security -framework CoreVideo
 } else:unix {
-	LIBS += -lutil
+	LIBS += -lutil -lrt
 }
 
 HEADERS += \
@@ -2,23 +2,215 @@
 
 #include <QDebug>
 
+#include <ctime>
+#include <unistd.h>
+
 #include "VVGL.hpp"
+#include "InterAppShm_Lin.h"
+
+
 
+
+using namespace std;
 using namespace VVGL;
 
-class InterAppOutput_LinOpaque{};
-
-InterAppOutput_Lin::InterAppOutput_Lin(QObject *parent) : VideoOutput(parent) {}
-InterAppOutput_Lin::~InterAppOutput_Lin(){}
-	
-void InterAppOutput_Lin::publishBuffer(const VVGL::GLBufferRef & inBuffer){
-    if (inBuffer == nullptr)
-        return;
-    if (opaque == nullptr) {
-        qDebug() << "unimplemented " << __PRETTY_FUNCTION__;
-        return;
-    }
+
+
+
+//	the number of frames in the shared memory segment: one for the most recent frame, one for a receiver that's still reading an older frame, and the rest are in flight
+#define SLOT_COUNT 4
+
+
+
+
+class InterAppOutput_LinOpaque	{
+public:
+	InterAppOutput_LinOpaque()	{
+		GLBufferPoolRef		bp = GetGlobalBufferPool();
+		if (bp != nullptr)	{
+			ctx = bp->context()->newContextSharingMe();
+			if (ctx != nullptr)	{
+				downloader = CreateGLTexToCPUCopierRefUsing(ctx);
+				//	every download in flight is being written into a slot- leave the rest for receivers
+				downloader->setMaxFencedQueueDepth(SLOT_COUNT - 2);
+			}
+		}
+		//	the pid keeps several instances of the editor from publishing to the same segment
+		serverName = QString("ISF Editor (%1)").arg(getpid()).toStdString();
+	}
+	~InterAppOutput_LinOpaque()	{
+		//	downloads that are still in flight are abandoned (and never written to the segment)- free the downloader first
+		downloader = nullptr;
+		segment = nullptr;
+	}
+	void moveGLToThread(const QThread * n)	{
+		if (n!=nullptr && ctx!=nullptr)
+			ctx->moveToThread(const_cast<QThread*>(n));
+	}
+
+	//	starts downloading the passed texture into a free slot of the shared memory segment- the frame is published when the download completes
+	void publishBuffer(const GLBufferRef & inBuffer);
+
+	GLContextRef			ctx = nullptr;
+	GLTexToCPUCopierRef		downloader = nullptr;
+	string					serverName;
+	shared_ptr<InterAppShmSegment>		segment = nullptr;
+	bool					slotInFlight[SLOT_COUNT] = { false };	//	true while a download is being written into the slot
+	uint32_t				nextSlot = 0;
+	uint64_t				frameIndex = 0;
+
+private:
+	//	executed by the downloader (on the thread that publishes buffers) when a download has been written into its slot
+	void _publishSlot(const uint32_t & inSlotIndex, const GLBufferRef & inCPUBuffer);
+};
+
+
+
+
+void InterAppOutput_LinOpaque::publishBuffer(const GLBufferRef & inBuffer)	{
+	if (inBuffer==nullptr || downloader==nullptr)
+		return;
+
+	//	8-bit textures are published in their own byte order (the readback is a straight copy), everything else is converted to RGBA8 as it's read back
+	bool			bgra = (inBuffer->desc.pixelFormat==GLBuffer::PF_BGRA && inBuffer->desc.pixelType!=GLBuffer::PT_Float && inBuffer->desc.pixelType!=GLBuffer::PT_HalfFloat);
+	Size			frameSize = inBuffer->size;
+	size_t			frameBytes = static_cast<size_t>(frameSize.width) * static_cast<size_t>(frameSize.height) * 4;
+	if (frameBytes < 1)
+		return;
+
+	//	if the frame doesn't fit in the segment's slots, replace the segment (receivers notice the old one is dead and reopen it)
+	if (segment==nullptr || segment->header()->slotSize < frameBytes)	{
+		downloader->finishFencedStream();
+		segment = nullptr;
+		for (bool & inFlight : slotInFlight)
+			inFlight = false;
+		segment = InterAppShmSegment::Create(serverName, SLOT_COUNT, frameBytes);
+		if (segment == nullptr)
+			return;
+	}
+
+	//	pick a slot that isn't being written, isn't being read, and doesn't hold the most recent frame (receivers may be about to read it)
+	InterAppShmHeader		*header = segment->header();
+	int32_t			latestSlot = header->latestSlot.load();
+	int				slotIndex = -1;
+	for (uint32_t i=0; i<SLOT_COUNT; ++i)	{
+		uint32_t		tmpIndex = (nextSlot + i) % SLOT_COUNT;
+		if (slotInFlight[tmpIndex] || static_cast<int32_t>(tmpIndex)==latestSlot || header->slotInfo[tmpIndex].readers.load()!=0)
+			continue;
+		//	the sequence is odd while the slot is being written- a receiver that starts reading it now will see that and skip it
+		header->slotInfo[tmpIndex].sequence.fetch_add(1);
+		//	...but a receiver may have started reading before the sequence changed, so check again
+		if (header->slotInfo[tmpIndex].readers.load() != 0)	{
+			header->slotInfo[tmpIndex].sequence.fetch_add(1);
+			continue;
+		}
+		slotIndex = static_cast<int>(tmpIndex);
+		break;
+	}
+	//	every slot is busy- drop the frame rather than stall the render thread (receivers can see how many frames were dropped)
+	if (slotIndex < 0)	{
+		header->droppedFrameCount.fetch_add(1);
+		downloader->pollFencedStream();
+		return;
+	}
+	nextSlot = (static_cast<uint32_t>(slotIndex) + 1) % SLOT_COUNT;
+	slotInFlight[slotIndex] = true;
+
+	//	the readback is written straight into the shared memory slot
+	void			*slotPtr = segment->slotPixels(static_cast<uint32_t>(slotIndex));
+	GLBufferRef		cpuBuffer = (bgra)
+		? CreateBGRACPUBufferUsing(frameSize, slotPtr, frameSize, nullptr, nullptr)
+		: CreateRGBACPUBufferUsing(frameSize, slotPtr, frameSize, nullptr, nullptr);
+	cpuBuffer->srcRect = inBuffer->srcRect;
+	shared_ptr<InterAppShmSegment>		downloadSegment = segment;
+	uint32_t		downloadSlot = static_cast<uint32_t>(slotIndex);
+	bool			started = downloader->fencedStreamTexToCPU(inBuffer, [this,downloadSegment,downloadSlot](const GLBufferRef & inCPUBuffer, const GLBufferRef & /*inTexBuffer*/)	{
+		//	the segment may have been replaced while this download was in flight
+		if (downloadSegment != segment)
+			return;
+		_publishSlot(downloadSlot, inCPUBuffer);
+	}, cpuBuffer);
+	//	if the download couldn't be started its callback will never run- give the slot back (making its sequence even again) and count the frame as dropped
+	if (!started)	{
+		slotInFlight[slotIndex] = false;
+		header->slotInfo[slotIndex].sequence.fetch_add(1);
+		header->droppedFrameCount.fetch_add(1);
+	}
+}
+void InterAppOutput_LinOpaque::_publishSlot(const uint32_t & inSlotIndex, const GLBufferRef & inCPUBuffer)	{
+	slotInFlight[inSlotIndex] = false;
+	if (segment == nullptr)
+		return;
+
+	InterAppShmHeader		*header = segment->header();
+	InterAppShmSlot		*slot = segment->slot(inSlotIndex);
+	if (slot == nullptr)
+		return;
+	//	nothing was downloaded- make the slot's sequence even again without publishing it
+	if (inCPUBuffer == nullptr)	{
+		slot->sequence.fetch_add(1);
+		return;
+	}
+
+	struct timespec		now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	//	the slot's sequence is still odd, so receivers ignore it while we fill in its description
+	slot->frameIndex.store(frameIndex++, memory_order_relaxed);
+	slot->timestamp.store(static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec), memory_order_relaxed);
+	slot->width.store(static_cast<uint32_t>(inCPUBuffer->size.width), memory_order_relaxed);
+	slot->height.store(static_cast<uint32_t>(inCPUBuffer->size.height), memory_order_relaxed);
+	slot->bytesPerRow.store(static_cast<uint32_t>(inCPUBuffer->desc.bytesPerRowForWidth(static_cast<uint32_t>(inCPUBuffer->size.width))), memory_order_relaxed);
+	slot->pixelLayout.store(static_cast<uint32_t>(PixelLayoutForDescriptor(inCPUBuffer->desc)), memory_order_relaxed);
+	slot->flipped.store((inCPUBuffer->flipped) ? 1 : 0, memory_order_relaxed);
+	slot->srcRectX.store(static_cast<uint32_t>(inCPUBuffer->srcRect.origin.x), memory_order_relaxed);
+	slot->srcRectY.store(static_cast<uint32_t>(inCPUBuffer->srcRect.origin.y), memory_order_relaxed);
+	slot->srcRectWidth.store(static_cast<uint32_t>(inCPUBuffer->srcRect.size.width), memory_order_relaxed);
+	slot->srcRectHeight.store(static_cast<uint32_t>(inCPUBuffer->srcRect.size.height), memory_order_relaxed);
+
+	//	make the sequence even (publishing the slot's pixels and description), point receivers at the slot, and wake them
+	slot->sequence.fetch_add(1, memory_order_release);
+	header->latestSlot.store(static_cast<int32_t>(inSlotIndex));
+	header->frameCounter.fetch_add(1);
+	segment->wakeReceivers();
 }
-void InterAppOutput_Lin::moveGLToThread(const QThread * n) {}
 
 
+
+
+
+
+
+
+InterAppOutput_Lin::InterAppOutput_Lin(QObject *parent) :
+	VideoOutput(parent)
+{
+	opaque = new InterAppOutput_LinOpaque();
+}
+InterAppOutput_Lin::~InterAppOutput_Lin()	{
+	if (opaque != nullptr)	{
+		delete opaque;
+		opaque = nullptr;
+	}
+}
+
+
+void InterAppOutput_Lin::publishBuffer(const GLBufferRef & inBuffer)	{
+	if (inBuffer == nullptr)
+		return;
+	if (opaque == nullptr)	{
+		opaque = new InterAppOutput_LinOpaque();
+	}
+
+	if (opaque==nullptr || opaque->ctx==nullptr)	{
+		qDebug() << "err: bailing, opaque is null, " << __PRETTY_FUNCTION__;
+		return;
+	}
+
+	opaque->publishBuffer(inBuffer);
+}
+
+void InterAppOutput_Lin::moveGLToThread(const QThread * n)	{
+	if (opaque != nullptr)
+		opaque->moveGLToThread(n);
+}
@@ -21,5 +21,5 @@ public:
 	virtual void moveGLToThread(const QThread * n) override;
 
 private:
-	InterAppOutput_LinOpaque		*opaque = nullptr;	//	used to store objective-c stuff
+	InterAppOutput_LinOpaque		*opaque = nullptr;	//	used to store the shared memory segment and the GL stuff that downloads frames into it
 };
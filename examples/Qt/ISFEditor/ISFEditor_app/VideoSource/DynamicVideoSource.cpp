@@ -98,7 +98,7 @@ GLBufferRef DynamicVideoSource::getBuffer()	{
 #endif
 	
 	//	these source types have to be told to render a buffer!
-#if defined(Q_OS_WIN)
+#if defined(Q_OS_WIN) || defined(Q_OS_LINUX)
 	case MediaFile::Type_App:
 		appSrc.renderABuffer();
 		return lastBuffer;
@@ -1,41 +1,283 @@
-// dummy implementation because no syphon nor spout
 #include "InterAppVideoSource_Lin.h"
+
+#include <QDebug>
+#include <QFileSystemWatcher>
+
+#include <chrono>
+#include <ctime>
+
 #include "VVGL.hpp"
+#include "InterAppShm_Lin.h"
+#include "ISFController.h"
+
 
+
+
+using namespace std;
 using namespace VVGL;
 
-class InterAppVideoSource_LinOpaque{};
 
-InterAppVideoSource_Lin::InterAppVideoSource_Lin(QObject *parent) : VideoSource(parent) {}
 
-InterAppVideoSource_Lin::~InterAppVideoSource_Lin(){
-    stop();
+
+//	how often (in seconds) we try to reopen a publisher's segment if it isn't available
+#define REOPEN_INTERVAL 0.25
+
+
+
+
+class InterAppVideoSource_LinOpaque	{
+public:
+	InterAppVideoSource_LinOpaque(const MediaFile & inTargetFile)	{
+		serverName = inTargetFile.name().toStdString();
+	}
+	~InterAppVideoSource_LinOpaque()	{
+		//	the uploader's queue may still hold a CPU buffer that points into the segment- it keeps the segment mapped until it's freed
+		uploader = nullptr;
+		segment = nullptr;
+	}
+
+	//	uploads the newest frame in the segment (if there's a new one) and returns the texture of the frame uploaded by the previous call (uploads are double-buffered)
+	GLBufferRef receiveFrame(const GLBufferPoolRef & inPool);
+
+	//	the description of a frame whose upload was started but hasn't been returned yet
+	struct PendingFrame	{
+		bool			valid = false;
+		VVGL::Rect		srcRect;
+		bool			flipped = false;
+		uint64_t		timestamp = 0;	//	CLOCK_MONOTONIC, in nanoseconds
+	};
+
+	string					serverName;
+	shared_ptr<InterAppShmSegment>		segment = nullptr;
+	chrono::steady_clock::time_point	lastOpenAttempt;
+	GLCPUToTexCopierRef		uploader = nullptr;
+	PendingFrame			pendingFrame;
+	bool					receivedAFrame = false;	//	false until a frame has been received from the current segment
+	uint64_t				lastFrameIndex = 0;
+	uint64_t				receivedFrameCount = 0;
+	uint64_t				skippedFrameCount = 0;
+	uint64_t				publisherDroppedFrameCount = 0;
+	double					frameAge = 0.;
+	double					averageFrameAge = 0.;
+
+private:
+	//	returns false if the segment isn't available
+	bool _openSegmentIfNecessary();
+};
+
+
+
+
+bool InterAppVideoSource_LinOpaque::_openSegmentIfNecessary()	{
+	if (segment!=nullptr && segment->publisherAlive())
+		return true;
+	//	the publisher stopped, or replaced its segment with a bigger one- try to open it again (but not on every frame)
+	segment = nullptr;
+	chrono::steady_clock::time_point		now = chrono::steady_clock::now();
+	if (chrono::duration<double>(now - lastOpenAttempt).count() < REOPEN_INTERVAL)
+		return false;
+	lastOpenAttempt = now;
+	segment = InterAppShmSegment::Open(serverName);
+	if (segment==nullptr || !segment->publisherAlive())	{
+		segment = nullptr;
+		return false;
+	}
+	receivedAFrame = false;
+	return true;
+}
+GLBufferRef InterAppVideoSource_LinOpaque::receiveFrame(const GLBufferPoolRef & inPool)	{
+	if (inPool == nullptr || !_openSegmentIfNecessary())
+		return nullptr;
+
+	if (uploader == nullptr)	{
+		uploader = CreateGLCPUToTexCopierRefUsing(inPool->context());
+		uploader->setPrivatePool(inPool);
+		//	double-buffered: the texture for a frame is returned by the next call
+		uploader->setQueueSize(1);
+	}
+
+	InterAppShmHeader		*header = segment->header();
+	publisherDroppedFrameCount = header->droppedFrameCount.load();
+
+	//	lock the slot with the newest frame- if it's the frame we received last time, there's nothing to do
+	int32_t			slotIndex = segment->lockLatestSlot();
+	if (slotIndex < 0)
+		return nullptr;
+	InterAppShmSlot		*slot = segment->slot(static_cast<uint32_t>(slotIndex));
+	uint64_t		frameIndex = slot->frameIndex.load(memory_order_relaxed);
+	if (receivedAFrame && frameIndex==lastFrameIndex)	{
+		segment->unlockSlot(static_cast<uint32_t>(slotIndex));
+		return nullptr;
+	}
+
+	uint32_t		width = slot->width.load(memory_order_relaxed);
+	uint32_t		height = slot->height.load(memory_order_relaxed);
+	uint32_t		bytesPerRow = slot->bytesPerRow.load(memory_order_relaxed);
+	PixelLayout		layout = static_cast<PixelLayout>(slot->pixelLayout.load(memory_order_relaxed));
+	if (width<1 || height<1 || bytesPerRow!=width*4 || static_cast<uint64_t>(bytesPerRow)*height>header->slotSize || (layout!=PixelLayout_RGBA8 && layout!=PixelLayout_BGRA8))	{
+		qDebug() << "ERR: slot has unexpected format, " << __PRETTY_FUNCTION__;
+		segment->unlockSlot(static_cast<uint32_t>(slotIndex));
+		return nullptr;
+	}
+
+	//	frames that were published since the last frame we received were never uploaded- they're dropped, not queued
+	if (receivedAFrame && frameIndex>lastFrameIndex)
+		skippedFrameCount += frameIndex - lastFrameIndex - 1;
+	receivedAFrame = true;
+	lastFrameIndex = frameIndex;
+	++receivedFrameCount;
+
+	PendingFrame		newFrame;
+	newFrame.valid = true;
+	newFrame.srcRect = VVGL::Rect(slot->srcRectX.load(memory_order_relaxed), slot->srcRectY.load(memory_order_relaxed), slot->srcRectWidth.load(memory_order_relaxed), slot->srcRectHeight.load(memory_order_relaxed));
+	newFrame.flipped = (slot->flipped.load(memory_order_relaxed) != 0);
+	newFrame.timestamp = slot->timestamp.load(memory_order_relaxed);
+
+	//	wrap the slot in a CPU buffer and start uploading it- the pixels are copied into a PBO before this returns, so the slot
+	//	can be unlocked right away.  the buffer's release callback holds onto the segment so its memory stays mapped while the
+	//	buffer exists.
+	shared_ptr<InterAppShmSegment>		bufferSegment = segment;
+	GLBuffer::BackingReleaseCallback	releaseCallback = [bufferSegment](GLBuffer & /*inBuffer*/, void * /*inReleaseContext*/)	{};
+	Size			frameSize(width, height);
+	void			*slotPtr = segment->slotPixels(static_cast<uint32_t>(slotIndex));
+	GLBufferRef		cpuBuffer = (layout==PixelLayout_BGRA8)
+		? CreateBGRACPUBufferUsing(frameSize, slotPtr, frameSize, nullptr, releaseCallback, inPool)
+		: CreateRGBACPUBufferUsing(frameSize, slotPtr, frameSize, nullptr, releaseCallback, inPool);
+	GLBufferRef		returnMe = uploader->streamCPUToTex(cpuBuffer);
+	segment->unlockSlot(static_cast<uint32_t>(slotIndex));
+
+	//	the texture we got back is the frame we started uploading last time
+	PendingFrame		returnedFrame = pendingFrame;
+	pendingFrame = newFrame;
+	if (returnMe == nullptr || !returnedFrame.valid)
+		return nullptr;
+	returnMe->srcRect = returnedFrame.srcRect;
+	returnMe->flipped = returnedFrame.flipped;
+
+	struct timespec		now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	uint64_t		nowNanos = static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+	frameAge = (nowNanos > returnedFrame.timestamp) ? static_cast<double>(nowNanos - returnedFrame.timestamp) / 1000000000. : 0.;
+	averageFrameAge = (averageFrameAge <= 0.) ? frameAge : (averageFrameAge * 0.9) + (frameAge * 0.1);
+
+	return returnMe;
+}
+
+
+
+
+
+
+
+
+InterAppVideoSource_Lin::InterAppVideoSource_Lin(QObject *parent) : VideoSource(parent)	{
+	//	publishers create and remove segments in /dev/shm- we want to emit a signal every time the list of publishers changes
+	for (const string & tmpName : InterAppShmSegment::ListServerNames())
+		serverNames.append(QString::fromStdString(tmpName));
+	serverNames.sort();
+	shmWatcher = new QFileSystemWatcher(QStringList("/dev/shm"), this);
+	QObject::connect(shmWatcher, &QFileSystemWatcher::directoryChanged, [&](const QString & /*inPath*/)	{
+		QStringList		newServerNames;
+		for (const string & tmpName : InterAppShmSegment::ListServerNames())
+			newServerNames.append(QString::fromStdString(tmpName));
+		newServerNames.sort();
+		if (newServerNames == serverNames)
+			return;
+		serverNames = newServerNames;
+		emit staticSourceUpdated(this);
+	});
 }
+InterAppVideoSource_Lin::~InterAppVideoSource_Lin()	{
+	stop();
+}
+
+
+
+
+QList<MediaFile> InterAppVideoSource_Lin::createListOfStaticMediaFiles()	{
+	QList<MediaFile>		returnMe;
+	for (const string & tmpName : InterAppShmSegment::ListServerNames())	{
+		QString			tmpString = QString::fromStdString(tmpName);
+		returnMe.append( MediaFile(MediaFile::Type_App, tmpString, tmpString) );
+	}
+	return returnMe;
+}
+void InterAppVideoSource_Lin::start()	{
+	std::lock_guard<std::recursive_mutex> tmpLock(_lock);
+	if (_running)
+		return;
+
+	if (_file.type() != MediaFile::Type_App)
+		return;
+
+	_running = true;
 
-void InterAppVideoSource_Lin::stop(){ VideoSource::stop(); }
-void InterAppVideoSource_Lin::start(){
-    std::lock_guard<std::recursive_mutex> tmpLock(_lock);
-    if (_running)
-        return;
-    if (_file.type() != MediaFile::Type_App)
-        return;
-    _running = true;
+	if (opaque != nullptr)	{
+		delete opaque;
+		opaque = nullptr;
+	}
+	opaque = new InterAppVideoSource_LinOpaque(_file);
 }
-void InterAppVideoSource_Lin::loadFile(const MediaFile & n){
-    std::lock_guard<std::recursive_mutex> tmpLock(_lock);
-    if (_file == n)
-        return;
-    stop();
-    _file = n;
-    start();
+void InterAppVideoSource_Lin::stop()	{
+	std::lock_guard<std::recursive_mutex> tmpLock(_lock);
+	VideoSource::stop();
+	if (opaque != nullptr)	{
+		delete opaque;
+		opaque = nullptr;
+	}
 }
-bool InterAppVideoSource_Lin::playingBackItem(const MediaFile & n){
-    return (_file == n);
+bool InterAppVideoSource_Lin::playingBackItem(const MediaFile & n)	{
+	return (_file == n);
 }
+void InterAppVideoSource_Lin::loadFile(const MediaFile & n)	{
+	std::lock_guard<std::recursive_mutex> tmpLock(_lock);
+	if (_file == n)
+		return;
 
-QList<MediaFile> InterAppVideoSource_Lin::createListOfStaticMediaFiles(){
-    QList<MediaFile> result;
-    return result;
+	stop();
+	_file = n;
+	start();
 }
 
 
+
+
+void InterAppVideoSource_Lin::renderABuffer()	{
+	if (_file.type() != MediaFile::Type_App)
+		return;
+
+	std::lock_guard<std::recursive_mutex> tmpLock(_lock);
+
+	if (opaque == nullptr)
+		return;
+
+	ISFController		*isfc = GetISFController();
+	GLBufferPoolRef		bp = (isfc==nullptr) ? nullptr : isfc->renderThreadBufferPool();
+	GLBufferRef			newBuffer = opaque->receiveFrame(bp);
+	if (newBuffer != nullptr)
+		emit frameProduced(newBuffer);
+}
+
+
+
+
+uint64_t InterAppVideoSource_Lin::receivedFrameCount()	{
+	std::lock_guard<std::recursive_mutex> tmpLock(_lock);
+	return (opaque==nullptr) ? 0 : opaque->receivedFrameCount;
+}
+uint64_t InterAppVideoSource_Lin::skippedFrameCount()	{
+	std::lock_guard<std::recursive_mutex> tmpLock(_lock);
+	return (opaque==nullptr) ? 0 : opaque->skippedFrameCount;
+}
+uint64_t InterAppVideoSource_Lin::publisherDroppedFrameCount()	{
+	std::lock_guard<std::recursive_mutex> tmpLock(_lock);
+	return (opaque==nullptr) ? 0 : opaque->publisherDroppedFrameCount;
+}
+double InterAppVideoSource_Lin::frameAge()	{
+	std::lock_guard<std::recursive_mutex> tmpLock(_lock);
+	return (opaque==nullptr) ? 0. : opaque->frameAge;
+}
+double InterAppVideoSource_Lin::averageFrameAge()	{
+	std::lock_guard<std::recursive_mutex> tmpLock(_lock);
+	return (opaque==nullptr) ? 0. : opaque->averageFrameAge;
+}
@@ -1,23 +1,46 @@
 #pragma once
 
 #include <QObject>
+#include <QStringList>
+
 #include "VideoSource.h"
 
 class InterAppVideoSource_LinOpaque;
+class QFileSystemWatcher;
+
+
 
+
+//	receives frames published over shared memory by another process's InterAppOutput_Lin
 class InterAppVideoSource_Lin : public VideoSource
 {
-    Q_OBJECT
+	Q_OBJECT
 public:
-    InterAppVideoSource_Lin(QObject *parent = nullptr);
-    ~InterAppVideoSource_Lin();
+	InterAppVideoSource_Lin(QObject *parent = nullptr);
+	~InterAppVideoSource_Lin();
+
+	virtual QList<MediaFile> createListOfStaticMediaFiles() override;
+	virtual void start() override;
+	virtual void stop() override;
+	virtual bool playingBackItem(const MediaFile & n) override;
+	virtual void loadFile(const MediaFile & n) override;
+
+	//	uploads the newest frame the publisher has published (if it's new) and emits the texture- older frames that were never uploaded are dropped
+	virtual void renderABuffer() override;
 
-    virtual QList<MediaFile> createListOfStaticMediaFiles() override;
-    virtual void start() override;
-    virtual void stop() override;
-    virtual bool playingBackItem(const MediaFile & n) override;
-    virtual void loadFile(const MediaFile & n) override;
+	//	the number of frames that have been received since the source was started
+	uint64_t receivedFrameCount();
+	//	the number of frames published since the source was started that were replaced by a newer frame before they could be received
+	uint64_t skippedFrameCount();
+	//	the number of frames the current publisher dropped because none of its slots were free (ie, receivers were too slow)
+	uint64_t publisherDroppedFrameCount();
+	//	the time (in seconds) between the publisher publishing the most recent frame and this emitting it
+	double frameAge();
+	//	a moving average of frameAge()
+	double averageFrameAge();
 
 private:
-    InterAppVideoSource_LinOpaque *opaque = nullptr;
+	InterAppVideoSource_LinOpaque		*opaque = nullptr;	//	used to store the shared memory segment and the GL stuff that uploads frames from it
+	QFileSystemWatcher		*shmWatcher = nullptr;	//	watches /dev/shm so we know when publishers appear or disappear
+	QStringList				serverNames;	//	the servers that were publishing the last time the watcher fired
 };
@@ -0,0 +1,242 @@
+#include "InterAppShm_Lin.h"
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <climits>
+
+#include <fcntl.h>
+#include <dirent.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include <QDebug>
+
+
+
+
+using namespace std;
+
+
+
+
+namespace	{
+
+size_t RoundUpToPage(const size_t & n)	{
+	size_t		pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	return ((n + pageSize - 1) / pageSize) * pageSize;
+}
+
+//	returns true if a process with the passed pid exists
+bool ProcessExists(const int32_t & inPID)	{
+	if (inPID <= 0)
+		return false;
+	return (kill(static_cast<pid_t>(inPID), 0)==0 || errno==EPERM);
+}
+
+//	the futex ops aren't private- the futex is shared by several processes
+long Futex(std::atomic<uint32_t> * inAddr, const int & inOp, const uint32_t & inVal, const struct timespec * inTimeout)	{
+	return syscall(SYS_futex, reinterpret_cast<uint32_t*>(inAddr), inOp, inVal, inTimeout, nullptr, 0);
+}
+
+}
+
+
+
+
+shared_ptr<InterAppShmSegment> InterAppShmSegment::Create(const string & inServerName, const uint32_t & inSlotCount, const size_t & inSlotSize)	{
+	if (inSlotCount < 1 || inSlotCount > INTERAPPSHM_MAX_SLOTS || inSlotSize < 1)
+		return nullptr;
+
+	shared_ptr<InterAppShmSegment>		returnMe = shared_ptr<InterAppShmSegment>(new InterAppShmSegment());
+	returnMe->_shmName = ShmNameForServerName(inServerName);
+	returnMe->_owner = true;
+
+	size_t		slotSize = RoundUpToPage(inSlotSize);
+	size_t		slotOffset = RoundUpToPage(sizeof(InterAppShmHeader));
+	returnMe->_length = slotOffset + (slotSize * inSlotCount);
+
+	//	a segment with this name was left behind by a process that died- replace it
+	shm_unlink(returnMe->_shmName.c_str());
+	int			fd = shm_open(returnMe->_shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+	if (fd < 0)	{
+		qDebug() << "ERR: couldn't create shm segment (" << strerror(errno) << "), " << __PRETTY_FUNCTION__;
+		return nullptr;
+	}
+	//	the pages are zero-filled and only backed by memory once they're written
+	if (ftruncate(fd, static_cast<off_t>(returnMe->_length)) != 0)	{
+		qDebug() << "ERR: couldn't size shm segment (" << strerror(errno) << "), " << __PRETTY_FUNCTION__;
+		close(fd);
+		shm_unlink(returnMe->_shmName.c_str());
+		return nullptr;
+	}
+	returnMe->_base = mmap(nullptr, returnMe->_length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	//	the mapping stays valid after the descriptor is closed
+	close(fd);
+	if (returnMe->_base == MAP_FAILED)	{
+		qDebug() << "ERR: couldn't map shm segment (" << strerror(errno) << "), " << __PRETTY_FUNCTION__;
+		returnMe->_base = nullptr;
+		shm_unlink(returnMe->_shmName.c_str());
+		return nullptr;
+	}
+
+	//	the segment was zero-filled, so all that's left is the header- the magic is written last
+	InterAppShmHeader		*header = returnMe->header();
+	header->version = INTERAPPSHM_VERSION;
+	header->publisherPID = static_cast<int32_t>(getpid());
+	header->slotCount = inSlotCount;
+	header->slotOffset = slotOffset;
+	header->slotSize = slotSize;
+	strncpy(header->serverName, inServerName.c_str(), INTERAPPSHM_MAX_NAME_LENGTH - 1);
+	header->latestSlot.store(-1);
+	header->alive.store(1);
+	header->magic.store(INTERAPPSHM_MAGIC, memory_order_release);
+
+	return returnMe;
+}
+shared_ptr<InterAppShmSegment> InterAppShmSegment::Open(const string & inServerName)	{
+	string		shmName = ShmNameForServerName(inServerName);
+	int			fd = shm_open(shmName.c_str(), O_RDWR, 0);
+	if (fd < 0)
+		return nullptr;
+	struct stat		fileInfo;
+	if (fstat(fd, &fileInfo)!=0 || static_cast<size_t>(fileInfo.st_size) < sizeof(InterAppShmHeader))	{
+		close(fd);
+		return nullptr;
+	}
+
+	shared_ptr<InterAppShmSegment>		returnMe = shared_ptr<InterAppShmSegment>(new InterAppShmSegment());
+	returnMe->_shmName = shmName;
+	returnMe->_length = static_cast<size_t>(fileInfo.st_size);
+	returnMe->_base = mmap(nullptr, returnMe->_length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (returnMe->_base == MAP_FAILED)	{
+		returnMe->_base = nullptr;
+		return nullptr;
+	}
+
+	//	the publisher may not have finished writing the header yet- or it may have been written by an incompatible version
+	InterAppShmHeader		*header = returnMe->header();
+	if (header->magic.load(memory_order_acquire) != INTERAPPSHM_MAGIC
+	|| header->version != INTERAPPSHM_VERSION
+	|| header->slotCount < 1
+	|| header->slotCount > INTERAPPSHM_MAX_SLOTS
+	|| header->slotOffset + (header->slotSize * header->slotCount) > returnMe->_length)	{
+		return nullptr;
+	}
+
+	return returnMe;
+}
+vector<string> InterAppShmSegment::ListServerNames()	{
+	vector<string>		returnMe;
+	DIR					*dir = opendir("/dev/shm");
+	if (dir == nullptr)
+		return returnMe;
+	size_t				prefixLength = strlen(INTERAPPSHM_NAME_PREFIX);
+	struct dirent		*entry = nullptr;
+	while ((entry = readdir(dir)) != nullptr)	{
+		if (strncmp(entry->d_name, INTERAPPSHM_NAME_PREFIX, prefixLength) != 0)
+			continue;
+		string			serverName = string(entry->d_name + prefixLength);
+		shared_ptr<InterAppShmSegment>		segment = Open(serverName);
+		if (segment == nullptr)
+			continue;
+		InterAppShmHeader		*header = segment->header();
+		//	nobody else will clean up after a publisher that crashed
+		if (!ProcessExists(header->publisherPID))	{
+			shm_unlink(segment->shmName().c_str());
+			continue;
+		}
+		if (!segment->publisherAlive())
+			continue;
+		returnMe.push_back(serverName);
+	}
+	closedir(dir);
+	return returnMe;
+}
+string InterAppShmSegment::ShmNameForServerName(const string & inServerName)	{
+	//	shm names can't contain slashes (other than the leading one)
+	string		returnMe = string("/") + INTERAPPSHM_NAME_PREFIX + inServerName;
+	for (size_t i=1; i<returnMe.size(); ++i)	{
+		if (returnMe[i] == '/')
+			returnMe[i] = '_';
+	}
+	if (returnMe.size() > static_cast<size_t>(NAME_MAX))
+		returnMe.resize(static_cast<size_t>(NAME_MAX));
+	return returnMe;
+}
+InterAppShmSegment::~InterAppShmSegment()	{
+	if (_base == nullptr)
+		return;
+	if (_owner)	{
+		markDead();
+		shm_unlink(_shmName.c_str());
+	}
+	munmap(_base, _length);
+	_base = nullptr;
+}
+uint8_t * InterAppShmSegment::slotPixels(const uint32_t & n) const	{
+	InterAppShmHeader		*header = this->header();
+	if (header==nullptr || n >= header->slotCount)
+		return nullptr;
+	return static_cast<uint8_t*>(_base) + header->slotOffset + (header->slotSize * n);
+}
+void InterAppShmSegment::markDead()	{
+	InterAppShmHeader		*header = this->header();
+	if (header == nullptr)
+		return;
+	header->alive.store(0);
+	//	bump the frame counter too, so receivers waiting for a frame wake up and notice
+	header->frameCounter.fetch_add(1);
+	wakeReceivers();
+}
+bool InterAppShmSegment::publisherAlive() const	{
+	InterAppShmHeader		*header = this->header();
+	if (header == nullptr || header->alive.load() == 0)
+		return false;
+	return ProcessExists(header->publisherPID);
+}
+int32_t InterAppShmSegment::lockLatestSlot()	{
+	InterAppShmHeader		*header = this->header();
+	if (header == nullptr)
+		return -1;
+	int32_t				slotIndex = header->latestSlot.load();
+	if (slotIndex < 0 || slotIndex >= static_cast<int32_t>(header->slotCount))
+		return -1;
+	//	register as a reader first, then check the sequence- if it's odd the publisher is (or is about to start) writing the slot
+	InterAppShmSlot		&slot = header->slotInfo[slotIndex];
+	slot.readers.fetch_add(1);
+	if ((slot.sequence.load() & 1) != 0)	{
+		slot.readers.fetch_sub(1);
+		return -1;
+	}
+	return slotIndex;
+}
+void InterAppShmSegment::unlockSlot(const uint32_t & n)	{
+	InterAppShmSlot		*slot = this->slot(n);
+	if (slot != nullptr)
+		slot->readers.fetch_sub(1);
+}
+void InterAppShmSegment::wakeReceivers()	{
+	InterAppShmHeader		*header = this->header();
+	if (header == nullptr)
+		return;
+	Futex(&header->frameCounter, FUTEX_WAKE, INT_MAX, nullptr);
+}
+bool InterAppShmSegment::waitForFrame(const uint32_t & inLastFrameCounter, const int & inTimeoutMS)	{
+	InterAppShmHeader		*header = this->header();
+	if (header == nullptr)
+		return false;
+	if (header->frameCounter.load() != inLastFrameCounter)
+		return true;
+	struct timespec		timeout;
+	timeout.tv_sec = inTimeoutMS / 1000;
+	timeout.tv_nsec = static_cast<long>(inTimeoutMS % 1000) * 1000000L;
+	//	returns immediately if the counter has already changed, may also wake spuriously- either way, just check the counter
+	Futex(&header->frameCounter, FUTEX_WAIT, inLastFrameCounter, &timeout);
+	return (header->frameCounter.load() != inLastFrameCounter);
+}
@@ -0,0 +1,129 @@
+#ifndef INTERAPPSHM_LIN_H
+#define INTERAPPSHM_LIN_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+
+
+/*	these classes describe the POSIX shared memory segment the linux build of the ISF editor publishes frames through (and
+receives frames from).  a segment is a header followed by a fixed number of "slots", each of which holds one frame:
+
+	- the publisher picks a slot nobody is reading, increments the slot's 'sequence' (making it odd) while it writes the
+	  frame, and increments it again (making it even) when it's done.  then it stores the slot's index in 'latestSlot',
+	  increments 'frameCounter', and wakes any receivers waiting on 'frameCounter' (it's a futex).
+	- a receiver increments a slot's 'readers' while it reads from the slot, and then checks the slot's 'sequence'- if
+	  it's even, the publisher won't write to the slot until 'readers' drops back to zero.  the publisher checks 'readers'
+	  again after it makes 'sequence' odd (and backs out if it's non-zero), so there's no window where both think they
+	  own the slot.
+
+everything in the segment is either written before the 'magic' is set or is accessed atomically, so publishers and
+receivers never lock anything.  the publisher's pid is stored in the header so receivers can tell if it died.		*/
+
+
+
+
+//	the prefix of every segment's name (segments are listed in /dev/shm without the leading slash)
+#define INTERAPPSHM_NAME_PREFIX "vvisf-interapp."
+#define INTERAPPSHM_MAGIC 0x56564941
+#define INTERAPPSHM_VERSION 1
+#define INTERAPPSHM_MAX_SLOTS 8
+#define INTERAPPSHM_MAX_NAME_LENGTH 256
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "the shared memory segment requires lock-free atomic ints");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "the shared memory segment requires lock-free atomic long longs");
+
+
+
+
+struct InterAppShmSlot	{
+	std::atomic<uint32_t>	sequence;	//	odd while the publisher is writing the frame, even while the frame is stable
+	std::atomic<uint32_t>	readers;	//	the number of receivers currently reading the frame
+	std::atomic<uint64_t>	frameIndex;	//	increases by one every time the publisher publishes a frame
+	std::atomic<uint64_t>	timestamp;	//	CLOCK_MONOTONIC, in nanoseconds, when the frame was published
+	std::atomic<uint32_t>	width;	//	dimensions of the frame's pixels, in pixels
+	std::atomic<uint32_t>	height;
+	std::atomic<uint32_t>	bytesPerRow;
+	std::atomic<uint32_t>	pixelLayout;	//	a VVGL::PixelLayout value
+	std::atomic<uint32_t>	flipped;	//	non-zero if the image is upside-down (the first row is the bottom of the image)
+	std::atomic<uint32_t>	srcRectX;	//	the region of the frame that contains the image, in pixels
+	std::atomic<uint32_t>	srcRectY;
+	std::atomic<uint32_t>	srcRectWidth;
+	std::atomic<uint32_t>	srcRectHeight;
+};
+
+
+struct InterAppShmHeader	{
+	std::atomic<uint32_t>	magic;	//	INTERAPPSHM_MAGIC once the rest of the header has been written
+	uint32_t				version;	//	INTERAPPSHM_VERSION
+	int32_t					publisherPID;
+	uint32_t				slotCount;
+	uint64_t				slotOffset;	//	offset (in bytes, from the start of the segment) of the first slot's pixels
+	uint64_t				slotSize;	//	the max number of bytes of pixel data in each slot (slots are page-aligned)
+	char					serverName[INTERAPPSHM_MAX_NAME_LENGTH];	//	human-readable, null-terminated
+	std::atomic<uint32_t>	alive;	//	non-zero while the publisher is using this segment- it's zeroed when the publisher stops or replaces the segment
+	std::atomic<uint32_t>	frameCounter;	//	incremented every time a frame is published.  this is a futex- receivers wait on it.
+	std::atomic<int32_t>	latestSlot;	//	the index of the slot with the most recent frame, or -1 if nothing has been published yet
+	std::atomic<uint64_t>	droppedFrameCount;	//	the number of frames the publisher dropped because every slot was busy (or the download into a slot couldn't be started)
+	InterAppShmSlot			slotInfo[INTERAPPSHM_MAX_SLOTS];	//	describes the frame in each slot (not named "slots", which is a Qt macro)
+};
+
+
+
+
+//	a mapped shared memory segment
+class InterAppShmSegment	{
+public:
+	//	creates (and maps) a new segment for the server with the passed name, replacing any stale segment with the same name.  returns null if it couldn't be created.
+	static std::shared_ptr<InterAppShmSegment> Create(const std::string & inServerName, const uint32_t & inSlotCount, const size_t & inSlotSize);
+	//	opens (and maps) the segment of the server with the passed name.  returns null if it doesn't exist or isn't ready yet.
+	static std::shared_ptr<InterAppShmSegment> Open(const std::string & inServerName);
+	//	returns the names of the servers that are currently publishing.  segments left behind by processes that died are unlinked.
+	static std::vector<std::string> ListServerNames();
+	//	returns the name of the shared memory object used by the server with the passed name
+	static std::string ShmNameForServerName(const std::string & inServerName);
+
+	InterAppShmSegment(const InterAppShmSegment &) = delete;
+	InterAppShmSegment & operator=(const InterAppShmSegment &) = delete;
+	//	unmaps the segment- the segment's creator also marks it as dead and unlinks it
+	~InterAppShmSegment();
+
+	inline InterAppShmHeader * header() const { return static_cast<InterAppShmHeader*>(_base); }
+	inline InterAppShmSlot * slot(const uint32_t & n) const { return (n < header()->slotCount) ? &(header()->slotInfo[n]) : nullptr; }
+	//	returns a ptr to the pixel data of the slot at the passed index
+	uint8_t * slotPixels(const uint32_t & n) const;
+	inline const std::string & shmName() const { return _shmName; }
+
+	//	marks the segment as dead and wakes any receivers waiting on it (only the segment's creator should do this)
+	void markDead();
+	//	returns false if the publisher has stopped using the segment (or its process has died)
+	bool publisherAlive() const;
+
+	//	locks the slot with the most recent frame so the publisher won't write to it, and returns its index.  returns -1 if there isn't a frame, or it's being written.
+	int32_t lockLatestSlot();
+	//	unlocks a slot locked by lockLatestSlot()
+	void unlockSlot(const uint32_t & n);
+
+	//	wakes every process waiting for a new frame in this segment
+	void wakeReceivers();
+	//	blocks until 'frameCounter' differs from the passed value or the timeout (in milliseconds) elapses.  returns true if it changed.
+	bool waitForFrame(const uint32_t & inLastFrameCounter, const int & inTimeoutMS);
+
+private:
+	InterAppShmSegment() {}
+
+	std::string		_shmName;
+	void			*_base = nullptr;
+	size_t			_length = 0;
+	bool			_owner = false;	//	true if we created the segment (and should unlink it)
+};
+
+
+
+
+#endif // INTERAPPSHM_LIN_H
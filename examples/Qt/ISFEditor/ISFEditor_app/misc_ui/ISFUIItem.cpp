@@ -591,7 +591,7 @@ ISFVal ISFUIItem::getISFVal()	{
 		return ISFColorVal(color.redF(), color.greenF(), color.blueF(), color.alphaF());
 	case ISFValType_Image:
 		{
-#if defined(Q_OS_WIN)
+#if defined(Q_OS_WIN) || defined(Q_OS_LINUX)
 			interAppSrc->renderABuffer();
 #else
 #endif
@@ -0,0 +1,63 @@
+#-------------------------------------------------
+#
+# Console app that measures the throughput (GB/s) of the SIMD pixel
+# conversion kernels against their scalar fallbacks- no GL context is
+# needed, so it runs anywhere
+#
+#-------------------------------------------------
+
+QT       += gui opengl multimedia
+
+TARGET = PixelConversionBenchmark
+TEMPLATE = app
+
+CONFIG += c++14
+CONFIG += console
+CONFIG -= app_bundle
+
+# The following define makes your compiler emit warnings if you use
+# any feature of Qt which has been marked as deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+
+
+
+# these libs require an ISF_SDK define
+DEFINES += VVGL_SDK_QT
+
+
+
+
+SOURCES += \
+	main.cpp
+
+
+
+
+# additions for VVGL lib
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../VVGL/release/ -lVVGL
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../VVGL/debug/ -lVVGL
+else:unix: LIBS += -L$$OUT_PWD/../VVGL/ -lVVGL
+
+INCLUDEPATH += $$_PRO_FILE_PWD_/../../../VVGL/include
+INCLUDEPATH += $$_PRO_FILE_PWD_/../
+
+
+
+
+# make sure the rpath includes both ways of getting libs
+QMAKE_RPATHDIR = @executable_path/../Frameworks
+QMAKE_RPATHDIR += @loader_path/../Frameworks
+
+
+
+
+# additions for GLEW
+unix: LIBS += -L$$_PRO_FILE_PWD_/../../../external/GLEW/mac_x86_64/ -lGLEW
+win32: LIBS += -L$$_PRO_FILE_PWD_/../../../external/GLEW/win_x64/ -lglew32 -lopengl32
+INCLUDEPATH += $$_PRO_FILE_PWD_/../../../external/GLEW/include
+DEPENDPATH += $$_PRO_FILE_PWD_/../../../external/GLEW/include
+unix: PRE_TARGETDEPS += $$_PRO_FILE_PWD_/../../../external/GLEW/mac_x86_64/libGLEW.dylib
+win32: PRE_TARGETDEPS += $$_PRO_FILE_PWD_/../../../external/GLEW/win_x64/glew32.dll
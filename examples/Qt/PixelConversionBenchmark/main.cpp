@@ -0,0 +1,92 @@
+#include <QCoreApplication>
+#include <VVGL.hpp>
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <random>
+
+
+using namespace std;
+using namespace VVGL;
+
+
+
+
+//	runs 'inFunc' (which converts an image 'inBytes' bytes large) 'inCount' times and returns the avg throughput in GB/s
+double MeasureThroughput(const function<void()> & inFunc, const size_t & inBytes, const int & inCount)	{
+	//	run it once first so the caches/pages/worker threads are warm
+	inFunc();
+	Timestamp			startTime;
+	for (int i=0; i<inCount; ++i)
+		inFunc();
+	Timestamp			endTime;
+	double				seconds = (endTime - startTime).getTimeInSeconds();
+	if (seconds <= 0.)
+		return 0.;
+	return (double(inBytes) * double(inCount)) / seconds / (1024. * 1024. * 1024.);
+}
+
+
+struct ConversionCase	{
+	string			name;
+	PixelLayout		srcLayout;
+	PixelLayout		dstLayout;
+};
+
+
+int main(int argc, char *argv[])
+{
+	QCoreApplication		a(argc, argv);
+
+	const uint32_t		width = 3840;
+	const uint32_t		height = 2160;
+	const int			iterations = 20;
+
+	//	fill the source image with noise (the largest layout is 16 bytes per pixel)
+	vector<uint8_t>		src(size_t(width) * size_t(height) * 16);
+	vector<uint8_t>		dst(src.size());
+	mt19937				rng(1);
+	uniform_real_distribution<float>		dist(0.f, 1.f);
+	float				*srcFloats = reinterpret_cast<float*>(src.data());
+	for (size_t i=0; i<src.size()/sizeof(float); ++i)
+		srcFloats[i] = dist(rng);
+
+	const ConversionCase	cases[] = {
+		{ "RGBA8 -> RGBA8", PixelLayout_RGBA8, PixelLayout_RGBA8 },
+		{ "RGBA8 -> BGRA8", PixelLayout_RGBA8, PixelLayout_BGRA8 },
+		{ "RGBA8 -> RGBA32F", PixelLayout_RGBA8, PixelLayout_RGBA32F },
+		{ "RGBA8 -> BGRA32F", PixelLayout_RGBA8, PixelLayout_BGRA32F },
+		{ "RGBA32F -> RGBA8", PixelLayout_RGBA32F, PixelLayout_RGBA8 },
+		{ "BGRA32F -> RGBA8", PixelLayout_BGRA32F, PixelLayout_RGBA8 },
+		{ "RGBA32F -> BGRA32F", PixelLayout_RGBA32F, PixelLayout_BGRA32F },
+		{ "RGBA32F -> RGBA16F", PixelLayout_RGBA32F, PixelLayout_RGBA16F },
+		{ "UYVY -> RGBA8", PixelLayout_UYVY, PixelLayout_RGBA8 },
+		{ "UYVY -> BGRA8", PixelLayout_UYVY, PixelLayout_BGRA8 }
+	};
+
+	cout << "SIMD kernels are " << PixelConversionISA() << ", image is " << width << "x" << height << endl;
+	cout << "throughput is measured in GB/s of source + destination memory" << endl;
+	cout << "conversion\t\tscalar\t\tSIMD\t\tSIMD + threads" << endl;
+	for (const ConversionCase & c : cases)	{
+		size_t				srcBPR = BytesPerPixelForLayout(c.srcLayout) * width;
+		size_t				dstBPR = BytesPerPixelForLayout(c.dstLayout) * width;
+		size_t				totalBytes = (srcBPR + dstBPR) * height;
+		auto				convert = [&]()	{
+			ConvertPixels(src.data(), srcBPR, c.srcLayout, dst.data(), dstBPR, c.dstLayout, width, height);
+		};
+
+		SetPixelConversionThreadCount(1);
+		SetPixelConversionSIMDEnabled(false);
+		double				scalarGBps = MeasureThroughput(convert, totalBytes, iterations);
+		SetPixelConversionSIMDEnabled(true);
+		double				simdGBps = MeasureThroughput(convert, totalBytes, iterations);
+		SetPixelConversionThreadCount(8);
+		double				threadedGBps = MeasureThroughput(convert, totalBytes, iterations);
+
+		cout << c.name << "\t" << ((c.name.size() < 16) ? "\t" : "");
+		cout << FmtString("%0.2f", scalarGBps) << "\t\t" << FmtString("%0.2f", simdGBps) << "\t\t" << FmtString("%0.2f", threadedGBps) << endl;
+	}
+
+	return 0;
+}
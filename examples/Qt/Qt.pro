@@ -9,10 +9,16 @@ SUBDIRS += \
 	VVISFTestApp \
 	TexUploadBenchmark \
 	TexDownloadBenchmark \
+	BufferPoolBenchmark \
+	TexStorageBenchmark \
+	PixelConversionBenchmark \
     ISFEditor
 
 TexUploadBenchmark.depends += VVGL
 TexDownloadBenchmark.depends += VVISF
+BufferPoolBenchmark.depends += VVGL
+TexStorageBenchmark.depends += VVGL
+PixelConversionBenchmark.depends += VVGL
 VVGLTestApp.depends += VVGL
 VVISF.depends += VVGL
 VVISFTestApp.depends += VVISF
@@ -0,0 +1,114 @@
+#include <QGuiApplication>
+#include <VVGL.hpp>
+
+#include <iostream>
+#include <vector>
+#include <functional>
+
+
+using namespace std;
+using namespace VVGL;
+
+
+#if defined(Q_OS_WIN)
+extern "C"
+{
+	__declspec(dllexport) uint32_t NvOptimusEnablement = 0x00000001;
+	__declspec(dllexport) int AmdPowerXpressRequestHighPerformance = 1;
+}
+#endif
+
+
+
+
+//	the function used to create the textures being measured (mutable or immutable storage)
+using TexCreateFunc = function<GLBufferRef(const Size &)>;
+
+struct TexCosts	{
+	double		createMs = 0.;	//	avg time to create a texture (pool empty, so the texture is really created)
+	double		firstUseMs = 0.;	//	avg time to attach a new texture to an FBO and clear it for the first time
+};
+
+
+//	creates 'inCount' textures with 'inFunc', then attaches each to an FBO and clears it.  the pool is purged first and the textures are never returned to it, so every one of them is a new GL object.
+TexCosts MeasureTexCosts(const GLBufferPoolRef & inPool, const GLBufferRef & inFBO, const TexCreateFunc & inFunc, const Size & inSize, const int & inCount)	{
+	TexCosts			returnMe;
+	vector<GLBufferRef>		tmpBuffers;
+	tmpBuffers.reserve(inCount);
+
+	inPool->purge();
+	glFinish();
+
+	Timestamp			startTime;
+	for (int i=0; i<inCount; ++i)
+		tmpBuffers.push_back(inFunc(inSize));
+	glFinish();
+	Timestamp			createdTime;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, inFBO->name);
+	glViewport(0, 0, GLsizei(inSize.width), GLsizei(inSize.height));
+	glClearColor(0., 0., 0., 1.);
+	for (const auto & tmpBuffer : tmpBuffers)	{
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, tmpBuffer->desc.target, tmpBuffer->name, 0);
+		glClear(GL_COLOR_BUFFER_BIT);
+	}
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glFinish();
+	Timestamp			usedTime;
+
+	returnMe.createMs = (createdTime - startTime).getTimeInSeconds() * 1000. / double(inCount);
+	returnMe.firstUseMs = (usedTime - createdTime).getTimeInSeconds() * 1000. / double(inCount);
+
+	//	don't let the textures go back into the pool- the next run has to create its own
+	for (const auto & tmpBuffer : tmpBuffers)
+		tmpBuffer->preferDeletion = true;
+	tmpBuffers.clear();
+	inPool->housekeeping();
+
+	return returnMe;
+}
+
+
+int main(int argc, char *argv[])
+{
+	QGuiApplication		a(argc, argv);
+
+	//	make the shared context and the global buffer pool
+	GLContextRef		sharedContext = CreateNewGLContextRef(nullptr, nullptr, CreateDefaultSurfaceFormat());
+	if (sharedContext == nullptr)	{
+		cout << "ERR: shared context NULL" << endl;
+		return 1;
+	}
+	GLBufferPoolRef		bp = CreateGlobalBufferPool(sharedContext);
+
+	//	everything is created and used in the shared context
+	sharedContext->makeCurrentIfNotCurrent();
+	GLBufferRef			fbo = CreateFBO(true, bp);
+
+	const int			texCount = 64;
+	const Size			sizes[] = { Size(256,256), Size(1280,720), Size(1920,1080), Size(3840,2160) };
+	TexCreateFunc		mutableFunc = [&](const Size & inSize)	{ return CreateRGBATex(inSize, true, bp); };
+	TexCreateFunc		immutableFunc = [&](const Size & inSize)	{ return CreateRGBATexImmutable(inSize, true, bp); };
+
+	cout << "renderer is " << sharedContext->getRenderer() << endl;
+	cout << "size\t\tmutable create ms\timmutable create ms\tmutable first use ms\timmutable first use ms" << endl;
+	for (const Size & size : sizes)	{
+		//	run each once first so neither pays for any one-time driver setup
+		MeasureTexCosts(bp, fbo, mutableFunc, size, 4);
+		MeasureTexCosts(bp, fbo, immutableFunc, size, 4);
+
+		TexCosts			mutableCosts = MeasureTexCosts(bp, fbo, mutableFunc, size, texCount);
+		TexCosts			immutableCosts = MeasureTexCosts(bp, fbo, immutableFunc, size, texCount);
+		cout << size.width << "x" << size.height << "\t";
+		cout << FmtString("%0.3f", mutableCosts.createMs) << "\t\t\t" << FmtString("%0.3f", immutableCosts.createMs) << "\t\t\t";
+		cout << FmtString("%0.3f", mutableCosts.firstUseMs) << "\t\t\t" << FmtString("%0.3f", immutableCosts.firstUseMs) << endl;
+	}
+
+	fbo = nullptr;
+	bp->purge();
+	cout << bp->stats() << endl;
+	SetGlobalBufferPool();
+
+	return 0;
+}
@@ -32,6 +32,7 @@ private:
 	void prepForWork();
 	VVGL::GLBufferRef createTexForWork();
 	void workMethod();
+	void ringWorkMethod();
 	
 private slots:
 	Q_SLOT void widgetDrewItsFirstFrame();
@@ -59,14 +59,22 @@ INCLUDEPATH += $$_PRO_FILE_PWD_/../../../VVGL/include
 SOURCES += \
 	../../../VVGL/src/GLBuffer.cpp \
 	../../../VVGL/src/GLBufferPool.cpp \
+	../../../VVGL/src/GLBufferAllocator.cpp \
 	../../../VVGL/src/GLCachedProperty.cpp \
+	../../../VVGL/src/GLStateCache.cpp \
+	../../../VVGL/src/GLProgramBinaryCache.cpp \
+	../../../VVGL/src/GLProgramCache.cpp \
+	../../../VVGL/src/GLProgramReflection.cpp \
+	../../../VVGL/src/GLDebugLog.cpp \
 	../../../VVGL/src/GLContext.cpp \
 	../../../VVGL/src/GLCPUToTexCopier.cpp \
 	../../../VVGL/src/GLQtCtxWrapper.cpp \
 	../../../VVGL/src/GLScene.cpp \
 	../../../VVGL/src/GLTexToCPUCopier.cpp \
 	../../../VVGL/src/GLTexToTexCopier.cpp \
+	../../../VVGL/src/GLUploadService.cpp \
 	../../../VVGL/src/VVGL_Geom.cpp \
+	../../../VVGL/src/VVGL_PixelConversion.cpp \
 	../../../VVGL/src/VVGL_StringUtils.cpp
 
 HEADERS += \
@@ -78,17 +86,25 @@ HEADERS += \
 	../../../VVGL/include/GLBuffer.hpp \
 	../../../VVGL/include/GLBufferPool_CocoaAdditions.h \
 	../../../VVGL/include/GLBufferPool.hpp \
+	../../../VVGL/include/GLBufferAllocator.hpp \
 	../../../VVGL/include/GLCachedProperty.hpp \
+	../../../VVGL/include/GLStateCache.hpp \
+	../../../VVGL/include/GLProgramBinaryCache.hpp \
+	../../../VVGL/include/GLProgramCache.hpp \
+	../../../VVGL/include/GLProgramReflection.hpp \
+	../../../VVGL/include/GLDebugLog.hpp \
 	../../../VVGL/include/GLContext.hpp \
 	../../../VVGL/include/GLCPUToTexCopier.hpp \
 	../../../VVGL/include/GLQtCtxWrapper.hpp \
 	../../../VVGL/include/GLScene.hpp \
 	../../../VVGL/include/GLTexToCPUCopier.hpp \
 	../../../VVGL/include/GLTexToTexCopier.hpp \
+	../../../VVGL/include/GLUploadService.hpp \
 	../../../VVGL/include/VVGL_Base.hpp \
 	../../../VVGL/include/VVGL_Defines.hpp \
 	../../../VVGL/include/VVGL_Doxygen.hpp \
 	../../../VVGL/include/VVGL_Geom.hpp \
+	../../../VVGL/include/VVGL_PixelConversion.hpp \
 	../../../VVGL/include/VVGL_HardCodedDefines.hpp \
 	../../../VVGL/include/VVGL_Qt_global.h \
 	../../../VVGL/include/VVGL_Range.hpp \